@@ -0,0 +1,156 @@
+/**
+ * MaNGOS is a full featured server for World of Warcraft, supporting
+ * the following clients: 1.12.x, 2.4.3, 3.3.5a, 4.3.4a and 5.4.8
+ *
+ * Copyright (C) 2005-2014  MaNGOS project <http://getmangos.eu>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * World of Warcraft, and all World of Warcraft or Warcraft art, images,
+ * and lore are copyrighted by Blizzard Entertainment, Inc.
+ */
+
+/**
+ * Visits crowded grid cells the way the object notifiers do, once through the
+ * GridReference linked list and once through the GridRefManager iterator.
+ *
+ * Usage: grid_benchmark [cells] [objects per cell] [rounds]
+ */
+
+#include "Common.h"
+#include "GameSystem/GridRefManager.h"
+
+#include <ace/High_Res_Timer.h>
+
+#include <vector>
+
+namespace
+{
+    /**
+     * @brief stand-in for a world object: heap allocated, about the size of
+     *        the part of a Creature in front of its position
+     *
+     */
+    struct BenchObject
+    {
+        BenchObject() : x(0.0f), y(0.0f) {}
+
+        GridReference<BenchObject>& GetGridRef() { return ref; }
+
+        char payload[600];                                  /**< TODO */
+        float x;                                            /**< TODO */
+        float y;                                            /**< TODO */
+        GridReference<BenchObject> ref;                     /**< TODO */
+    };
+
+    typedef GridRefManager<BenchObject> BenchCell;
+    typedef std::vector<BenchCell*> BenchCells;
+
+    /**
+     * @brief the part of a notifier every object goes through: a distance check
+     *
+     */
+    inline void VisitObject(BenchObject const* obj, double& sum)
+    {
+        float dx = obj->x - 100.0f;
+        float dy = obj->y - 100.0f;
+        if (dx * dx + dy * dy < 1.0e12f)
+            { sum += obj->x; }
+    }
+
+    double ElapsedNs(ACE_High_Res_Timer& timer)
+    {
+        ACE_hrtime_t nsec;
+        timer.elapsed_time(nsec);
+        return double(nsec);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    int cellCount = argc > 1 ? atoi(argv[1]) : 64;
+    int perCell = argc > 2 ? atoi(argv[2]) : 400;
+    int rounds = argc > 3 ? atoi(argv[3]) : 200;
+
+    if (cellCount <= 0 || perCell <= 0 || rounds <= 0)
+    {
+        printf("Usage: %s [cells] [objects per cell] [rounds]\n", argv[0]);
+        return 1;
+    }
+
+    BenchCells cells;
+    for (int i = 0; i < cellCount; ++i)
+        { cells.push_back(new BenchCell()); }
+
+    // allocate in one order and link in another, objects of a cell end up scattered over the heap
+    std::vector<BenchObject*> objects;
+    int total = cellCount * perCell;
+    for (int i = 0; i < total; ++i)
+    {
+        objects.push_back(new BenchObject());
+        objects.back()->x = float(i % 1000);
+        objects.back()->y = float(i / 1000);
+    }
+
+    std::random_shuffle(objects.begin(), objects.end());
+    for (int i = 0; i < total; ++i)
+        { objects[i]->ref.link(cells[i % cellCount], objects[i]); }
+
+    // relocate half of the objects between cells, like creatures walking around
+    for (int i = 0; i < total / 2; ++i)
+    {
+        BenchObject* obj = objects[(i * 7919) % total];
+        obj->ref.link(cells[(i * 31) % cellCount], obj);
+    }
+
+    double sum = 0.0;
+    ACE_High_Res_Timer listTimer;
+    ACE_High_Res_Timer iterTimer;
+
+    listTimer.start();
+    for (int r = 0; r < rounds; ++r)
+    {
+        for (BenchCells::const_iterator cell = cells.begin(); cell != cells.end(); ++cell)
+        {
+            for (GridReference<BenchObject>* ref = (*cell)->getFirst(); ref; ref = ref->next())
+                { VisitObject(ref->getSource(), sum); }
+        }
+    }
+    listTimer.stop();
+
+    iterTimer.start();
+    for (int r = 0; r < rounds; ++r)
+    {
+        for (BenchCells::const_iterator cell = cells.begin(); cell != cells.end(); ++cell)
+        {
+            for (BenchCell::iterator itr = (*cell)->begin(); itr != (*cell)->end(); ++itr)
+                { VisitObject(itr->getSource(), sum); }
+        }
+    }
+    iterTimer.stop();
+
+    double visits = double(rounds) * double(total);
+    printf("%d cells, %d objects per cell, %d rounds\n", cellCount, perCell, rounds);
+    printf("linked list    %.2f ns/object\n", ElapsedNs(listTimer) / visits);
+    printf("cell iterator  %.2f ns/object\n", ElapsedNs(iterTimer) / visits);
+    printf("(checksum %g)\n", sum);
+
+    for (std::vector<BenchObject*>::const_iterator itr = objects.begin(); itr != objects.end(); ++itr)
+        { delete *itr; }
+    for (BenchCells::const_iterator cell = cells.begin(); cell != cells.end(); ++cell)
+        { delete *cell; }
+
+    return 0;
+}
@@ -0,0 +1,164 @@
+/**
+ * MaNGOS is a full featured server for World of Warcraft, supporting
+ * the following clients: 1.12.x, 2.4.3, 3.3.5a, 4.3.4a and 5.4.8
+ *
+ * Copyright (C) 2005-2014  MaNGOS project <http://getmangos.eu>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * World of Warcraft, and all World of Warcraft or Warcraft art, images,
+ * and lore are copyrighted by Blizzard Entertainment, Inc.
+ */
+
+/**
+ * Looks up the spell chain, bonus and proc event data of random spell ids the
+ * way a cast and the procs it triggers do, once through the spell id keyed
+ * maps the loaders fill and once through the SpellIdIndex views that
+ * SpellMgr::GetSpellChainNode, GetSpellBonusData and GetSpellProcEvent read.
+ *
+ * Usage: spell_benchmark [spells with data] [highest spell id] [casts]
+ */
+
+#include "Common.h"
+#include "SpellMgr.h"
+
+#include <ace/High_Res_Timer.h>
+
+#include <vector>
+
+namespace
+{
+    /**
+     * @brief the lookups of one cast, through the maps
+     *
+     */
+    inline void CastThroughMaps(SpellChainMap const& chains, SpellBonusMap const& bonuses, SpellProcEventMap const& procs, uint32 spellId, double& sum)
+    {
+        SpellChainMap::const_iterator chain = chains.find(spellId);
+        if (chain != chains.end())
+            { sum += chain->second.rank; }
+
+        SpellBonusMap::const_iterator bonus = bonuses.find(spellId);
+        if (bonus != bonuses.end())
+            { sum += bonus->second.direct_damage; }
+
+        SpellProcEventMap::const_iterator proc = procs.find(spellId);
+        if (proc != procs.end())
+            { sum += proc->second.procFlags; }
+    }
+
+    /**
+     * @brief the lookups of one cast, through the indexes
+     *
+     */
+    inline void CastThroughIndexes(SpellIdIndex<SpellChainNode> const& chains, SpellIdIndex<SpellBonusEntry> const& bonuses, SpellIdIndex<SpellProcEventEntry> const& procs, uint32 spellId, double& sum)
+    {
+        if (SpellChainNode const* chain = chains.Find(spellId))
+            { sum += chain->rank; }
+
+        if (SpellBonusEntry const* bonus = bonuses.Find(spellId))
+            { sum += bonus->direct_damage; }
+
+        if (SpellProcEventEntry const* proc = procs.Find(spellId))
+            { sum += proc->procFlags; }
+    }
+
+    double ElapsedNs(ACE_High_Res_Timer& timer)
+    {
+        ACE_hrtime_t nsec;
+        timer.elapsed_time(nsec);
+        return double(nsec);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    int spellCount = argc > 1 ? atoi(argv[1]) : 6000;
+    int maxSpellId = argc > 2 ? atoi(argv[2]) : 30000;
+    int casts = argc > 3 ? atoi(argv[3]) : 10000000;
+
+    if (spellCount <= 0 || maxSpellId <= spellCount || casts <= 0)
+    {
+        printf("Usage: %s [spells with data] [highest spell id] [casts]\n", argv[0]);
+        return 1;
+    }
+
+    // spell ids with data are spread over the whole id range, like in Spell.dbc
+    std::vector<uint32> ids;
+    for (int i = 1; i <= maxSpellId; ++i)
+        { ids.push_back(uint32(i)); }
+    std::random_shuffle(ids.begin(), ids.end());
+    ids.resize(spellCount);
+
+    SpellChainMap chains;
+    SpellBonusMap bonuses;
+    SpellProcEventMap procs;
+
+    // ranks of a chain are consecutive entries, every spell has chain data,
+    // every second one bonus data and every third one a proc event
+    for (int i = 0; i < spellCount; ++i)
+    {
+        SpellChainNode& node = chains[ids[i]];
+        node.rank = uint8(i % 5 + 1);
+        node.prev = node.rank > 1 ? ids[i - 1] : 0;
+        node.first = ids[i - (node.rank - 1)];
+        node.req = 0;
+
+        if (i % 2 == 0)
+        {
+            SpellBonusEntry& bonus = bonuses[ids[i]];
+            bonus.direct_damage = 0.5f;
+            bonus.dot_damage = 0.0f;
+            bonus.ap_bonus = 0.0f;
+            bonus.ap_dot_bonus = 0.0f;
+        }
+
+        if (i % 3 == 0)
+            { procs[ids[i]].procFlags = uint32(i); }
+    }
+
+    SpellIdIndex<SpellChainNode> chainIndex;
+    SpellIdIndex<SpellBonusEntry> bonusIndex;
+    SpellIdIndex<SpellProcEventEntry> procIndex;
+    chainIndex.Build(chains, uint32(maxSpellId) + 1);
+    bonusIndex.Build(bonuses, uint32(maxSpellId) + 1);
+    procIndex.Build(procs, uint32(maxSpellId) + 1);
+
+    // casts pick any spell id, most of them without extra data
+    std::vector<uint32> probes;
+    for (int i = 0; i < 65536; ++i)
+        { probes.push_back(uint32(rand() % maxSpellId + 1)); }
+
+    double sum = 0.0;
+    ACE_High_Res_Timer mapTimer;
+    ACE_High_Res_Timer indexTimer;
+
+    mapTimer.start();
+    for (int i = 0; i < casts; ++i)
+        { CastThroughMaps(chains, bonuses, procs, probes[i & 0xFFFF], sum); }
+    mapTimer.stop();
+
+    indexTimer.start();
+    for (int i = 0; i < casts; ++i)
+        { CastThroughIndexes(chainIndex, bonusIndex, procIndex, probes[i & 0xFFFF], sum); }
+    indexTimer.stop();
+
+    printf("%d spells with data, spell ids up to %d, %d casts\n", spellCount, maxSpellId, casts);
+    printf("spell id maps     %.2f ns/cast\n", ElapsedNs(mapTimer) / casts);
+    printf("spell id indexes  %.2f ns/cast\n", ElapsedNs(indexTimer) / casts);
+    printf("(checksum %g)\n", sum);
+
+    return 0;
+}
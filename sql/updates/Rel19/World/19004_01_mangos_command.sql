@@ -0,0 +1,5 @@
+ALTER TABLE db_version CHANGE COLUMN required_19003_02_mangos_command required_19004_01_mangos_command BIT;
+
+DELETE FROM command WHERE name = 'server netstats';
+INSERT INTO command (name, security, help) VALUES
+('server netstats',3,'Syntax: .server netstats\r\n\r\nShow connections, accepted sockets, packets and kilobytes in and out of every network thread, and the packet buffer pool counters.');
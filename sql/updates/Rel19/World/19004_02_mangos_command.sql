@@ -0,0 +1,5 @@
+ALTER TABLE db_version CHANGE COLUMN required_19004_01_mangos_command required_19004_02_mangos_command BIT;
+
+DELETE FROM command WHERE name = 'server querycache';
+INSERT INTO command (name, security, help) VALUES
+('server querycache',3,'Syntax: .server querycache\r\n\r\nShow hits, misses, stored responses and their size for every kind of cached query response (creature, gameobject, item, quest, npc text).');
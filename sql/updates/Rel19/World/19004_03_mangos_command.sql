@@ -0,0 +1,5 @@
+ALTER TABLE db_version CHANGE COLUMN required_19004_02_mangos_command required_19004_03_mangos_command BIT;
+
+DELETE FROM command WHERE name = 'server opcodestats';
+INSERT INTO command (name, security, help) VALUES
+('server opcodestats',3,'Syntax: .server opcodestats [#count|reset]\r\n\r\nShow the #count (default 10) client opcodes with the most total handler time: calls, total, average and maximum handler time and received kilobytes. With reset the counters are cleared.');
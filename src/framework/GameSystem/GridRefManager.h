@@ -26,13 +26,20 @@
 #define _GRIDREFMANAGER
 
 #include "Utilities/LinkedReference/RefManager.h"
+#include "GameSystem/GridReference.h"
 
-template<class OBJECT> class GridReference;
+#include <vector>
 
 template<class OBJECT>
 /**
- * @brief
+ * @brief List of the objects of one type in a grid cell
  *
+ * Besides the intrusive linked list, which owns the references and keeps the
+ * size, the references are stored in a dense array that is used for iteration.
+ * Removal while an iterator is alive only clears the slot, holes are compacted
+ * when the last iterator is destroyed. Objects added while iterating are not
+ * visited by the running iterations, like with the linked list where new
+ * references are inserted first.
  */
 class GridRefManager : public RefManager<GridRefManager<OBJECT>, OBJECT>
 {
@@ -42,7 +49,159 @@ class GridRefManager : public RefManager<GridRefManager<OBJECT>, OBJECT>
          * @brief
          *
          */
-        typedef LinkedListHead::Iterator< GridReference<OBJECT> > iterator;
+        typedef std::vector<GridReference<OBJECT>*> SlotList;
+
+        /**
+         * @brief Forward iterator over the dense reference array
+         *
+         */
+        class iterator
+        {
+            public:
+
+                /**
+                 * @brief Constructs the end iterator
+                 *
+                 */
+                iterator() : i_manager(NULL), i_index(0), i_limit(0) {}
+                /**
+                 * @brief
+                 *
+                 * @param manager
+                 */
+                explicit iterator(GridRefManager* manager) : i_manager(manager), i_index(0), i_limit(manager->i_slots.size())
+                {
+                    i_manager->AttachIterator();
+                    SkipEmptySlots();
+                }
+                /**
+                 * @brief
+                 *
+                 * @param right
+                 */
+                iterator(iterator const& right) : i_manager(right.i_manager), i_index(right.i_index), i_limit(right.i_limit)
+                {
+                    if (i_manager)
+                        { i_manager->AttachIterator(); }
+                }
+                /**
+                 * @brief
+                 *
+                 */
+                ~iterator()
+                {
+                    if (i_manager)
+                        { i_manager->DetachIterator(); }
+                }
+
+                /**
+                 * @brief
+                 *
+                 * @param right
+                 * @return iterator
+                 */
+                iterator& operator=(iterator const& right)
+                {
+                    if (right.i_manager)
+                        { right.i_manager->AttachIterator(); }
+                    if (i_manager)
+                        { i_manager->DetachIterator(); }
+                    i_manager = right.i_manager;
+                    i_index = right.i_index;
+                    i_limit = right.i_limit;
+                    return *this;
+                }
+
+                /**
+                 * @brief
+                 *
+                 * @return iterator
+                 */
+                iterator& operator++()
+                {
+                    ++i_index;
+                    SkipEmptySlots();
+                    return *this;
+                }
+                /**
+                 * @brief
+                 *
+                 * @param int
+                 * @return iterator
+                 */
+                iterator operator++(int)
+                {
+                    iterator tmp(*this);
+                    ++*this;
+                    return tmp;
+                }
+
+                /**
+                 * @brief
+                 *
+                 * @return GridReference<OBJECT>
+                 */
+                GridReference<OBJECT>& operator*() const { return *i_manager->i_slots[i_index]; }
+                /**
+                 * @brief
+                 *
+                 * @return GridReference<OBJECT>
+                 */
+                GridReference<OBJECT>* operator->() const { return i_manager->i_slots[i_index]; }
+
+                /**
+                 * @brief All end iterators compare equal
+                 *
+                 * @param right
+                 * @return bool
+                 */
+                bool operator==(iterator const& right) const
+                {
+                    if (IsEnd() || right.IsEnd())
+                        { return IsEnd() && right.IsEnd(); }
+                    return i_manager == right.i_manager && i_index == right.i_index;
+                }
+                /**
+                 * @brief
+                 *
+                 * @param right
+                 * @return bool
+                 */
+                bool operator!=(iterator const& right) const { return !(*this == right); }
+
+            private:
+
+                /**
+                 * @brief
+                 *
+                 * @return bool
+                 */
+                bool IsEnd() const { return i_index >= i_limit; }
+                /**
+                 * @brief
+                 *
+                 */
+                void SkipEmptySlots()
+                {
+                    while (i_index < i_limit && !i_manager->i_slots[i_index])
+                        { ++i_index; }
+                }
+
+                GridRefManager* i_manager; /**< TODO */
+                size_t i_index; /**< TODO */
+                size_t i_limit; /**< slots count at iteration start */
+        };
+
+        /**
+         * @brief
+         *
+         */
+        GridRefManager() : i_iterators(0), i_holes(0) {}
+        /**
+         * @brief References must be invalidated while the slots still exist
+         *
+         */
+        ~GridRefManager() { this->clearReferences(); }
 
         /**
          * @brief
@@ -69,24 +228,84 @@ class GridRefManager : public RefManager<GridRefManager<OBJECT>, OBJECT>
          *
          * @return iterator
          */
-        iterator begin() { return iterator(getFirst()); }
+        iterator begin() { return iterator(this); }
         /**
          * @brief
          *
          * @return iterator
          */
-        iterator end() { return iterator(NULL); }
+        iterator end() { return iterator(); }
+
+        /**
+         * @brief Called by GridReference at link
+         *
+         * @param ref
+         */
+        void AddSlot(GridReference<OBJECT>* ref)
+        {
+            ref->i_slot = i_slots.size();
+            i_slots.push_back(ref);
+        }
+
+        /**
+         * @brief Called by GridReference at unlink
+         *
+         * @param ref
+         */
+        void RemoveSlot(GridReference<OBJECT>* ref)
+        {
+            // keep positions stable for alive iterators
+            if (i_iterators)
+            {
+                i_slots[ref->i_slot] = NULL;
+                ++i_holes;
+                return;
+            }
+
+            GridReference<OBJECT>* last = i_slots.back();
+            i_slots[ref->i_slot] = last;
+            last->i_slot = ref->i_slot;
+            i_slots.pop_back();
+        }
+
+    private:
+
         /**
          * @brief
          *
-         * @return iterator
          */
-        iterator rbegin() { return iterator(getLast()); }
+        void AttachIterator() { ++i_iterators; }
         /**
          * @brief
          *
-         * @return iterator
          */
-        iterator rend() { return iterator(NULL); }
+        void DetachIterator()
+        {
+            if (--i_iterators == 0 && i_holes)
+                { Compact(); }
+        }
+
+        /**
+         * @brief Remove holes left by removal while iterating, keeping order
+         *
+         */
+        void Compact()
+        {
+            size_t count = 0;
+            for (size_t i = 0; i < i_slots.size(); ++i)
+            {
+                if (GridReference<OBJECT>* ref = i_slots[i])
+                {
+                    ref->i_slot = count;
+                    i_slots[count++] = ref;
+                }
+            }
+            i_slots.resize(count);
+            i_holes = 0;
+        }
+
+        SlotList i_slots; /**< TODO */
+        uint32 i_iterators; /**< alive iterators count */
+        uint32 i_holes; /**< cleared slots waiting for compaction */
 };
 #endif
@@ -47,6 +47,7 @@ class MANGOS_DLL_SPEC GridReference : public Reference<GridRefManager<OBJECT>, O
             // called from link()
             this->getTarget()->insertFirst(this);
             this->getTarget()->incSize();
+            this->getTarget()->AddSlot(this);
         }
 
         /**
@@ -57,7 +58,10 @@ class MANGOS_DLL_SPEC GridReference : public Reference<GridRefManager<OBJECT>, O
         {
             // called from unlink()
             if (this->isValid())
-                { this->getTarget()->decSize(); }
+            {
+                this->getTarget()->decSize();
+                this->getTarget()->RemoveSlot(this);
+            }
         }
 
         /**
@@ -68,6 +72,7 @@ class MANGOS_DLL_SPEC GridReference : public Reference<GridRefManager<OBJECT>, O
         {
             // called from invalidate()
             this->getTarget()->decSize();
+            this->getTarget()->RemoveSlot(this);
         }
 
     public:
@@ -76,7 +81,7 @@ class MANGOS_DLL_SPEC GridReference : public Reference<GridRefManager<OBJECT>, O
          *
          */
         GridReference()
-            : Reference<GridRefManager<OBJECT>, OBJECT>()
+            : Reference<GridRefManager<OBJECT>, OBJECT>(), i_slot(0)
         {
         }
 
@@ -98,6 +103,12 @@ class MANGOS_DLL_SPEC GridReference : public Reference<GridRefManager<OBJECT>, O
         {
             return (GridReference*)Reference<GridRefManager<OBJECT>, OBJECT>::next();
         }
+
+    private:
+
+        friend class GridRefManager<OBJECT>;
+
+        size_t i_slot; /**< position in the dense array of the target GridRefManager */
 };
 
 #endif
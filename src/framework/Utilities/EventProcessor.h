@@ -137,6 +137,12 @@ class EventProcessor
          * @return uint64
          */
         uint64 CalculateTime(uint64 t_offset);
+        /**
+         * @brief
+         *
+         * @return bool true when no event is scheduled
+         */
+        bool Empty() const { return m_events.empty(); }
 
     protected:
 
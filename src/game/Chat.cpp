@@ -636,7 +636,10 @@ ChatCommand* ChatHandler::getCommandTable()
         { "info",           SEC_PLAYER,         true,  &ChatHandler::HandleServerInfoCommand,          "", NULL },
         { "log",            SEC_CONSOLE,        true,  NULL,                                           "", serverLogCommandTable },
         { "motd",           SEC_PLAYER,         true,  &ChatHandler::HandleServerMotdCommand,          "", NULL },
+        { "netstats",       SEC_ADMINISTRATOR,  true,  &ChatHandler::HandleServerNetStatsCommand,      "", NULL },
+        { "opcodestats",    SEC_ADMINISTRATOR,  true,  &ChatHandler::HandleServerOpcodeStatsCommand,   "", NULL },
         { "plimit",         SEC_ADMINISTRATOR,  true,  &ChatHandler::HandleServerPLimitCommand,        "", NULL },
+        { "querycache",     SEC_ADMINISTRATOR,  true,  &ChatHandler::HandleServerQueryCacheCommand,    "", NULL },
         { "restart",        SEC_ADMINISTRATOR,  true,  NULL,                                           "", serverRestartCommandTable },
         { "shutdown",       SEC_ADMINISTRATOR,  true,  NULL,                                           "", serverShutdownCommandTable },
         { "set",            SEC_ADMINISTRATOR,  true,  NULL,                                           "", serverSetCommandTable },
@@ -492,7 +492,10 @@ class MANGOS_DLL_SPEC ChatHandler
         bool HandleServerLogFilterCommand(char* args);
         bool HandleServerLogLevelCommand(char* args);
         bool HandleServerMotdCommand(char* args);
+        bool HandleServerNetStatsCommand(char* args);
+        bool HandleServerOpcodeStatsCommand(char* args);
         bool HandleServerPLimitCommand(char* args);
+        bool HandleServerQueryCacheCommand(char* args);
         bool HandleServerRestartCommand(char* args);
         bool HandleServerSetMotdCommand(char* args);
         bool HandleServerShutDownCommand(char* args);
@@ -54,6 +54,7 @@
 #include "GridNotifiersImpl.h"
 #include "CellImpl.h"
 #include "movement/MoveSplineInit.h"
+#include "movement/MoveSpline.h"
 #include "CreatureLinkingMgr.h"
 #include "LuaEngine.h"
 
@@ -143,7 +144,8 @@ Creature::Creature(CreatureSubtype subtype) : Unit(),
     lootForPickPocketed(false), lootForBody(false), lootForSkin(false),
     m_groupLootTimer(0), m_groupLootId(0),
     m_lootMoney(0), m_lootGroupRecipientId(0),
-    m_corpseDecayTimer(0), m_respawnTime(0), m_respawnDelay(25), m_corpseDelay(60), m_aggroDelay(0), m_respawnradius(5.0f),
+    m_corpseDecayTimer(0), m_respawnTime(0), m_respawnDelay(25), m_corpseDelay(60), m_aggroDelay(0),
+    m_idleUpdateTimer(0), m_idleSkippedTime(0), m_isIdle(false), m_respawnradius(5.0f),
     m_subtype(subtype), m_defaultMovementType(IDLE_MOTION_TYPE), m_equipmentId(0),
     m_AlreadyCallAssistance(false), m_AlreadySearchedAssistance(false),
     m_regenHealth(true), m_AI_locked(false), m_IsDeadByDefault(false),
@@ -562,7 +564,7 @@ void Creature::Update(uint32 update_diff, uint32 diff)
                 {
                     // do not allow the AI to be changed during update
                     m_AI_locked = true;
-                    AI()->UpdateAI(diff);   // AI not react good at real update delays (while freeze in non-active part of map)
+                    AI()->UpdateAI(diff);   // AI not react good at real update delays (while freeze in non-active part of map), only AIs that CanSleep() get the skipped idle time
                     m_AI_locked = false;
                 }
             }
@@ -579,6 +581,116 @@ void Creature::Update(uint32 update_diff, uint32 diff)
     }
 }
 
+bool Creature::IsIdle() const
+{
+    if (!CanStayIdle())
+        { return false; }
+
+    if (m_deathState == DEAD)
+        { return true; }
+
+    if (i_AI && !i_AI->CanSleep())
+        { return false; }
+
+    for (SpellAuraHolderMap::const_iterator itr = m_spellAuraHolders.begin(); itr != m_spellAuraHolders.end(); ++itr)
+    {
+        SpellAuraHolder* holder = itr->second;
+        if (!holder->IsPermanent() || holder->IsAreaAura())
+            { return false; }
+
+        // periodic ticks with an amplitude below the idle interval would be lost
+        for (int32 i = 0; i < MAX_EFFECT_INDEX; ++i)
+        {
+            Aura* aura = holder->GetAuraByEffectIndex(SpellEffectIndex(i));
+            if (aura && aura->IsPeriodic())
+                { return false; }
+        }
+    }
+
+    return true;
+}
+
+/**
+ * The part of IsIdle() that is cheap enough to run every tick. Auras and the AI are only
+ * checked before a creature goes idle; new auras, damage, threat, movement, relocation,
+ * AI events and db script commands wake it up through WakeUp().
+ */
+bool Creature::CanStayIdle() const
+{
+    if (IsPet() || IsTotem() || IsTemporarySummon() || isActiveObject() || GetCharmerOrOwnerGuid())
+        { return false; }
+
+    switch (m_deathState)
+    {
+        case DEAD:
+            // only waits for respawn time
+            return true;
+        case ALIVE:
+            break;
+        default:
+            return false;
+    }
+
+    if (m_IsDeadByDefault || m_aggroDelay || IsInCombat() || IsInEvadeMode())
+        { return false; }
+
+    if (!movespline->Finalized() || i_motionMaster.GetCurrentMovementGeneratorType() != IDLE_MOTION_TYPE)
+        { return false; }
+
+    if (!m_Events.Empty() || IsNonMeleeSpellCasted(true))
+        { return false; }
+
+    // regeneration in progress
+    if (GetHealth() < GetMaxHealth() || GetPower(POWER_MANA) < GetMaxPower(POWER_MANA))
+        { return false; }
+
+    return true;
+}
+
+/**
+ * Called by the grid updater before each update. This is a reduced rate fallback, not a sleep
+ * list: every creature of an active cell is still visited each tick, idle ones only pay for the
+ * checks of CanStayIdle(), and WakeUp() returns them to the per tick update at once. Idle ones
+ * are updated once per CONFIG_UINT32_CREATURE_IDLE_UPDATE_INTERVAL,
+ * the update timer catches up on the elapsed time by itself, the AI gets the skipped tick time in
+ * aiDiff (it has no out of combat timers, see CreatureAI::CanSleep()). Awake creatures retry
+ * going idle once per interval, so the full IsIdle() check is not run every tick either.
+ */
+bool Creature::SkipIdleUpdate(uint32 tickDiff, uint32& aiDiff)
+{
+    uint32 interval = sWorld.getConfig(CONFIG_UINT32_CREATURE_IDLE_UPDATE_INTERVAL);
+    if (!interval)
+        { m_isIdle = false; }
+    else if (m_isIdle && CanStayIdle())
+    {
+        if (m_idleUpdateTimer > tickDiff)
+        {
+            m_idleUpdateTimer -= tickDiff;
+            m_idleSkippedTime += tickDiff;
+            return true;
+        }
+        m_idleUpdateTimer = interval;
+    }
+    else if (m_isIdle)
+    {
+        // woken up, stays awake for at least one interval
+        m_isIdle = false;
+        m_idleUpdateTimer = interval;
+    }
+    else if (m_idleUpdateTimer > tickDiff)
+        { m_idleUpdateTimer -= tickDiff; }
+    else
+    {
+        // updated this tick anyway, skipped from the next one on
+        m_isIdle = IsIdle();
+        m_idleUpdateTimer = interval;
+    }
+
+    aiDiff = tickDiff + m_idleSkippedTime;
+    m_idleSkippedTime = 0;
+    return false;
+}
+
 void Creature::StartGroupLoot(Group* group, uint32 timer)
 {
     m_groupLootId = group->GetId();
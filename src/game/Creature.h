@@ -506,6 +506,11 @@ class MANGOS_DLL_SPEC Creature : public Unit
 
         void Update(uint32 update_diff, uint32 time) override;  // overwrite Unit::Update
 
+        bool IsIdle() const;                                // nothing to do at update except waiting
+        bool CanStayIdle() const;                           // IsIdle() without the aura and AI checks
+        bool SkipIdleUpdate(uint32 tickDiff, uint32& aiDiff);
+        void WakeUp() { m_isIdle = false; }                 // state change the idle checks do not see, update at next tick
+
         virtual void RegenerateAll(uint32 update_diff);
         uint32 GetEquipmentId() const { return m_equipmentId; }
 
@@ -765,6 +770,9 @@ class MANGOS_DLL_SPEC Creature : public Unit
         uint32 m_respawnDelay;                              // (secs) delay between corpse disappearance and respawning
         uint32 m_corpseDelay;                               // (secs) delay between death and corpse disappearance
         uint32 m_aggroDelay;                                // (msecs)delay between respawn and aggro due to movement
+        uint32 m_idleUpdateTimer;                           // (msecs)time left until next update while idle
+        uint32 m_idleSkippedTime;                           // (msecs)tick time skipped while idle, given to AI at next update
+        bool m_isIdle;                                      // updated at the idle interval only
         float m_respawnradius;
 
         CreatureSubtype m_subtype;                          // set in Creatures subclasses for fast it detect without dynamic_cast use
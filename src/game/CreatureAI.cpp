@@ -192,6 +192,7 @@ class AiDelayEventAround : public BasicEvent
             {
                 if (Creature* pReceiver = m_owner.GetMap()->GetAnyTypeCreature(*itr))
                 {
+                    pReceiver->WakeUp();
                     pReceiver->AI()->ReceiveAIEvent(m_eventType, &m_owner, pInvoker, m_miscValue);
                     // Special case for type 0 (call-assistance)
                     if (m_eventType == AI_EVENT_CALL_ASSISTANCE && pInvoker && pReceiver->CanAssistTo(&m_owner, pInvoker))
@@ -239,5 +240,6 @@ void CreatureAI::SendAIEventAround(AIEventType eventType, Unit* pInvoker, uint32
 void CreatureAI::SendAIEvent(AIEventType eventType, Unit* pInvoker, Creature* pReceiver, uint32 miscValue /*=0*/) const
 {
     MANGOS_ASSERT(pReceiver);
+    pReceiver->WakeUp();
     pReceiver->AI()->ReceiveAIEvent(eventType, m_creature, pInvoker, miscValue);
 }
@@ -290,6 +290,12 @@ class MANGOS_DLL_SPEC CreatureAI
          */
         virtual bool IsVisible(Unit* /*pWho*/) const { return false; }
 
+        /**
+         * Check if the creature may be updated at the reduced idle interval while out of combat
+         * Note: AIs with out of combat timers must return false, they would fire at most once per interval
+         */
+        virtual bool CanSleep() const { return true; }
+
         // Called when victim entered water and creature can not enter water
         // TODO: rather unused
         virtual bool canReachByRangeAttack(Unit*) { return false; }
@@ -85,6 +85,7 @@ CreatureEventAI::CreatureEventAI(Creature* c) : CreatureAI(c),
     m_Phase(0),
     m_MeleeEnabled(true),
     m_InvinceabilityHpLevel(0),
+    m_hasOutOfCombatTimers(false),
     m_throwAIEventMask(0),
     m_throwAIEventStep(0)
 {
@@ -117,6 +118,9 @@ CreatureEventAI::CreatureEventAI(Creature* c) : CreatureAI(c),
                     { continue; }
 #endif
                 m_CreatureEventAIList.push_back(CreatureEventAIHolder(*i));
+
+                if ((*i).event_type == EVENT_T_TIMER_OOC || (*i).event_type == EVENT_T_TIMER_GENERIC)
+                    { m_hasOutOfCombatTimers = true; }
             }
         }
     }
@@ -643,6 +643,7 @@ class MANGOS_DLL_SPEC CreatureEventAI : public CreatureAI
         void HealedBy(Unit* healer, uint32& healedAmount) override;
         void UpdateAI(const uint32 diff) override;
         bool IsVisible(Unit*) const override;
+        bool CanSleep() const override { return !m_hasOutOfCombatTimers; }
         void ReceiveEmote(Player* pPlayer, uint32 text_emote) override;
         void SummonedCreatureJustDied(Creature* unit) override;
         void SummonedCreatureDespawn(Creature* unit) override;
@@ -674,6 +675,7 @@ class MANGOS_DLL_SPEC CreatureEventAI : public CreatureAI
         uint8  m_Phase;                                     // Current phase, max 32 phases
         bool   m_MeleeEnabled;                              // If we allow melee auto attack
         uint32 m_InvinceabilityHpLevel;                     // Minimal health level allowed at damage apply
+        bool   m_hasOutOfCombatTimers;                      // Has EVENT_T_TIMER_OOC or EVENT_T_TIMER_GENERIC events
 
         uint32 m_throwAIEventMask;                          // Automatically throw AIEvents that are encoded into this mask
         // Note that Step 100 means that AI_EVENT_GOT_FULL_HEALTH was sent
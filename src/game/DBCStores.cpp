@@ -193,6 +193,10 @@ inline void LoadDBC(uint32& availableDbcLocales, BarGoLink& bar, StoreProblemLis
             if (!storage.LoadStringsFrom(dbc_filename_loc.c_str()))
                 { availableDbcLocales &= ~(1 << i); }           // mark as not available for speedup next checks
         }
+
+        storage.EndStringLoading();
+        DETAIL_LOG("%s: %u KB, %u KB saved by shared strings%s", filename.c_str(),
+                   uint32(storage.GetMemoryUsage() / 1024), uint32(storage.GetSharedStringBytes() / 1024), storage.IsMapped() ? ", mapped" : "");
     }
     else
     {
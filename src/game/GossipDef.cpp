@@ -29,6 +29,7 @@
 #include "WorldPacket.h"
 #include "WorldSession.h"
 #include "Formulas.h"
+#include "QueryResponseCache.h"
 
 GossipMenu::GossipMenu(WorldSession* session) : m_session(session)
 {
@@ -513,6 +514,10 @@ void PlayerMenu::SendQuestGiverQuestDetails(Quest const* pQuest, ObjectGuid guid
 // send only static data in this packet!
 void PlayerMenu::SendQuestQueryResponse(Quest const* pQuest)
 {
+    int loc_idx = GetMenuSession()->GetSessionDbLocaleIndex();
+    if (sQueryResponseCache.Send(GetMenuSession(), QUERY_RESPONSE_QUEST, pQuest->GetQuestId(), loc_idx))
+        { return; }
+
     std::string Title, Details, Objectives, EndText;
     std::string ObjectiveText[QUEST_OBJECTIVES_COUNT];
     Title = pQuest->GetTitle();
@@ -523,7 +528,6 @@ void PlayerMenu::SendQuestQueryResponse(Quest const* pQuest)
     for (int i = 0; i < QUEST_OBJECTIVES_COUNT; ++i)
         { ObjectiveText[i] = pQuest->ObjectiveText[i]; }
 
-    int loc_idx = GetMenuSession()->GetSessionDbLocaleIndex();
     if (loc_idx >= 0)
     {
         if (QuestLocale const* ql = sObjectMgr.GetQuestLocale(pQuest->GetQuestId()))
@@ -625,6 +629,7 @@ void PlayerMenu::SendQuestQueryResponse(Quest const* pQuest)
     for (iI = 0; iI < QUEST_OBJECTIVES_COUNT; ++iI)
         { data << ObjectiveText[iI]; }
 
+    sQueryResponseCache.Store(QUERY_RESPONSE_QUEST, pQuest->GetQuestId(), loc_idx, data);
     GetMenuSession()->SendPacket(&data);
 
     DEBUG_LOG("WORLD: Sent SMSG_QUEST_QUERY_RESPONSE questid=%u", pQuest->GetQuestId());
@@ -77,7 +77,7 @@ void VisibleNotifier::Notify()
         // send create/outofrange packet to player (except player create updates that already sent using SendUpdateToPlayer)
         WorldPacket packet;
         i_data.BuildPacket(&packet);
-        player.GetSession()->SendPacket(&packet);
+        player.GetSession()->SendOwnedPacket(packet);
 
         // send out of range to other players if need
         GuidSet const& oor = i_data.GetOutOfRangeGUIDs();
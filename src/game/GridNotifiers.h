@@ -35,6 +35,7 @@
 #include "GameObject.h"
 #include "Player.h"
 #include "Unit.h"
+#include "GridRangeFilter.h"
 
 namespace MaNGOS
 {
@@ -345,6 +346,15 @@ namespace MaNGOS
         void Visit(CreatureMapType& m);
         void Visit(PlayerMapType& m);
 
+        // called by RangeFilter for units possibly in range
+        bool OnCandidate(Unit* u)
+        {
+            if (!i_check(u))
+                { return true; }
+            i_object = u;
+            return false;
+        }
+
         template<class NOT_INTERESTED> void Visit(GridRefManager<NOT_INTERESTED>&) {}
     };
 
@@ -360,6 +370,14 @@ namespace MaNGOS
         void Visit(CreatureMapType& m);
         void Visit(PlayerMapType& m);
 
+        // called by RangeFilter for units possibly in range
+        bool OnCandidate(Unit* u)
+        {
+            if (i_check(u))
+                { i_object = u; }
+            return true;
+        }
+
         template<class NOT_INTERESTED> void Visit(GridRefManager<NOT_INTERESTED>&) {}
     };
 
@@ -375,6 +393,14 @@ namespace MaNGOS
         void Visit(PlayerMapType& m);
         void Visit(CreatureMapType& m);
 
+        // called by RangeFilter for units possibly in range
+        bool OnCandidate(Unit* u)
+        {
+            if (i_check(u))
+                { i_objects.push_back(u); }
+            return true;
+        }
+
         template<class NOT_INTERESTED> void Visit(GridRefManager<NOT_INTERESTED>&) {}
     };
 
@@ -755,14 +781,13 @@ namespace MaNGOS
             uint32 i_spell;
     };
 
-    class AnyUnfriendlyUnitInObjectRangeCheck
+    class AnyUnfriendlyUnitInObjectRangeCheck : public ObjectRangeCheck
     {
         public:
-            AnyUnfriendlyUnitInObjectRangeCheck(WorldObject const* obj, float range) : i_obj(obj), i_range(range)
+            AnyUnfriendlyUnitInObjectRangeCheck(WorldObject const* obj, float range) : ObjectRangeCheck(obj, range)
             {
                 i_controlledByPlayer = obj->IsControlledByPlayer();
             }
-            WorldObject const& GetFocusObject() const { return *i_obj; }
             bool operator()(Unit* u)
             {
                 if (u->IsAlive() && (i_controlledByPlayer ? !i_obj->IsFriendlyTo(u) : i_obj->IsHostileTo(u))
@@ -772,17 +797,14 @@ namespace MaNGOS
                     { return false; }
             }
         private:
-            WorldObject const* i_obj;
             bool i_controlledByPlayer;
-            float i_range;
     };
 
-    class AnyUnfriendlyVisibleUnitInObjectRangeCheck
+    class AnyUnfriendlyVisibleUnitInObjectRangeCheck : public ObjectRangeCheck
     {
         public:
             AnyUnfriendlyVisibleUnitInObjectRangeCheck(WorldObject const* obj, Unit const* funit, float range)
-                : i_obj(obj), i_funit(funit), i_range(range) {}
-            WorldObject const& GetFocusObject() const { return *i_obj; }
+                : ObjectRangeCheck(obj, range), i_funit(funit) {}
             bool operator()(Unit* u)
             {
                 return u->IsAlive()
@@ -791,16 +813,13 @@ namespace MaNGOS
                        && u->IsVisibleForOrDetect(i_funit, i_funit, false);
             }
         private:
-            WorldObject const* i_obj;
             Unit const* i_funit;
-            float i_range;
     };
 
-    class AnyFriendlyUnitInObjectRangeCheck
+    class AnyFriendlyUnitInObjectRangeCheck : public ObjectRangeCheck
     {
         public:
-            AnyFriendlyUnitInObjectRangeCheck(WorldObject const* obj, float range) : i_obj(obj), i_range(range) {}
-            WorldObject const& GetFocusObject() const { return *i_obj; }
+            AnyFriendlyUnitInObjectRangeCheck(WorldObject const* obj, float range) : ObjectRangeCheck(obj, range) {}
             bool operator()(Unit* u)
             {
                 if (u->IsAlive() && i_obj->IsWithinDistInMap(u, i_range) && i_obj->IsFriendlyTo(u))
@@ -808,16 +827,12 @@ namespace MaNGOS
                 else
                     { return false; }
             }
-        private:
-            WorldObject const* i_obj;
-            float i_range;
     };
 
-    class AnyUnitInObjectRangeCheck
+    class AnyUnitInObjectRangeCheck : public ObjectRangeCheck
     {
         public:
-            AnyUnitInObjectRangeCheck(WorldObject const* obj, float range) : i_obj(obj), i_range(range) {}
-            WorldObject const& GetFocusObject() const { return *i_obj; }
+            AnyUnitInObjectRangeCheck(WorldObject const* obj, float range) : ObjectRangeCheck(obj, range) {}
             bool operator()(Unit* u)
             {
                 if (u->IsAlive() && i_obj->IsWithinDistInMap(u, i_range))
@@ -825,17 +840,13 @@ namespace MaNGOS
 
                 return false;
             }
-        private:
-            WorldObject const* i_obj;
-            float i_range;
     };
 
     // Success at unit in range, range update for next check (this can be use with UnitLastSearcher to find nearest unit)
-    class NearestAttackableUnitInObjectRangeCheck
+    class NearestAttackableUnitInObjectRangeCheck : public ObjectRangeCheck
     {
         public:
-            NearestAttackableUnitInObjectRangeCheck(WorldObject const* obj, Unit const* funit, float range) : i_obj(obj), i_funit(funit), i_range(range) {}
-            WorldObject const& GetFocusObject() const { return *i_obj; }
+            NearestAttackableUnitInObjectRangeCheck(WorldObject const* obj, Unit const* funit, float range) : ObjectRangeCheck(obj, range), i_funit(funit) {}
             bool operator()(Unit* u)
             {
                 if (u->IsTargetableForAttack() && i_obj->IsWithinDistInMap(u, i_range) &&
@@ -848,24 +859,21 @@ namespace MaNGOS
                 return false;
             }
         private:
-            WorldObject const* i_obj;
             Unit const* i_funit;
-            float i_range;
 
             // prevent clone this object
             NearestAttackableUnitInObjectRangeCheck(NearestAttackableUnitInObjectRangeCheck const&);
     };
 
-    class AnyAoEVisibleTargetUnitInObjectRangeCheck
+    class AnyAoEVisibleTargetUnitInObjectRangeCheck : public ObjectRangeCheck
     {
         public:
             AnyAoEVisibleTargetUnitInObjectRangeCheck(WorldObject const* obj, WorldObject const* originalCaster, float range)
-                : i_obj(obj), i_originalCaster(originalCaster), i_range(range)
+                : ObjectRangeCheck(obj, range), i_originalCaster(originalCaster)
             {
                 i_targetForUnit = i_originalCaster->isType(TYPEMASK_UNIT);
                 i_targetForPlayer = (i_originalCaster->GetTypeId() == TYPEID_PLAYER);
             }
-            WorldObject const& GetFocusObject() const { return *i_obj; }
             bool operator()(Unit* u)
             {
                 // Check contains checks for: live, non-selectable, non-attackable flags, flight check and GM check, ignore totems
@@ -886,22 +894,19 @@ namespace MaNGOS
                 return false;
             }
         private:
-            WorldObject const* i_obj;
             WorldObject const* i_originalCaster;
-            float i_range;
             bool i_targetForUnit;
             bool i_targetForPlayer;
     };
 
-    class AnyAoETargetUnitInObjectRangeCheck
+    class AnyAoETargetUnitInObjectRangeCheck : public ObjectRangeCheck
     {
         public:
             AnyAoETargetUnitInObjectRangeCheck(WorldObject const* obj, float range)
-                : i_obj(obj), i_range(range)
+                : ObjectRangeCheck(obj, range)
             {
                 i_targetForPlayer = i_obj->IsControlledByPlayer();
             }
-            WorldObject const& GetFocusObject() const { return *i_obj; }
             bool operator()(Unit* u)
             {
                 // Check contains checks for: live, non-selectable, non-attackable flags, flight check and GM check, ignore totems
@@ -918,8 +923,6 @@ namespace MaNGOS
             }
 
         private:
-            WorldObject const* i_obj;
-            float i_range;
             bool i_targetForPlayer;
     };
 
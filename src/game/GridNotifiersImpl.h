@@ -50,8 +50,13 @@ inline void MaNGOS::ObjectUpdater::Visit(CreatureMapType& m)
 {
     for (CreatureMapType::iterator iter = m.begin(); iter != m.end(); ++iter)
     {
+        // idle creatures are still visited, only their update is skipped
+        uint32 timeDiff = i_timeDiff;
+        if (iter->getSource()->SkipIdleUpdate(i_timeDiff, timeDiff))
+            { continue; }
+
         WorldObject::UpdateHelper helper(iter->getSource());
-        helper.Update(i_timeDiff);
+        helper.Update(timeDiff);
     }
 }
 
@@ -452,6 +457,13 @@ void MaNGOS::UnitSearcher<Check>::Visit(CreatureMapType& m)
     if (i_object)
         { return; }
 
+    RangeFilter filter;
+    if (GetRangeFilter(&i_check, filter))
+    {
+        filter.Visit(m, *this);
+        return;
+    }
+
     for (CreatureMapType::iterator itr = m.begin(); itr != m.end(); ++itr)
     {
         if (i_check(itr->getSource()))
@@ -469,6 +481,13 @@ void MaNGOS::UnitSearcher<Check>::Visit(PlayerMapType& m)
     if (i_object)
         { return; }
 
+    RangeFilter filter;
+    if (GetRangeFilter(&i_check, filter))
+    {
+        filter.Visit(m, *this);
+        return;
+    }
+
     for (PlayerMapType::iterator itr = m.begin(); itr != m.end(); ++itr)
     {
         if (i_check(itr->getSource()))
@@ -482,6 +501,13 @@ void MaNGOS::UnitSearcher<Check>::Visit(PlayerMapType& m)
 template<class Check>
 void MaNGOS::UnitLastSearcher<Check>::Visit(CreatureMapType& m)
 {
+    RangeFilter filter;
+    if (GetRangeFilter(&i_check, filter))
+    {
+        filter.Visit(m, *this);
+        return;
+    }
+
     for (CreatureMapType::iterator itr = m.begin(); itr != m.end(); ++itr)
     {
         if (i_check(itr->getSource()))
@@ -492,6 +518,13 @@ void MaNGOS::UnitLastSearcher<Check>::Visit(CreatureMapType& m)
 template<class Check>
 void MaNGOS::UnitLastSearcher<Check>::Visit(PlayerMapType& m)
 {
+    RangeFilter filter;
+    if (GetRangeFilter(&i_check, filter))
+    {
+        filter.Visit(m, *this);
+        return;
+    }
+
     for (PlayerMapType::iterator itr = m.begin(); itr != m.end(); ++itr)
     {
         if (i_check(itr->getSource()))
@@ -502,6 +535,13 @@ void MaNGOS::UnitLastSearcher<Check>::Visit(PlayerMapType& m)
 template<class Check>
 void MaNGOS::UnitListSearcher<Check>::Visit(PlayerMapType& m)
 {
+    RangeFilter filter;
+    if (GetRangeFilter(&i_check, filter))
+    {
+        filter.Visit(m, *this);
+        return;
+    }
+
     for (PlayerMapType::iterator itr = m.begin(); itr != m.end(); ++itr)
         if (i_check(itr->getSource()))
             { i_objects.push_back(itr->getSource()); }
@@ -510,6 +550,13 @@ void MaNGOS::UnitListSearcher<Check>::Visit(PlayerMapType& m)
 template<class Check>
 void MaNGOS::UnitListSearcher<Check>::Visit(CreatureMapType& m)
 {
+    RangeFilter filter;
+    if (GetRangeFilter(&i_check, filter))
+    {
+        filter.Visit(m, *this);
+        return;
+    }
+
     for (CreatureMapType::iterator itr = m.begin(); itr != m.end(); ++itr)
         if (i_check(itr->getSource()))
             { i_objects.push_back(itr->getSource()); }
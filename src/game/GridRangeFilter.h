@@ -0,0 +1,174 @@
+/**
+ * MaNGOS is a full featured server for World of Warcraft, supporting
+ * the following clients: 1.12.x, 2.4.3, 3.3.5a, 4.3.4a and 5.4.8
+ *
+ * Copyright (C) 2005-2014  MaNGOS project <http://getmangos.eu>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * World of Warcraft, and all World of Warcraft or Warcraft art, images,
+ * and lore are copyrighted by Blizzard Entertainment, Inc.
+ */
+
+
+#ifndef MANGOS_GRIDRANGEFILTER_H
+#define MANGOS_GRIDRANGEFILTER_H
+
+#include "Common.h"
+#include "Object.h"
+#include "GameSystem/GridRefManager.h"
+
+#include <cfloat>
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#  define MANGOS_RANGE_FILTER_SSE
+#  include <xmmintrin.h>
+#endif
+
+#define RANGE_FILTER_BATCH_SIZE 64                          // must be a multiple of 4
+
+namespace MaNGOS
+{
+    /**
+     * @brief Batch 2d range filter for the objects of a grid cell
+     *
+     * Positions and bounding radius of up to RANGE_FILTER_BATCH_SIZE objects are packed
+     * into arrays and the squared distances are compared four at a time, only the objects
+     * that can be in range are passed on to the precise and more costly checks.
+     * The filter is conservative: 2d distance with some slack, so the caller still does the
+     * exact (3d, phase) distance check.
+     */
+    class MANGOS_DLL_DECL RangeFilter
+    {
+        public:
+            RangeFilter() : i_x(0.0f), i_y(0.0f), i_range(0.0f) {}
+            /**
+             * @param x, y     center of the searched area
+             * @param range    searched range, including the bounding radius of the focus object
+             */
+            RangeFilter(float x, float y, float range) : i_x(x), i_y(y), i_range(range + 0.1f) {}
+
+            /**
+             * Calls func.OnCandidate(T*) for every object of the cell that can be in range,
+             * stops when it returns false. OnCandidate must not remove objects from the grid.
+             */
+            template<class T, class F> void Visit(GridRefManager<T>& m, F& func) const
+            {
+                T* objects[RANGE_FILTER_BATCH_SIZE];
+                float posX[RANGE_FILTER_BATCH_SIZE], posY[RANGE_FILTER_BATCH_SIZE], radius[RANGE_FILTER_BATCH_SIZE];
+
+                uint32 count = 0;
+                for (typename GridRefManager<T>::iterator itr = m.begin(); itr != m.end(); ++itr)
+                {
+                    T* obj = itr->getSource();
+                    objects[count] = obj;
+                    posX[count] = obj->GetPositionX();
+                    posY[count] = obj->GetPositionY();
+                    radius[count] = obj->GetObjectBoundingRadius();
+
+                    if (++count == RANGE_FILTER_BATCH_SIZE)
+                    {
+                        if (!Flush(objects, posX, posY, radius, count, func))
+                            { return; }
+                        count = 0;
+                    }
+                }
+
+                if (count)
+                    { Flush(objects, posX, posY, radius, count, func); }
+            }
+
+        private:
+            template<class T, class F> bool Flush(T** objects, float* posX, float* posY, float* radius, uint32 count, F& func) const
+            {
+                // pad to full SSE registers with objects never in range
+                uint32 padded = (count + 3) & ~3;
+                for (uint32 i = count; i < padded; ++i)
+                {
+                    posX[i] = FLT_MAX;
+                    posY[i] = FLT_MAX;
+                    radius[i] = 0.0f;
+                }
+
+                for (uint32 i = 0; i < padded; i += 4)
+                {
+                    uint32 mask = InRangeMask(posX + i, posY + i, radius + i);
+                    for (uint32 j = 0; mask; ++j, mask >>= 1)
+                        if ((mask & 1) && !func.OnCandidate(objects[i + j]))
+                            { return false; }
+                }
+
+                return true;
+            }
+
+            uint32 InRangeMask(float const* posX, float const* posY, float const* radius) const
+            {
+#ifdef MANGOS_RANGE_FILTER_SSE
+                __m128 dx = _mm_sub_ps(_mm_loadu_ps(posX), _mm_set1_ps(i_x));
+                __m128 dy = _mm_sub_ps(_mm_loadu_ps(posY), _mm_set1_ps(i_y));
+                __m128 distSq = _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy));
+                __m128 maxDist = _mm_add_ps(_mm_loadu_ps(radius), _mm_set1_ps(i_range));
+                return uint32(_mm_movemask_ps(_mm_cmple_ps(distSq, _mm_mul_ps(maxDist, maxDist))));
+#else
+                uint32 mask = 0;
+                for (uint32 i = 0; i < 4; ++i)
+                {
+                    float dx = posX[i] - i_x;
+                    float dy = posY[i] - i_y;
+                    float maxDist = radius[i] + i_range;
+                    if (dx * dx + dy * dy <= maxDist * maxDist)
+                        { mask |= 1 << i; }
+                }
+                return mask;
+#endif
+            }
+
+            float i_x;
+            float i_y;
+            float i_range;
+    };
+
+    /**
+     * @brief Base of the checks accepting only objects in range of a focus object
+     *
+     * Searchers detect such checks with GetRangeFilter() and prefilter the cells in batch.
+     */
+    class MANGOS_DLL_DECL ObjectRangeCheck
+    {
+        public:
+            ObjectRangeCheck(WorldObject const* obj, float range) : i_obj(obj), i_range(range) {}
+
+            WorldObject const& GetFocusObject() const { return *i_obj; }
+            RangeFilter GetRangeFilter() const
+            {
+                return RangeFilter(i_obj->GetPositionX(), i_obj->GetPositionY(), i_range + i_obj->GetObjectBoundingRadius());
+            }
+
+        protected:
+            WorldObject const* i_obj;
+            float i_range;
+    };
+
+    inline bool GetRangeFilter(ObjectRangeCheck const* check, RangeFilter& filter)
+    {
+        filter = check->GetRangeFilter();
+        return true;
+    }
+
+    // any other check: no batch filtering
+    inline bool GetRangeFilter(void const* /*check*/, RangeFilter& /*filter*/) { return false; }
+}
+
+#endif
@@ -115,6 +115,7 @@ enum GroupUpdateFlags
 
     GROUP_UPDATE_PET                    = 0x0007FC00,       // all pet flags
     GROUP_UPDATE_FULL                   = 0x0007FFFF,       // all known flags
+    GROUP_UPDATE_URGENT                 = 0x00001C01,       // status and pet summon changes, never delayed
 };
 
 #define GROUP_UPDATE_FLAGS_COUNT          20
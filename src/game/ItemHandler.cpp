@@ -32,6 +32,7 @@
 #include "Item.h"
 #include "UpdateData.h"
 #include "Chat.h"
+#include "QueryResponseCache.h"
 
 void WorldSession::HandleSplitItemOpcode(WorldPacket& recv_data)
 {
@@ -296,6 +297,8 @@ void WorldSession::HandleItemQuerySingleOpcode(WorldPacket& recv_data)
     if (pProto)
     {
         int loc_idx = GetSessionDbLocaleIndex();
+        if (sQueryResponseCache.Send(this, QUERY_RESPONSE_ITEM, item, loc_idx))
+            { return; }
 
         std::string name = pProto->Name1;
         std::string description = pProto->Description;
@@ -409,6 +412,7 @@ void WorldSession::HandleItemQuerySingleOpcode(WorldPacket& recv_data)
         data << pProto->Area;
         data << pProto->Map;                                // Added in 1.12.x & 2.0.1 client branch
         data << pProto->BagFamily;
+        sQueryResponseCache.Store(QUERY_RESPONSE_ITEM, item, loc_idx, data);
         SendPacket(&data);
     }
     else
@@ -61,6 +61,9 @@
 #include "CreatureEventAIMgr.h"
 #include "AuctionHouseBot/AuctionHouseBot.h"
 #include "SQLStorages.h"
+#include "WorldSocketMgr.h"
+#include "QueryResponseCache.h"
+#include "OpcodeProfiler.h"
 
 static uint32 ahbotQualityIds[MAX_AUCTION_QUALITY] =
 {
@@ -467,6 +470,7 @@ bool ChatHandler::HandleReloadQuestTemplateCommand(char* /*args*/)
 {
     sLog.outString("Re-Loading Quest Templates...");
     sObjectMgr.LoadQuests();
+    sQueryResponseCache.Invalidate(QUERY_RESPONSE_QUEST);
     SendGlobalSysMessage("DB table `quest_template` (quest definitions) reloaded.");
 
     /// dependent also from `gameobject` but this table not reloaded anyway
@@ -576,6 +580,7 @@ bool ChatHandler::HandleReloadNpcTextCommand(char* /*args*/)
 {
     sLog.outString("Re-Loading `npc_text` Table!");
     sObjectMgr.LoadGossipText();
+    sQueryResponseCache.Invalidate(QUERY_RESPONSE_NPC_TEXT);
     SendGlobalSysMessage("DB table `npc_text` reloaded.");
     return true;
 }
@@ -681,6 +686,7 @@ bool ChatHandler::HandleReloadSpellElixirCommand(char* /*args*/)
 {
     sLog.outString("Re-Loading Spell Elixir types...");
     sSpellMgr.LoadSpellElixirs();
+    sSpellMgr.LoadSpellDerivedInfo();                       // elixir types are part of the spell specific
     SendGlobalSysMessage("DB table `spell_elixir` (spell elixir types) reloaded.");
     return true;
 }
@@ -981,6 +987,7 @@ bool ChatHandler::HandleReloadLocalesCreatureCommand(char* /*args*/)
 {
     sLog.outString("Re-Loading Locales Creature ...");
     sObjectMgr.LoadCreatureLocales();
+    sQueryResponseCache.Invalidate(QUERY_RESPONSE_CREATURE);
     SendGlobalSysMessage("DB table `locales_creature` reloaded.");
     return true;
 }
@@ -989,6 +996,7 @@ bool ChatHandler::HandleReloadLocalesGameobjectCommand(char* /*args*/)
 {
     sLog.outString("Re-Loading Locales Gameobject ... ");
     sObjectMgr.LoadGameObjectLocales();
+    sQueryResponseCache.Invalidate(QUERY_RESPONSE_GAMEOBJECT);
     SendGlobalSysMessage("DB table `locales_gameobject` reloaded.");
     return true;
 }
@@ -1005,6 +1013,7 @@ bool ChatHandler::HandleReloadLocalesItemCommand(char* /*args*/)
 {
     sLog.outString("Re-Loading Locales Item ... ");
     sObjectMgr.LoadItemLocales();
+    sQueryResponseCache.Invalidate(QUERY_RESPONSE_ITEM);
     SendGlobalSysMessage("DB table `locales_item` reloaded.");
     return true;
 }
@@ -1013,6 +1022,7 @@ bool ChatHandler::HandleReloadLocalesNpcTextCommand(char* /*args*/)
 {
     sLog.outString("Re-Loading Locales NPC Text ... ");
     sObjectMgr.LoadGossipTextLocales();
+    sQueryResponseCache.Invalidate(QUERY_RESPONSE_NPC_TEXT);
     SendGlobalSysMessage("DB table `locales_npc_text` reloaded.");
     return true;
 }
@@ -1037,6 +1047,7 @@ bool ChatHandler::HandleReloadLocalesQuestCommand(char* /*args*/)
 {
     sLog.outString("Re-Loading Locales Quest ... ");
     sObjectMgr.LoadQuestLocales();
+    sQueryResponseCache.Invalidate(QUERY_RESPONSE_QUEST);
     SendGlobalSysMessage("DB table `locales_quest` reloaded.");
     return true;
 }
@@ -5756,6 +5767,73 @@ bool ChatHandler::HandleServerPLimitCommand(char* args)
     return true;
 }
 
+bool ChatHandler::HandleServerNetStatsCommand(char* /*args*/)
+{
+    for (size_t i = 0; i < sWorldSocketMgr->GetNetworkThreadCount(); ++i)
+    {
+        NetworkThreadStats const& stats = sWorldSocketMgr->GetNetworkThreadStats(i);
+        PSendSysMessage("Network thread %u: %ld connections, %ld accepted, packets in/out %ld/%ld, KB in/out %ld/%ld",
+                        uint32(i), stats.connections.value(), stats.accepted.value(), stats.packetsIn.value(), stats.packetsOut.value(),
+                        stats.bytesIn.value() / 1024, stats.bytesOut.value() / 1024);
+    }
+
+    PacketBufferStats buffers;
+    PacketBufferPool::GetStats(buffers);
+    PSendSysMessage("Packet buffers: " UI64FMTD " allocated, " UI64FMTD " reused from thread caches, " UI64FMTD " handed back across threads, " UI64FMTD " oversized, " UI64FMTD " released",
+                    buffers.allocations, buffers.poolHits, buffers.returned, buffers.oversized, buffers.released);
+
+    return true;
+}
+
+bool ChatHandler::HandleServerOpcodeStatsCommand(char* args)
+{
+    if (ExtractLiteralArg(&args, "reset"))
+    {
+        sOpcodeProfiler.Reset();
+        SendSysMessage("Opcode statistics reset.");
+        return true;
+    }
+
+    uint32 count;
+    if (!ExtractOptUInt32(&args, count, 10))
+        { return false; }
+
+    std::vector<OpcodeStats> stats;
+    sOpcodeProfiler.GetStats(stats);
+
+    std::vector<uint16> order;
+    OpcodeProfiler::SortByTime(stats, order);
+    if (order.size() > count)
+        { order.resize(count); }
+
+    if (!sWorld.getConfig(CONFIG_BOOL_OPCODE_STATS_ENABLED))
+        { SendSysMessage("Opcode statistics are disabled (OpcodeStats.Enable)."); }
+
+    for (std::vector<uint16>::const_iterator itr = order.begin(); itr != order.end(); ++itr)
+    {
+        OpcodeStats const& opcodeStats = stats[*itr];
+        PSendSysMessage("%s (0x%.4X): " UI64FMTD " calls, " UI64FMTD " ms total, " UI64FMTD " us avg, %u us max, " UI64FMTD " KB",
+                        LookupOpcodeName(*itr), *itr, opcodeStats.calls, opcodeStats.totalTime / 1000,
+                        opcodeStats.totalTime / opcodeStats.calls, opcodeStats.maxTime, opcodeStats.bytes / 1024);
+    }
+
+    return true;
+}
+
+bool ChatHandler::HandleServerQueryCacheCommand(char* /*args*/)
+{
+    for (int i = 0; i < MAX_QUERY_RESPONSE_TYPE; ++i)
+    {
+        QueryResponseStats stats;
+        sQueryResponseCache.GetStats(QueryResponseType(i), stats);
+        PSendSysMessage("Query cache %s: %ld hits, %ld misses, %u responses, %u KB",
+                        QueryResponseCache::GetTypeName(QueryResponseType(i)), stats.hits, stats.misses,
+                        stats.entries, uint32(stats.bytes / 1024));
+    }
+
+    return true;
+}
+
 bool ChatHandler::HandleCastCommand(char* args)
 {
     if (!*args)
@@ -0,0 +1,170 @@
+/**
+ * MaNGOS is a full featured server for World of Warcraft, supporting
+ * the following clients: 1.12.x, 2.4.3, 3.3.5a, 4.3.4a and 5.4.8
+ *
+ * Copyright (C) 2005-2014  MaNGOS project <http://getmangos.eu>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * World of Warcraft, and all World of Warcraft or Warcraft art, images,
+ * and lore are copyrighted by Blizzard Entertainment, Inc.
+ */
+
+#include "LoadGraph.h"
+#include "Database/DatabaseEnv.h"
+#include "ProgressBar.h"
+#include "Timer.h"
+#include <ace/Thread_Manager.h>
+
+LoadGraph::LoadGraph() : m_remaining(0), m_wallTimeMs(0), m_stepDone(m_lock)
+{
+}
+
+uint32 LoadGraph::AddStep(char const* name, LoadFunc func, int32 after1, int32 after2, int32 after3)
+{
+    uint32 id = m_steps.size();
+
+    LoadStep step;
+    step.name = name;
+    step.func = func;
+    step.pendingDeps = 0;
+    step.timeMs = 0;
+    m_steps.push_back(step);
+
+    int32 after[3] = { after1, after2, after3 };
+    for (int i = 0; i < 3; ++i)
+    {
+        if (after[i] < 0)
+            { continue; }
+
+        MANGOS_ASSERT(uint32(after[i]) < id);
+        m_steps[after[i]].dependents.push_back(id);
+        ++m_steps[id].pendingDeps;
+    }
+
+    return id;
+}
+
+void LoadGraph::RunStep(uint32 id)
+{
+    sLog.outString("Loading %s...", m_steps[id].name);
+
+    uint32 startTime = WorldTimer::getMSTime();
+    m_steps[id].func();
+    m_steps[id].timeMs = WorldTimer::getMSTimeDiff(startTime, WorldTimer::getMSTime());
+}
+
+void LoadGraph::RunReadySteps()
+{
+    m_lock.acquire();
+    while (m_remaining)
+    {
+        if (m_ready.empty())
+        {
+            m_stepDone.wait();
+            continue;
+        }
+
+        uint32 id = m_ready.front();
+        m_ready.pop_front();
+
+        m_lock.release();
+        RunStep(id);
+        m_lock.acquire();
+
+        --m_remaining;
+
+        std::vector<uint32> const& dependents = m_steps[id].dependents;
+        for (std::vector<uint32>::const_iterator itr = dependents.begin(); itr != dependents.end(); ++itr)
+            if (--m_steps[*itr].pendingDeps == 0)
+                { m_ready.push_back(*itr); }
+
+        m_stepDone.broadcast();
+    }
+    m_lock.release();
+}
+
+ACE_THR_FUNC_RETURN LoadGraph::Worker(void* arg)
+{
+    WorldDatabase.ThreadStart();                            // let thread do safe mySQL requests
+    static_cast<LoadGraph*>(arg)->RunReadySteps();
+    WorldDatabase.ThreadEnd();                              // free mySQL thread resources
+    return 0;
+}
+
+void LoadGraph::Run(uint32 threads)
+{
+    uint32 startTime = WorldTimer::getMSTime();
+
+    if (threads > m_steps.size())
+        { threads = m_steps.size(); }
+
+    if (threads <= 1)
+    {
+        // steps only depend on earlier ones, so insertion order is a valid order
+        for (uint32 id = 0; id < m_steps.size(); ++id)
+            { RunStep(id); }
+    }
+    else
+    {
+        m_remaining = m_steps.size();
+        for (uint32 id = 0; id < m_steps.size(); ++id)
+            if (!m_steps[id].pendingDeps)
+                { m_ready.push_back(id); }
+
+        // progress bars of concurrent loaders would overwrite each other
+        BarGoLink::SetOutputState(false);
+
+        int grp = ACE_Thread_Manager::instance()->spawn_n(threads, (ACE_THR_FUNC)&LoadGraph::Worker, this);
+        if (grp == -1)
+        {
+            sLog.outError("LoadGraph: can't spawn loader threads, loading sequentially");
+            RunReadySteps();                                // the main thread keeps its own mySQL thread resources
+        }
+        else
+            { ACE_Thread_Manager::instance()->wait_grp(grp); }
+
+        BarGoLink::SetOutputState(true);
+    }
+
+    m_wallTimeMs = WorldTimer::getMSTimeDiff(startTime, WorldTimer::getMSTime());
+}
+
+/**
+ * @brief
+ *
+ */
+struct LoadStepTimeGreater
+{
+    bool operator()(std::pair<uint32, char const*> const& a, std::pair<uint32, char const*> const& b) const { return a.first > b.first; }
+};
+
+void LoadGraph::Report() const
+{
+    std::vector<std::pair<uint32, char const*> > times;
+    uint32 totalMs = 0;
+    for (std::vector<LoadStep>::const_iterator itr = m_steps.begin(); itr != m_steps.end(); ++itr)
+    {
+        times.push_back(std::make_pair(itr->timeMs, itr->name));
+        totalMs += itr->timeMs;
+    }
+
+    std::sort(times.begin(), times.end(), LoadStepTimeGreater());
+
+    sLog.outString("Loader timings (%u ms wall time, %u ms summed over all loaders):", m_wallTimeMs, totalMs);
+    for (std::vector<std::pair<uint32, char const*> >::const_iterator itr = times.begin(); itr != times.end(); ++itr)
+        { sLog.outString("  %8u ms  %s", itr->first, itr->second); }
+    sLog.outString();
+}
@@ -0,0 +1,121 @@
+/**
+ * MaNGOS is a full featured server for World of Warcraft, supporting
+ * the following clients: 1.12.x, 2.4.3, 3.3.5a, 4.3.4a and 5.4.8
+ *
+ * Copyright (C) 2005-2014  MaNGOS project <http://getmangos.eu>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * World of Warcraft, and all World of Warcraft or Warcraft art, images,
+ * and lore are copyrighted by Blizzard Entertainment, Inc.
+ */
+
+#ifndef MANGOS_LOADGRAPH_H
+#define MANGOS_LOADGRAPH_H
+
+#include "Common.h"
+#include <deque>
+#include <ace/Thread_Mutex.h>
+#include <ace/Condition_Thread_Mutex.h>
+
+/**
+ * @brief Runs startup loaders in dependency order, independent ones on several threads
+ *
+ * Every step names the steps it has to wait for. With a single thread the steps
+ * run in the order they were added, so the graph can be filled in the same order
+ * as a plain sequential load.
+ */
+class LoadGraph
+{
+    public:
+        /**
+         * @brief
+         *
+         */
+        typedef void (*LoadFunc)();
+
+        /**
+         * @brief
+         *
+         */
+        LoadGraph();
+
+        /**
+         * @brief adds a loader, dependencies must have been added before it
+         *
+         * @param name shown in the timing report
+         * @param func
+         * @param after1
+         * @param after2
+         * @param after3
+         * @return uint32 step id to be used as dependency of later steps
+         */
+        uint32 AddStep(char const* name, LoadFunc func, int32 after1 = -1, int32 after2 = -1, int32 after3 = -1);
+
+        /**
+         * @brief runs all steps and returns when every step has finished
+         *
+         * @param threads
+         */
+        void Run(uint32 threads);
+
+        /**
+         * @brief prints the time every step took, slowest first
+         *
+         */
+        void Report() const;
+
+    private:
+        /**
+         * @brief
+         *
+         */
+        struct LoadStep
+        {
+            char const* name;                               /**< TODO */
+            LoadFunc func;                                  /**< TODO */
+            std::vector<uint32> dependents;                 /**< steps waiting for this one */
+            uint32 pendingDeps;                             /**< unfinished steps this one waits for */
+            uint32 timeMs;                                  /**< TODO */
+        };
+
+        /**
+         * @brief
+         *
+         * @param id
+         */
+        void RunStep(uint32 id);
+        /**
+         * @brief runs steps as they become ready until all are done
+         *
+         */
+        void RunReadySteps();
+        /**
+         * @brief loader thread entry, RunReadySteps with mySQL thread setup
+         *
+         * @param arg
+         * @return ACE_THR_FUNC_RETURN
+         */
+        static ACE_THR_FUNC_RETURN Worker(void* arg);
+
+        std::vector<LoadStep> m_steps;                      /**< TODO */
+        std::deque<uint32> m_ready;                         /**< steps with all dependencies done */
+        uint32 m_remaining;                                 /**< TODO */
+        uint32 m_wallTimeMs;                                /**< TODO */
+        ACE_Thread_Mutex m_lock;                            /**< TODO */
+        ACE_Condition_Thread_Mutex m_stepDone;              /**< TODO */
+};
+
+#endif
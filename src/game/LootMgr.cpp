@@ -102,12 +102,22 @@ void LootStore::LoadLootTable()
 
     sLog.outString("%s :", GetName());
 
-    //                                                 0      1     2                    3        4              5         6
-    QueryResult* result = WorldDatabase.PQuery("SELECT entry, item, ChanceOrQuestChance, groupid, mincountOrRef, maxcount, condition_id FROM %s", GetName());
+    // the result is streamed, so the progress bar size is queried up front
+    uint32 rowCount = 0;
+    if (QueryResult* countResult = WorldDatabase.PQuery("SELECT COUNT(*) FROM %s", GetName()))
+    {
+        rowCount = (*countResult)[0].GetUInt32();
+        delete countResult;
+    }
+
+    //                        0      1     2                    3        4              5         6
+    std::string sql = "SELECT entry, item, ChanceOrQuestChance, groupid, mincountOrRef, maxcount, condition_id FROM ";
+    sql += GetName();
+    QueryResult* result = WorldDatabase.QuerySnapshot(GetName(), GetName(), sql.c_str());
 
     if (result)
     {
-        BarGoLink bar(result->GetRowCount());
+        BarGoLink bar(rowCount);
 
         do
         {
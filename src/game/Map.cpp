@@ -82,7 +82,6 @@ Map::Map(uint32 id, time_t expiry, uint32 InstanceId)
     : i_mapEntry(sMapStore.LookupEntry(id)),
       i_id(id), i_InstanceId(InstanceId), m_unloadTimer(0),
       m_VisibleDistance(DEFAULT_VISIBILITY_DISTANCE), m_persistentState(NULL),
-      m_activeNonPlayersIter(m_activeNonPlayers.end()),
       i_gridExpiry(expiry), m_TerrainData(sTerrainMgr.LoadTerrain(id)),
       i_data(NULL), i_script_id(0)
 {
@@ -303,6 +302,7 @@ bool Map::Add(Player* player)
     Cell cell(p);
     EnsureGridLoadedAtEnter(cell, player);
     player->AddToWorld();
+    AddActiveCellViewer(player);
 
     SendInitSelf(player);
     SendInitTransports(player);
@@ -476,83 +476,24 @@ void Map::Update(const uint32& t_diff)
     }
 
     /// update active cells around players and active objects
-    resetMarkedCells();
-
     MaNGOS::ObjectUpdater updater(t_diff);
     // for creature
     TypeContainerVisitor<MaNGOS::ObjectUpdater, GridTypeMapContainer  > grid_object_update(updater);
     // for pets
     TypeContainerVisitor<MaNGOS::ObjectUpdater, WorldTypeMapContainer > world_object_update(updater);
 
-    // the player iterator is stored in the map object
-    // to make sure calls to Map::Remove don't invalidate it
-    for (m_mapRefIter = m_mapRefManager.begin(); m_mapRefIter != m_mapRefManager.end(); ++m_mapRefIter)
-    {
-        Player* plr = m_mapRefIter->getSource();
-
-        if (!plr->IsInWorld() || !plr->IsPositionValid())
-            { continue; }
-
-        // lets update mobs/objects in ALL visible cells around player!
-        CellArea area = Cell::CalculateCellArea(plr->GetPositionX(), plr->GetPositionY(), GetVisibilityDistance());
-
-        for (uint32 x = area.low_bound.x_coord; x <= area.high_bound.x_coord; ++x)
-        {
-            for (uint32 y = area.low_bound.y_coord; y <= area.high_bound.y_coord; ++y)
-            {
-                // marked cells are those that have been visited
-                // don't visit the same cell twice
-                uint32 cell_id = (y * TOTAL_NUMBER_OF_CELLS_PER_MAP) + x;
-                if (!isCellMarked(cell_id))
-                {
-                    markCell(cell_id);
-                    CellPair pair(x, y);
-                    Cell cell(pair);
-                    cell.SetNoCreate();
-                    Visit(cell, grid_object_update);
-                    Visit(cell, world_object_update);
-                }
-            }
-        }
-    }
+    // objects can change the active cells at update (active objects relocation, players removal), so use a snapshot
+    m_activeCellsUpdateList.clear();
+    for (ActiveCellMap::const_iterator itr = m_activeCells.begin(); itr != m_activeCells.end(); ++itr)
+        { m_activeCellsUpdateList.push_back(itr->first); }
 
-    // non-player active objects
-    if (!m_activeNonPlayers.empty())
+    for (std::vector<uint32>::const_iterator itr = m_activeCellsUpdateList.begin(); itr != m_activeCellsUpdateList.end(); ++itr)
     {
-        for (m_activeNonPlayersIter = m_activeNonPlayers.begin(); m_activeNonPlayersIter != m_activeNonPlayers.end();)
-        {
-            // skip not in world
-            WorldObject* obj = *m_activeNonPlayersIter;
-
-            // step before processing, in this case if Map::Remove remove next object we correctly
-            // step to next-next, and if we step to end() then newly added objects can wait next update.
-            ++m_activeNonPlayersIter;
-
-            if (!obj->IsInWorld() || !obj->IsPositionValid())
-                { continue; }
-
-            // lets update mobs/objects in ALL visible cells around player!
-            CellArea area = Cell::CalculateCellArea(obj->GetPositionX(), obj->GetPositionY(), GetVisibilityDistance());
-
-            for (uint32 x = area.low_bound.x_coord; x <= area.high_bound.x_coord; ++x)
-            {
-                for (uint32 y = area.low_bound.y_coord; y <= area.high_bound.y_coord; ++y)
-                {
-                    // marked cells are those that have been visited
-                    // don't visit the same cell twice
-                    uint32 cell_id = (y * TOTAL_NUMBER_OF_CELLS_PER_MAP) + x;
-                    if (!isCellMarked(cell_id))
-                    {
-                        markCell(cell_id);
-                        CellPair pair(x, y);
-                        Cell cell(pair);
-                        cell.SetNoCreate();
-                        Visit(cell, grid_object_update);
-                        Visit(cell, world_object_update);
-                    }
-                }
-            }
-        }
+        CellPair pair(*itr % TOTAL_NUMBER_OF_CELLS_PER_MAP, *itr / TOTAL_NUMBER_OF_CELLS_PER_MAP);
+        Cell cell(pair);
+        cell.SetNoCreate();
+        Visit(cell, grid_object_update);
+        Visit(cell, world_object_update);
     }
 
     // Send world objects and item update field changes
@@ -594,6 +535,8 @@ void Map::Remove(Player* player, bool remove)
     else
         { player->RemoveFromWorld(); }
 
+    RemoveActiveCellViewer(player);
+
     // this may be called during Map::Update
     // after decrement+unlink, ++m_mapRefIter will continue correctly
     // when the first element of the list is being removed
@@ -708,6 +651,7 @@ Map::PlayerRelocation(Player* player, float x, float y, float z, float orientati
     }
 
     player->OnRelocated();
+    UpdateActiveCellViewer(player);
 
     NGridType* newGrid = getNGrid(new_cell.GridX(), new_cell.GridY());
     if (!same_cell && newGrid->GetGridState() != GRID_STATE_ACTIVE)
@@ -721,6 +665,8 @@ void Map::CreatureRelocation(Creature* creature, float x, float y, float z, floa
 {
     MANGOS_ASSERT(CheckGridIntegrity(creature, false));
 
+    creature->WakeUp();
+
     Cell new_cell(MaNGOS::ComputeCellPair(x, y));
 
     // do move or do move to respawn or remove creature if previous all fail
@@ -729,6 +675,8 @@ void Map::CreatureRelocation(Creature* creature, float x, float y, float z, floa
         // update pos
         creature->Relocate(x, y, z, ang);
         creature->OnRelocated();
+        if (creature->isActiveObject())
+            { UpdateActiveCellViewer(creature); }
     }
     // if creature can't be move in new cell/grid (not loaded) move it to repawn cell/grid
     // creature coordinates will be updated and notifiers send
@@ -785,6 +733,8 @@ bool Map::CreatureRespawnRelocation(Creature* c)
         c->Relocate(resp_x, resp_y, resp_z, resp_o);
         c->GetMotionMaster()->Initialize();                 // prevent possible problems with default move generators
         c->OnRelocated();
+        if (c->isActiveObject())
+            { UpdateActiveCellViewer(c); }
         return true;
     }
     else
@@ -908,7 +858,7 @@ void Map::SendInitSelf(Player* player)
 
     WorldPacket packet;
     data.BuildPacket(&packet, hasTransport);
-    player->GetSession()->SendPacket(&packet);
+    player->GetSession()->SendOwnedPacket(packet);
 }
 
 void Map::SendInitTransports(Player* player)
@@ -938,7 +888,7 @@ void Map::SendInitTransports(Player* player)
 
     WorldPacket packet;
     transData.BuildPacket(&packet, hasTransport);
-    player->GetSession()->SendPacket(&packet);
+    player->GetSession()->SendOwnedPacket(packet);
 }
 
 void Map::SendRemoveTransports(Player* player)
@@ -961,7 +911,7 @@ void Map::SendRemoveTransports(Player* player)
 
     WorldPacket packet;
     transData.BuildPacket(&packet);
-    player->GetSession()->SendPacket(&packet);
+    player->GetSession()->SendOwnedPacket(packet);
 }
 
 inline void Map::setNGrid(NGridType* grid, uint32 x, uint32 y)
@@ -1087,6 +1037,8 @@ bool Map::ActiveObjectsNearGrid(uint32 x, uint32 y) const
 void Map::AddToActive(WorldObject* obj)
 {
     m_activeNonPlayers.insert(obj);
+    if (obj->GetTypeId() != TYPEID_PLAYER)
+        { AddActiveCellViewer(obj); }
     Cell cell = Cell(MaNGOS::ComputeCellPair(obj->GetPositionX(), obj->GetPositionY()));
     EnsureGridLoaded(cell);
 
@@ -1114,16 +1066,9 @@ void Map::AddToActive(WorldObject* obj)
 
 void Map::RemoveFromActive(WorldObject* obj)
 {
-    // Map::Update for active object in proccess
-    if (m_activeNonPlayersIter != m_activeNonPlayers.end())
-    {
-        ActiveNonPlayers::iterator itr = m_activeNonPlayers.find(obj);
-        if (itr == m_activeNonPlayersIter)
-            { ++m_activeNonPlayersIter; }
-        m_activeNonPlayers.erase(itr);
-    }
-    else
-        { m_activeNonPlayers.erase(obj); }
+    m_activeNonPlayers.erase(obj);
+    if (obj->GetTypeId() != TYPEID_PLAYER)
+        { RemoveActiveCellViewer(obj); }
 
     // also allow unloading spawn grid
     if (obj->GetTypeId() == TYPEID_UNIT)
@@ -1147,6 +1092,85 @@ void Map::RemoveFromActive(WorldObject* obj)
     }
 }
 
+static inline bool IsInCellArea(CellArea const& area, uint32 x, uint32 y)
+{
+    return area.low_bound.x_coord <= x && x <= area.high_bound.x_coord &&
+           area.low_bound.y_coord <= y && y <= area.high_bound.y_coord;
+}
+
+void Map::AddActiveCells(CellArea const& area, CellArea const* except)
+{
+    for (uint32 x = area.low_bound.x_coord; x <= area.high_bound.x_coord; ++x)
+    {
+        for (uint32 y = area.low_bound.y_coord; y <= area.high_bound.y_coord; ++y)
+        {
+            if (except && IsInCellArea(*except, x, y))
+                { continue; }
+
+            ++m_activeCells[(y * TOTAL_NUMBER_OF_CELLS_PER_MAP) + x];
+        }
+    }
+}
+
+void Map::RemoveActiveCells(CellArea const& area, CellArea const* except)
+{
+    for (uint32 x = area.low_bound.x_coord; x <= area.high_bound.x_coord; ++x)
+    {
+        for (uint32 y = area.low_bound.y_coord; y <= area.high_bound.y_coord; ++y)
+        {
+            if (except && IsInCellArea(*except, x, y))
+                { continue; }
+
+            ActiveCellMap::iterator itr = m_activeCells.find((y * TOTAL_NUMBER_OF_CELLS_PER_MAP) + x);
+            MANGOS_ASSERT(itr != m_activeCells.end());
+            if (--itr->second == 0)
+                { m_activeCells.erase(itr); }
+        }
+    }
+}
+
+void Map::AddActiveCellViewer(WorldObject* obj)
+{
+    if (m_activeCellViewers.find(obj) != m_activeCellViewers.end())
+        { return; }
+
+    CellArea area = Cell::CalculateCellArea(obj->GetPositionX(), obj->GetPositionY(), GetVisibilityDistance());
+    m_activeCellViewers[obj] = area;
+    AddActiveCells(area, NULL);
+}
+
+void Map::RemoveActiveCellViewer(WorldObject* obj)
+{
+    ActiveCellViewers::iterator itr = m_activeCellViewers.find(obj);
+    if (itr == m_activeCellViewers.end())
+        { return; }
+
+    RemoveActiveCells(itr->second, NULL);
+    m_activeCellViewers.erase(itr);
+}
+
+void Map::UpdateActiveCellViewer(WorldObject* obj)
+{
+    ActiveCellViewers::iterator itr = m_activeCellViewers.find(obj);
+    if (itr == m_activeCellViewers.end())
+        { return; }
+
+    CellArea area = Cell::CalculateCellArea(obj->GetPositionX(), obj->GetPositionY(), GetVisibilityDistance());
+    if (area.low_bound == itr->second.low_bound && area.high_bound == itr->second.high_bound)
+        { return; }
+
+    // only cells entering or leaving the viewer area change their counters
+    AddActiveCells(area, &itr->second);
+    RemoveActiveCells(itr->second, &area);
+    itr->second = area;
+}
+
+void Map::UpdateActiveCellViewers()
+{
+    for (ActiveCellViewers::const_iterator itr = m_activeCellViewers.begin(); itr != m_activeCellViewers.end(); ++itr)
+        { UpdateActiveCellViewer(const_cast<WorldObject*>(itr->first)); }
+}
+
 void Map::CreateInstanceData(bool load)
 {
     if (i_data != NULL)
@@ -1831,8 +1855,7 @@ void Map::SendObjectUpdates()
     for (UpdateDataMapType::iterator iter = update_players.begin(); iter != update_players.end(); ++iter)
     {
         iter->second.BuildPacket(&packet);
-        iter->first->GetSession()->SendPacket(&packet);
-        packet.clear();                                     // clean the string
+        iter->first->GetSession()->SendOwnedPacket(packet);  // leaves packet empty
     }
 }
 
@@ -45,7 +45,6 @@
 #include "CreatureLinkingMgr.h"
 #include "vmap/DynamicTree.h"
 
-#include <bitset>
 #include <list>
 
 struct CreatureInfo;
@@ -195,9 +194,9 @@ class MANGOS_DLL_SPEC Map : public GridRefManager<NGridType>
 
         void UpdateObjectVisibility(WorldObject* obj, Cell cell, CellPair cellpair);
 
-        void resetMarkedCells() { marked_cells.reset(); }
-        bool isCellMarked(uint32 pCellId) { return marked_cells.test(pCellId); }
-        void markCell(uint32 pCellId) { marked_cells.set(pCellId); }
+        // cells in visibility range of players and active objects, updated at each tick
+        void UpdateActiveCellViewer(WorldObject* obj);      // must be called after viewer relocation
+        void UpdateActiveCellViewers();                     // must be called after visibility distance change
 
         bool HavePlayers() const { return !m_mapRefManager.isEmpty(); }
         uint32 GetPlayersCountExceptGMs() const;
@@ -325,7 +324,6 @@ class MANGOS_DLL_SPEC Map : public GridRefManager<NGridType>
 
         typedef std::set<WorldObject*> ActiveNonPlayers;
         ActiveNonPlayers m_activeNonPlayers;
-        ActiveNonPlayers::iterator m_activeNonPlayersIter;
         MapStoredObjectTypesContainer m_objectsStore;
 
     private:
@@ -337,7 +335,16 @@ class MANGOS_DLL_SPEC Map : public GridRefManager<NGridType>
         TerrainInfo* const m_TerrainData;
         bool m_bLoadedGrids[MAX_NUMBER_OF_GRIDS][MAX_NUMBER_OF_GRIDS];
 
-        std::bitset<TOTAL_NUMBER_OF_CELLS_PER_MAP* TOTAL_NUMBER_OF_CELLS_PER_MAP> marked_cells;
+        void AddActiveCellViewer(WorldObject* obj);
+        void RemoveActiveCellViewer(WorldObject* obj);
+        void AddActiveCells(CellArea const& area, CellArea const* except);
+        void RemoveActiveCells(CellArea const& area, CellArea const* except);
+
+        typedef std::map<WorldObject const*, CellArea> ActiveCellViewers;
+        ActiveCellViewers m_activeCellViewers;              // players and active objects with their visible cell area
+        typedef UNORDERED_MAP<uint32 /*cell id*/, uint32 /*viewers count*/> ActiveCellMap;
+        ActiveCellMap m_activeCells;
+        std::vector<uint32> m_activeCellsUpdateList;        // snapshot of m_activeCells used at update, viewers can move while cells are updated
 
         std::set<WorldObject*> i_objectsToRemove;
 
@@ -90,7 +90,10 @@ void MapManager::UpdateGridState(grid_state_t state, Map& map, NGridType& ngrid,
 void MapManager::InitializeVisibilityDistanceInfo()
 {
     for (MapMapType::iterator iter = i_maps.begin(); iter != i_maps.end(); ++iter)
-        { (*iter).second->InitVisibilityDistance(); }
+    {
+        (*iter).second->InitVisibilityDistance();
+        (*iter).second->UpdateActiveCellViewers();
+    }
 }
 
 Map* MapManager::CreateMap(uint32 id, const WorldObject* obj)
@@ -41,11 +41,18 @@
 #include "Group.h"
 #include "InstanceData.h"
 #include "ProgressBar.h"
+#include "Config/Config.h"
 
 INSTANTIATE_SINGLETON_1(MapPersistentStateManager);
 
 static uint32 resetEventTypeDelay[MAX_RESET_EVENT_TYPE] = { 0, 3600, 900, 300, 60 };
 
+static char const* respawnTimeTables[MAX_RESPAWN_TIME_TYPE] = { "creature_respawn", "gameobject_respawn" };
+static char const respawnTimeJournalTypes[MAX_RESPAWN_TIME_TYPE] = { 'C', 'G' };
+
+// max rows per batched respawn time statement
+#define RESPAWN_TIME_SAVE_BATCH 500
+
 //== MapPersistentState functions ==========================
 MapPersistentState::MapPersistentState(uint16 MapId, uint32 InstanceId)
     : m_instanceid(InstanceId), m_mapid(MapId),
@@ -82,21 +89,7 @@ void MapPersistentState::SaveCreatureRespawnTime(uint32 loguid, time_t t)
     if (GetMapEntry()->IsBattleGround())
         { return; }
 
-    CharacterDatabase.BeginTransaction();
-
-    static SqlStatementID delSpawnTime ;
-    static SqlStatementID insSpawnTime ;
-
-    SqlStatement stmt = CharacterDatabase.CreateStatement(delSpawnTime, "DELETE FROM creature_respawn WHERE guid = ? AND instance = ?");
-    stmt.PExecute(loguid, m_instanceid);
-
-    if (t > sWorld.GetGameTime())
-    {
-        stmt = CharacterDatabase.CreateStatement(insSpawnTime, "INSERT INTO creature_respawn VALUES ( ?, ?, ? )");
-        stmt.PExecute(loguid, uint64(t), m_instanceid);
-    }
-
-    CharacterDatabase.CommitTransaction();
+    sMapPersistentStateMgr.ScheduleRespawnTimeSave(RESPAWN_TIME_CREATURE, m_instanceid, loguid, t);
 }
 
 void MapPersistentState::SaveGORespawnTime(uint32 loguid, time_t t)
@@ -107,21 +100,7 @@ void MapPersistentState::SaveGORespawnTime(uint32 loguid, time_t t)
     if (GetMapEntry()->IsBattleGround())
         { return; }
 
-    CharacterDatabase.BeginTransaction();
-
-    static SqlStatementID delSpawnTime ;
-    static SqlStatementID insSpawnTime ;
-
-    SqlStatement stmt = CharacterDatabase.CreateStatement(delSpawnTime, "DELETE FROM gameobject_respawn WHERE guid = ? AND instance = ?");
-    stmt.PExecute(loguid, m_instanceid);
-
-    if (t > sWorld.GetGameTime())
-    {
-        stmt = CharacterDatabase.CreateStatement(insSpawnTime, "INSERT INTO gameobject_respawn VALUES ( ?, ?, ? )");
-        stmt.PExecute(loguid, uint64(t), m_instanceid);
-    }
-
-    CharacterDatabase.CommitTransaction();
+    sMapPersistentStateMgr.ScheduleRespawnTimeSave(RESPAWN_TIME_GAMEOBJECT, m_instanceid, loguid, t);
 }
 
 void MapPersistentState::SetCreatureRespawnTime(uint32 loguid, time_t t)
@@ -261,10 +240,7 @@ void DungeonPersistentState::SaveToDB()
 
 void DungeonPersistentState::DeleteRespawnTimes()
 {
-    CharacterDatabase.BeginTransaction();
-    CharacterDatabase.PExecute("DELETE FROM creature_respawn WHERE instance = '%u'", GetInstanceId());
-    CharacterDatabase.PExecute("DELETE FROM gameobject_respawn WHERE instance = '%u'", GetInstanceId());
-    CharacterDatabase.CommitTransaction();
+    sMapPersistentStateMgr.DeleteInstanceRespawnTimes(GetInstanceId());
 
     ClearRespawnTimes();                                    // state can be deleted at call if only respawn data prevent unload
 }
@@ -549,7 +525,7 @@ void DungeonResetScheduler::Update()
 
 //== MapPersistentStateManager functions =========================
 
-MapPersistentStateManager::MapPersistentStateManager() : lock_instLists(false), m_Scheduler(*this)
+MapPersistentStateManager::MapPersistentStateManager() : lock_instLists(false), m_Scheduler(*this), m_respawnJournal(NULL), m_respawnBatchId(0)
 {
 }
 
@@ -562,6 +538,9 @@ MapPersistentStateManager::~MapPersistentStateManager()
         { delete  itr->second; }
     for (PersistentStateMap::iterator itr = m_instanceSaveByMapId.begin(); itr != m_instanceSaveByMapId.end(); ++itr)
         { delete  itr->second; }
+
+    if (m_respawnJournal)
+        { fclose(m_respawnJournal); }
 }
 
 /*
@@ -634,12 +613,12 @@ void MapPersistentStateManager::DeleteInstanceFromDB(uint32 instanceid)
 {
     if (instanceid)
     {
+        sMapPersistentStateMgr.DeleteInstanceRespawnTimes(instanceid);
+
         CharacterDatabase.BeginTransaction();
         CharacterDatabase.PExecute("DELETE FROM instance WHERE id = '%u'", instanceid);
         CharacterDatabase.PExecute("DELETE FROM character_instance WHERE instance = '%u'", instanceid);
         CharacterDatabase.PExecute("DELETE FROM group_instance WHERE instance = '%u'", instanceid);
-        CharacterDatabase.PExecute("DELETE FROM creature_respawn WHERE instance = '%u'", instanceid);
-        CharacterDatabase.PExecute("DELETE FROM gameobject_respawn WHERE instance = '%u'", instanceid);
         CharacterDatabase.CommitTransaction();
     }
 }
@@ -1026,3 +1005,297 @@ void MapPersistentStateManager::LoadGameobjectRespawnTimes()
     sLog.outString(">> Loaded %u gameobject respawn times", count);
     sLog.outString();
 }
+
+void MapPersistentStateManager::Update(uint32 diff)
+{
+    m_Scheduler.Update();
+
+    m_respawnSaveTimer.SetInterval(sWorld.getConfig(CONFIG_UINT32_INTERVAL_SAVE_RESPAWN));
+    m_respawnSaveTimer.Update(diff);
+    if (m_respawnSaveTimer.Passed())
+    {
+        m_respawnSaveTimer.Reset();
+        SaveRespawnTimes();
+    }
+}
+
+void MapPersistentStateManager::ScheduleRespawnTimeSave(RespawnTimeType type, uint32 instanceId, uint32 loguid, time_t t)
+{
+    {
+        ACE_Guard<ACE_Thread_Mutex> guard(m_respawnLock);
+
+        // only the last respawn time of an object matters
+        m_pendingRespawnTimes[type][std::make_pair(instanceId, loguid)] = t;
+
+        if (m_respawnJournal)
+        {
+            fprintf(m_respawnJournal, "%c %u %u " UI64FMTD "\n", respawnTimeJournalTypes[type], instanceId, loguid, uint64(t));
+            fflush(m_respawnJournal);
+        }
+    }
+
+    // no interval, keep the old behaviour of saving right away
+    if (!sWorld.getConfig(CONFIG_UINT32_INTERVAL_SAVE_RESPAWN))
+        { SaveRespawnTimes(); }
+}
+
+void MapPersistentStateManager::DeleteInstanceRespawnTimes(uint32 instanceId)
+{
+    // a batch taken by SaveRespawnTimes must not be queued after the DELETE
+    ACE_Guard<ACE_Thread_Mutex> saveGuard(m_respawnSaveLock);
+
+    {
+        ACE_Guard<ACE_Thread_Mutex> guard(m_respawnLock);
+
+        _DiscardPendingRespawnTimes(m_pendingRespawnTimes, instanceId);
+
+        // queued batches still reach the database before the DELETE, but must not be replayed after it
+        for (SavingRespawnTimesList::iterator itr = m_savingRespawnTimes.begin(); itr != m_savingRespawnTimes.end(); ++itr)
+            { _DiscardPendingRespawnTimes(itr->times, instanceId); }
+
+        if (m_respawnJournal)
+        {
+            fprintf(m_respawnJournal, "D %u\n", instanceId);
+            fflush(m_respawnJournal);
+        }
+    }
+
+    CharacterDatabase.BeginTransaction();
+    CharacterDatabase.PExecute("DELETE FROM creature_respawn WHERE instance = '%u'", instanceId);
+    CharacterDatabase.PExecute("DELETE FROM gameobject_respawn WHERE instance = '%u'", instanceId);
+    CharacterDatabase.CommitTransaction();
+}
+
+void MapPersistentStateManager::SaveRespawnTimes()
+{
+    // with no save interval map threads save concurrently, batches must reach the database queue in the order they were taken
+    ACE_Guard<ACE_Thread_Mutex> saveGuard(m_respawnSaveLock);
+
+    PendingRespawnTimes pending[MAX_RESPAWN_TIME_TYPE];
+    uint32 batchId = 0;
+
+    {
+        ACE_Guard<ACE_Thread_Mutex> guard(m_respawnLock);
+
+        bool empty = true;
+        for (int type = 0; type < MAX_RESPAWN_TIME_TYPE; ++type)
+        {
+            if (m_pendingRespawnTimes[type].empty())
+                { continue; }
+            pending[type].swap(m_pendingRespawnTimes[type]);
+            empty = false;
+        }
+
+        if (empty)
+            { return; }
+
+        // the journal keeps the batch until the database has executed it
+        if (m_respawnJournal)
+        {
+            batchId = ++m_respawnBatchId;
+            m_savingRespawnTimes.push_back(SavingRespawnTimes());
+            m_savingRespawnTimes.back().batchId = batchId;
+            for (int type = 0; type < MAX_RESPAWN_TIME_TYPE; ++type)
+                { m_savingRespawnTimes.back().times[type] = pending[type]; }
+        }
+    }
+
+    _SaveRespawnTimes(pending, false);
+
+    // the database thread runs queued statements in order, so this is answered after the batch transaction
+    if (batchId)
+        { CharacterDatabase.AsyncPQuery(this, &MapPersistentStateManager::_RespawnTimesSaved, batchId, "SELECT 1"); }
+}
+
+void MapPersistentStateManager::_RespawnTimesSaved(QueryResult* result, uint32 batchId)
+{
+    delete result;
+
+    ACE_Guard<ACE_Thread_Mutex> guard(m_respawnLock);
+
+    for (SavingRespawnTimesList::iterator itr = m_savingRespawnTimes.begin(); itr != m_savingRespawnTimes.end(); ++itr)
+    {
+        if (itr->batchId == batchId)
+        {
+            m_savingRespawnTimes.erase(itr);
+            break;
+        }
+    }
+
+    _RewriteRespawnTimeJournal();
+}
+
+void MapPersistentStateManager::_RewriteRespawnTimeJournal()
+{
+    if (!m_respawnJournal)
+        { return; }
+
+    m_respawnJournal = freopen(m_respawnJournalName.c_str(), "w", m_respawnJournal);
+    if (!m_respawnJournal)
+    {
+        // old times left in it would override newer ones at the next startup
+        remove(m_respawnJournalName.c_str());
+        sLog.outError("Can not rewrite respawn time journal %s, journal disabled.", m_respawnJournalName.c_str());
+        return;
+    }
+
+    // batches still in the database queue first, in the order they were taken, then times not taken yet
+    for (SavingRespawnTimesList::const_iterator itr = m_savingRespawnTimes.begin(); itr != m_savingRespawnTimes.end(); ++itr)
+    {
+        for (int type = 0; type < MAX_RESPAWN_TIME_TYPE; ++type)
+            for (PendingRespawnTimes::const_iterator time = itr->times[type].begin(); time != itr->times[type].end(); ++time)
+                { fprintf(m_respawnJournal, "%c %u %u " UI64FMTD "\n", respawnTimeJournalTypes[type], time->first.first, time->first.second, uint64(time->second)); }
+    }
+
+    for (int type = 0; type < MAX_RESPAWN_TIME_TYPE; ++type)
+        for (PendingRespawnTimes::const_iterator time = m_pendingRespawnTimes[type].begin(); time != m_pendingRespawnTimes[type].end(); ++time)
+            { fprintf(m_respawnJournal, "%c %u %u " UI64FMTD "\n", respawnTimeJournalTypes[type], time->first.first, time->first.second, uint64(time->second)); }
+
+    fflush(m_respawnJournal);
+}
+
+void MapPersistentStateManager::LoadRespawnTimeJournal()
+{
+    m_respawnJournalName = sConfig.GetStringDefault("SaveRespawnTimeJournal", "");
+    if (m_respawnJournalName.empty())
+        { return; }
+
+    PendingRespawnTimes pending[MAX_RESPAWN_TIME_TYPE];
+    uint32 count = 0;
+
+    if (FILE* journal = fopen(m_respawnJournalName.c_str(), "r"))
+    {
+        char line[64];
+        while (fgets(line, sizeof(line), journal))
+        {
+            char type;
+            uint32 instanceId, loguid;
+            uint64 respawnTime;
+
+            if (sscanf(line, "D %u", &instanceId) == 1)
+            {
+                _DiscardPendingRespawnTimes(pending, instanceId);
+                continue;
+            }
+
+            if (sscanf(line, "%c %u %u " UI64FMTD, &type, &instanceId, &loguid, &respawnTime) != 4)
+                { continue; }
+
+            for (int i = 0; i < MAX_RESPAWN_TIME_TYPE; ++i)
+            {
+                if (respawnTimeJournalTypes[i] != type)
+                    { continue; }
+
+                pending[i][std::make_pair(instanceId, loguid)] = time_t(respawnTime);
+                ++count;
+            }
+        }
+
+        fclose(journal);
+    }
+
+    // must be in the tables before CleanupInstances and the respawn time loading
+    _SaveRespawnTimes(pending, true);
+
+    m_respawnJournal = fopen(m_respawnJournalName.c_str(), "w");
+    if (!m_respawnJournal)
+        { sLog.outError("Can not open respawn time journal %s, respawn times are only kept in memory until saved.", m_respawnJournalName.c_str()); }
+
+    sLog.outString(">> Recovered %u respawn times from journal %s", count, m_respawnJournalName.c_str());
+    sLog.outString();
+}
+
+void MapPersistentStateManager::_SaveRespawnTimes(PendingRespawnTimes* pending, bool direct)
+{
+    time_t now = sWorld.GetGameTime();
+
+    std::vector<std::string> deletes;
+    std::vector<std::string> inserts;
+
+    for (int type = 0; type < MAX_RESPAWN_TIME_TYPE; ++type)
+    {
+        std::ostringstream del;
+        std::ostringstream ins;
+        uint32 delCount = 0;
+        uint32 insCount = 0;
+        uint32 delInstanceId = 0;
+
+        // sorted by instance, so each instance gets a single IN list (split at the batch size)
+        for (PendingRespawnTimes::const_iterator itr = pending[type].begin(); itr != pending[type].end(); ++itr)
+        {
+            uint32 instanceId = itr->first.first;
+            uint32 loguid = itr->first.second;
+
+            if (delCount && (delInstanceId != instanceId || delCount >= RESPAWN_TIME_SAVE_BATCH))
+            {
+                del << ")";
+                deletes.push_back(del.str());
+                del.str("");
+                delCount = 0;
+            }
+
+            if (!delCount)
+            {
+                del << "DELETE FROM " << respawnTimeTables[type] << " WHERE instance = " << instanceId << " AND guid IN (" << loguid;
+                delInstanceId = instanceId;
+            }
+            else
+                { del << "," << loguid; }
+            ++delCount;
+
+            // expired respawn times only need the delete
+            if (itr->second <= now)
+                { continue; }
+
+            if (!insCount)
+                { ins << "INSERT INTO " << respawnTimeTables[type] << " VALUES "; }
+            else
+                { ins << ","; }
+            ins << "(" << loguid << "," << uint64(itr->second) << "," << instanceId << ")";
+
+            if (++insCount >= RESPAWN_TIME_SAVE_BATCH)
+            {
+                inserts.push_back(ins.str());
+                ins.str("");
+                insCount = 0;
+            }
+        }
+
+        if (delCount)
+        {
+            del << ")";
+            deletes.push_back(del.str());
+        }
+
+        if (insCount)
+            { inserts.push_back(ins.str()); }
+    }
+
+    if (deletes.empty())
+        { return; }
+
+    // all deletes first, an insert may belong to a delete batched later
+    std::vector<std::string>& statements = deletes;
+    statements.insert(statements.end(), inserts.begin(), inserts.end());
+
+    if (direct)
+    {
+        for (std::vector<std::string>::const_iterator itr = statements.begin(); itr != statements.end(); ++itr)
+            { CharacterDatabase.DirectExecute(itr->c_str()); }
+        return;
+    }
+
+    CharacterDatabase.BeginTransaction();
+    for (std::vector<std::string>::const_iterator itr = statements.begin(); itr != statements.end(); ++itr)
+        { CharacterDatabase.Execute(itr->c_str()); }
+    CharacterDatabase.CommitTransaction();
+}
+
+void MapPersistentStateManager::_DiscardPendingRespawnTimes(PendingRespawnTimes* pending, uint32 instanceId)
+{
+    for (int type = 0; type < MAX_RESPAWN_TIME_TYPE; ++type)
+    {
+        PendingRespawnTimes& times = pending[type];
+        times.erase(times.lower_bound(std::make_pair(instanceId, uint32(0))), times.upper_bound(std::make_pair(instanceId, uint32(0xFFFFFFFF))));
+    }
+}
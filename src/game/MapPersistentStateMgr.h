@@ -37,6 +37,7 @@
 #include "DBCStores.h"
 #include "ObjectGuid.h"
 #include "PoolManager.h"
+#include "Timer.h"
 
 struct InstanceTemplate;
 struct MapEntry;
@@ -267,6 +268,15 @@ enum ResetEventType
 
 #define MAX_RESET_EVENT_TYPE   5
 
+// respawn time tables, also index of pending saves in MapPersistentStateManager
+enum RespawnTimeType
+{
+    RESPAWN_TIME_CREATURE   = 0,                            // `creature_respawn`
+    RESPAWN_TIME_GAMEOBJECT = 1,                            // `gameobject_respawn`
+};
+
+#define MAX_RESPAWN_TIME_TYPE  2
+
 /* resetTime is a global propery of each (raid/heroic) map
     all instances of that map reset at the same time */
 struct DungeonResetEvent
@@ -350,9 +360,28 @@ class MANGOS_DLL_DECL MapPersistentStateManager : public MaNGOS::Singleton<MapPe
 
         void GetStatistics(uint32& numStates, uint32& numBoundPlayers, uint32& numBoundGroups);
 
-        void Update() { m_Scheduler.Update(); }
+        void Update(uint32 diff);
+
+    public:                                                 // respawn time saving
+        // respawn times are collected and written in batches every SaveRespawnTimeInterval, can be called from map threads
+        void ScheduleRespawnTimeSave(RespawnTimeType type, uint32 instanceId, uint32 loguid, time_t t);
+        // forget not yet written respawn times of an instance and delete its rows, queued after any batch already taken
+        void DeleteInstanceRespawnTimes(uint32 instanceId);
+        // write all collected respawn times, used by timer and at shutdown
+        void SaveRespawnTimes();
+        // write respawn times left in the journal file by an unclean shutdown, must be called before CleanupInstances
+        void LoadRespawnTimeJournal();
     private:
         typedef UNORDERED_MAP < uint32 /*InstanceId or MapId*/, MapPersistentState* > PersistentStateMap;
+        typedef std::map < std::pair < uint32 /*InstanceId*/, uint32 /*guid*/ >, time_t /*respawn time*/ > PendingRespawnTimes;
+
+        // batch handed to the database queue, kept in the journal until it is executed
+        struct SavingRespawnTimes
+        {
+            uint32 batchId;
+            PendingRespawnTimes times[MAX_RESPAWN_TIME_TYPE];
+        };
+        typedef std::list<SavingRespawnTimes> SavingRespawnTimesList;
 
         //  called by scheduler for DungeonPersistentStates
         void _ResetOrWarnAll(uint32 mapid, bool warn, uint32 timeleft);
@@ -361,6 +390,11 @@ class MANGOS_DLL_DECL MapPersistentStateManager : public MaNGOS::Singleton<MapPe
 
         void _ResetSave(PersistentStateMap& holder, PersistentStateMap::iterator& itr);
         void _DelHelper(DatabaseType& db, const char* fields, const char* table, const char* queryTail, ...);
+        void _SaveRespawnTimes(PendingRespawnTimes* pending, bool direct);
+        void _DiscardPendingRespawnTimes(PendingRespawnTimes* pending, uint32 instanceId);
+        // async query callback, queued behind the transaction of a batch
+        void _RespawnTimesSaved(QueryResult* result, uint32 batchId);
+        void _RewriteRespawnTimeJournal();
 
         // used during global instance resets
         bool lock_instLists;
@@ -370,6 +404,19 @@ class MANGOS_DLL_DECL MapPersistentStateManager : public MaNGOS::Singleton<MapPe
         PersistentStateMap m_instanceSaveByMapId;
 
         DungeonResetScheduler m_Scheduler;
+
+        // respawn times waiting for the next batched save, guarded by m_respawnLock
+        PendingRespawnTimes m_pendingRespawnTimes[MAX_RESPAWN_TIME_TYPE];
+        ACE_Thread_Mutex m_respawnLock;
+        // held from taking respawn times until their SQL is queued, taken before m_respawnLock
+        ACE_Thread_Mutex m_respawnSaveLock;
+        ShortIntervalTimer m_respawnSaveTimer;
+        // optional append-only copy of m_savingRespawnTimes and m_pendingRespawnTimes,
+        // rewritten without a batch once the database executed it
+        std::string m_respawnJournalName;
+        FILE* m_respawnJournal;
+        SavingRespawnTimesList m_savingRespawnTimes;        // guarded by m_respawnLock, only with a journal
+        uint32 m_respawnBatchId;
 };
 
 template<typename Do>
@@ -438,6 +438,9 @@ void MotionMaster::MoveFlyOrLand(uint32 id, float x, float y, float z, bool lift
 
 void MotionMaster::Mutate(MovementGenerator* m)
 {
+    if (m_owner->GetTypeId() == TYPEID_UNIT)
+        { ((Creature*)m_owner)->WakeUp(); }
+
     if (!empty())
     {
         switch (top()->GetMovementGeneratorType())
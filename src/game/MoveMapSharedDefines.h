@@ -28,6 +28,8 @@
 #include "../recastnavigation/Detour/Include/DetourNavMesh.h"
 #include "Platform/Define.h"
 
+#include <cstring>
+
 #define MMAP_MAGIC 0x4d4d4150   // 'MMAP'
 #define MMAP_VERSION 4
 
@@ -39,8 +41,15 @@ struct MmapTileHeader
     uint32 size;
     bool usesLiquids : 1;
 
-    MmapTileHeader() : mmapMagic(MMAP_MAGIC), dtVersion(DT_NAVMESH_VERSION),
-        mmapVersion(MMAP_VERSION), size(0), usesLiquids(true) {}
+    MmapTileHeader()
+    {
+        // the header is written as is, do not leave the bits next to usesLiquids undefined
+        memset(this, 0, sizeof(*this));
+        mmapMagic = MMAP_MAGIC;
+        dtVersion = DT_NAVMESH_VERSION;
+        mmapVersion = MMAP_VERSION;
+        usesLiquids = true;
+    }
 };
 
 enum NavTerrain
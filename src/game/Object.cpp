@@ -88,7 +88,7 @@ void Object::_InitValues()
     m_uint32Values = new uint32[ m_valuesCount ];
     memset(m_uint32Values, 0, m_valuesCount * sizeof(uint32));
 
-    m_changedValues.resize(m_valuesCount, false);
+    m_changedValues.SetCount(m_valuesCount);
 
     m_objectUpdated = false;
 }
@@ -123,8 +123,7 @@ void Object::SendForcedObjectUpdate()
     for (UpdateDataMapType::iterator iter = update_players.begin(); iter != update_players.end(); ++iter)
     {
         iter->second.BuildPacket(&packet);
-        iter->first->GetSession()->SendPacket(&packet);
-        packet.clear();                                     // clean the string
+        iter->first->GetSession()->SendOwnedPacket(packet);  // leaves packet empty
     }
 }
 
@@ -206,11 +205,18 @@ void Object::SendCreateUpdateToPlayer(Player* player)
 
     BuildCreateUpdateBlockForPlayer(&upd, player);
     upd.BuildPacket(&packet);
-    player->GetSession()->SendPacket(&packet);
+    player->GetSession()->SendOwnedPacket(packet);
 }
 
-void Object::BuildValuesUpdateBlockForPlayer(UpdateData* data, Player* target) const
+void Object::BuildValuesUpdateBlockForPlayer(UpdateData* data, Player* target, UpdateValuesCache* cache) const
 {
+    UpdateViewerClass viewer = cache ? GetUpdateViewerClass(target) : UPDATE_VIEWER_TARGET;
+    if (viewer != UPDATE_VIEWER_TARGET && cache->blocks[viewer])
+    {
+        data->AddUpdateBlock(*cache->blocks[viewer]);
+        return;
+    }
+
     ByteBuffer buf(500);
 
     buf << uint8(UPDATETYPE_VALUES);
@@ -223,6 +229,39 @@ void Object::BuildValuesUpdateBlockForPlayer(UpdateData* data, Player* target) c
     BuildValuesUpdate(UPDATETYPE_VALUES, &buf, &updateMask, target);
 
     data->AddUpdateBlock(buf);
+
+    if (viewer != UPDATE_VIEWER_TARGET)
+        { cache->blocks[viewer] = new ByteBuffer(buf); }
+}
+
+UpdateViewerClass Object::GetUpdateViewerClass(Player* target) const
+{
+    if (target == this)
+        { return UPDATE_VIEWER_SELF; }
+
+    switch (GetTypeId())
+    {
+        case TYPEID_GAMEOBJECT:
+            // dynamic flags are always sent and depend on the quests of the target
+            if (!((GameObject*)this)->IsTransport())
+                { return UPDATE_VIEWER_TARGET; }
+            break;
+        case TYPEID_UNIT:
+            // loot and tap state of the target
+            if (m_changedValues.GetBit(UNIT_DYNAMIC_FLAGS))
+                { return UPDATE_VIEWER_TARGET; }
+            // trainer and stable master flags depend on the class of the target
+            if (m_changedValues.GetBit(UNIT_NPC_FLAGS) && (m_uint32Values[UNIT_NPC_FLAGS] & (UNIT_NPC_FLAG_TRAINER | UNIT_NPC_FLAG_STABLEMASTER)))
+                { return UPDATE_VIEWER_TARGET; }
+            break;
+        default:
+            break;
+    }
+
+    if (isType(TYPEMASK_UNIT) && target->isGameMaster())
+        { return UPDATE_VIEWER_GAMEMASTER; }
+
+    return UPDATE_VIEWER_OTHER;
 }
 
 void Object::BuildOutOfRangeUpdateBlock(UpdateData* data) const
@@ -373,149 +412,136 @@ void Object::BuildValuesUpdate(uint8 updatetype, ByteBuffer* data, UpdateMask* u
     // 2 specialized loops for speed optimization in non-unit case
     if (isType(TYPEMASK_UNIT))                              // unit (creature/player) case
     {
-        for (uint16 index = 0; index < m_valuesCount; ++index)
+        for (uint32 index = updateMask->GetNextSetBit(0); index < m_valuesCount; index = updateMask->GetNextSetBit(index + 1))
         {
-            if (updateMask->GetBit(index))
+            if (index == UNIT_NPC_FLAGS)
             {
-                if (index == UNIT_NPC_FLAGS)
+                uint32 appendValue = m_uint32Values[index];
+
+                if (GetTypeId() == TYPEID_UNIT)
                 {
-                    uint32 appendValue = m_uint32Values[index];
+                    if (appendValue & UNIT_NPC_FLAG_TRAINER)
+                    {
+                        if (!((Creature*)this)->IsTrainerOf(target, false))
+                            { appendValue &= ~UNIT_NPC_FLAG_TRAINER; }
+                    }
 
-                    if (GetTypeId() == TYPEID_UNIT)
+                    if (appendValue & UNIT_NPC_FLAG_STABLEMASTER)
                     {
-                        if (appendValue & UNIT_NPC_FLAG_TRAINER)
-                        {
-                            if (!((Creature*)this)->IsTrainerOf(target, false))
-                                { appendValue &= ~UNIT_NPC_FLAG_TRAINER; }
-                        }
+                        if (target->getClass() != CLASS_HUNTER)
+                            { appendValue &= ~UNIT_NPC_FLAG_STABLEMASTER; }
+                    }
+                }
 
-                        if (appendValue & UNIT_NPC_FLAG_STABLEMASTER)
+                *data << uint32(appendValue);
+            }
+            // FIXME: Some values at server stored in float format but must be sent to client in uint32 format
+            else if (index >= UNIT_FIELD_BASEATTACKTIME && index <= UNIT_FIELD_RANGEDATTACKTIME)
+            {
+                // convert from float to uint32 and send
+                *data << uint32(m_floatValues[index] < 0 ? 0 : m_floatValues[index]);
+            }
+
+            // there are some float values which may be negative or can't get negative due to other checks
+            else if ((index >= PLAYER_FIELD_NEGSTAT0    && index <= PLAYER_FIELD_NEGSTAT4) ||
+                     (index >= PLAYER_FIELD_RESISTANCEBUFFMODSPOSITIVE  && index <= (PLAYER_FIELD_RESISTANCEBUFFMODSPOSITIVE + 6)) ||
+                     (index >= PLAYER_FIELD_RESISTANCEBUFFMODSNEGATIVE  && index <= (PLAYER_FIELD_RESISTANCEBUFFMODSNEGATIVE + 6)) ||
+                     (index >= PLAYER_FIELD_POSSTAT0    && index <= PLAYER_FIELD_POSSTAT4))
+            {
+                *data << uint32(m_floatValues[index]);
+            }
+
+            // Gamemasters should be always able to select units - remove not selectable flag
+            else if (index == UNIT_FIELD_FLAGS && target->isGameMaster())
+            {
+                *data << (m_uint32Values[index] & ~UNIT_FLAG_NOT_SELECTABLE);
+            }
+            /* Hide loot animation for players that aren't permitted to loot the corpse */
+            else if (index == UNIT_DYNAMIC_FLAGS && GetTypeId() == TYPEID_UNIT)
+            {
+                uint32 send_value = m_uint32Values[index];
+
+                /* Initiate pointer to creature so we can check loot */
+                if (Creature* my_creature = (Creature*)this)
+                    /* If the creature is NOT fully looted */
+                    if (!my_creature->loot.isLooted())
+                        /* If the lootable flag is NOT set */
+                        if (!(send_value & UNIT_DYNFLAG_LOOTABLE))
                         {
-                            if (target->getClass() != CLASS_HUNTER)
-                                { appendValue &= ~UNIT_NPC_FLAG_STABLEMASTER; }
+                            /* Update it on the creature */
+                            my_creature->SetFlag(UNIT_DYNAMIC_FLAGS, UNIT_DYNFLAG_LOOTABLE);
+                            /* Update it in the packet */
+                            send_value = send_value | UNIT_DYNFLAG_LOOTABLE;
                         }
-                    }
 
-                    *data << uint32(appendValue);
-                }
-                // FIXME: Some values at server stored in float format but must be sent to client in uint32 format
-                else if (index >= UNIT_FIELD_BASEATTACKTIME && index <= UNIT_FIELD_RANGEDATTACKTIME)
-                {
-                    // convert from float to uint32 and send
-                    *data << uint32(m_floatValues[index] < 0 ? 0 : m_floatValues[index]);
-                }
+                /* If we're not allowed to loot the target, destroy the lootable flag */
+                if (!target->isAllowedToLoot((Creature*)this))
+                    if (send_value & UNIT_DYNFLAG_LOOTABLE)
+                        { send_value = send_value & ~UNIT_DYNFLAG_LOOTABLE; }
 
-                // there are some float values which may be negative or can't get negative due to other checks
-                else if ((index >= PLAYER_FIELD_NEGSTAT0    && index <= PLAYER_FIELD_NEGSTAT4) ||
-                         (index >= PLAYER_FIELD_RESISTANCEBUFFMODSPOSITIVE  && index <= (PLAYER_FIELD_RESISTANCEBUFFMODSPOSITIVE + 6)) ||
-                         (index >= PLAYER_FIELD_RESISTANCEBUFFMODSNEGATIVE  && index <= (PLAYER_FIELD_RESISTANCEBUFFMODSNEGATIVE + 6)) ||
-                         (index >= PLAYER_FIELD_POSSTAT0    && index <= PLAYER_FIELD_POSSTAT4))
-                {
-                    *data << uint32(m_floatValues[index]);
-                }
+                /* If we are allowed to loot it and mob is tapped by us, destroy the tapped flag */
+                bool is_tapped = target->IsTappedByMeOrMyGroup((Creature*)this);
 
-                // Gamemasters should be always able to select units - remove not selectable flag
-                else if (index == UNIT_FIELD_FLAGS && target->isGameMaster())
-                {
-                    *data << (m_uint32Values[index] & ~UNIT_FLAG_NOT_SELECTABLE);
-                }
-                /* Hide loot animation for players that aren't permitted to loot the corpse */
-                else if (index == UNIT_DYNAMIC_FLAGS && GetTypeId() == TYPEID_UNIT)
-                {
-                    uint32 send_value = m_uint32Values[index];
-
-                    /* Initiate pointer to creature so we can check loot */
-                    if (Creature* my_creature = (Creature*)this)
-                        /* If the creature is NOT fully looted */
-                        if (!my_creature->loot.isLooted())
-                            /* If the lootable flag is NOT set */
-                            if (!(send_value & UNIT_DYNFLAG_LOOTABLE))
-                            {
-                                /* Update it on the creature */
-                                my_creature->SetFlag(UNIT_DYNAMIC_FLAGS, UNIT_DYNFLAG_LOOTABLE);
-                                /* Update it in the packet */
-                                send_value = send_value | UNIT_DYNFLAG_LOOTABLE;
-                            }
-
-                    /* If we're not allowed to loot the target, destroy the lootable flag */
-                    if (!target->isAllowedToLoot((Creature*)this))
-                        if (send_value & UNIT_DYNFLAG_LOOTABLE)
-                            { send_value = send_value & ~UNIT_DYNFLAG_LOOTABLE; }
-
-                    /* If we are allowed to loot it and mob is tapped by us, destroy the tapped flag */
-                    bool is_tapped = target->IsTappedByMeOrMyGroup((Creature*)this);
-
-                    /* If the creature has tapped flag but is tapped by us, remove the flag */
-                    if (send_value & UNIT_DYNFLAG_TAPPED && is_tapped)
-                        { send_value = send_value & ~UNIT_DYNFLAG_TAPPED; }
-                    /* If creature does not have tapped flag but is not tapped by us, set the flag */
-                    else if (!(send_value & UNIT_DYNFLAG_TAPPED) && !is_tapped)
-                        { send_value = send_value | UNIT_DYNFLAG_TAPPED; }
-
-                    *data << send_value;
-                }
-                else
-                {
-                    // send in current format (float as float, uint32 as uint32)
-                    *data << m_uint32Values[index];
-                }
+                /* If the creature has tapped flag but is tapped by us, remove the flag */
+                if (send_value & UNIT_DYNFLAG_TAPPED && is_tapped)
+                    { send_value = send_value & ~UNIT_DYNFLAG_TAPPED; }
+                /* If creature does not have tapped flag but is not tapped by us, set the flag */
+                else if (!(send_value & UNIT_DYNFLAG_TAPPED) && !is_tapped)
+                    { send_value = send_value | UNIT_DYNFLAG_TAPPED; }
+
+                *data << send_value;
+            }
+            else
+            {
+                // send in current format (float as float, uint32 as uint32)
+                *data << m_uint32Values[index];
             }
         }
     }
     else if (isType(TYPEMASK_GAMEOBJECT))                   // gameobject case
     {
-        for (uint16 index = 0; index < m_valuesCount; ++index)
+        for (uint32 index = updateMask->GetNextSetBit(0); index < m_valuesCount; index = updateMask->GetNextSetBit(index + 1))
         {
-            if (updateMask->GetBit(index))
+            // send in current format (float as float, uint32 as uint32)
+            if (index == GAMEOBJECT_DYN_FLAGS)
             {
-                // send in current format (float as float, uint32 as uint32)
-                if (index == GAMEOBJECT_DYN_FLAGS)
+                if (IsActivateToQuest)
                 {
-                    if (IsActivateToQuest)
+                    switch (((GameObject*)this)->GetGoType())
                     {
-                        switch (((GameObject*)this)->GetGoType())
-                        {
-                            case GAMEOBJECT_TYPE_QUESTGIVER:
-                            case GAMEOBJECT_TYPE_CHEST:
-                            case GAMEOBJECT_TYPE_GENERIC:
-                            case GAMEOBJECT_TYPE_SPELL_FOCUS:
-                            case GAMEOBJECT_TYPE_GOOBER:
-                                *data << uint16(GO_DYNFLAG_LO_ACTIVATE);
-                                *data << uint16(0);
-                                break;
-                            default:
-                                *data << uint32(0);         // unknown, not happen.
-                                break;
-                        }
+                        case GAMEOBJECT_TYPE_QUESTGIVER:
+                        case GAMEOBJECT_TYPE_CHEST:
+                        case GAMEOBJECT_TYPE_GENERIC:
+                        case GAMEOBJECT_TYPE_SPELL_FOCUS:
+                        case GAMEOBJECT_TYPE_GOOBER:
+                            *data << uint16(GO_DYNFLAG_LO_ACTIVATE);
+                            *data << uint16(0);
+                            break;
+                        default:
+                            *data << uint32(0);         // unknown, not happen.
+                            break;
                     }
-                    else
-                        { *data << uint32(0); }                 // disable quest object
                 }
                 else
-                    { *data << m_uint32Values[index]; }         // other cases
+                    { *data << uint32(0); }                 // disable quest object
             }
+            else
+                { *data << m_uint32Values[index]; }         // other cases
         }
     }
     else                                                    // other objects case (no special index checks)
     {
-        for (uint16 index = 0; index < m_valuesCount; ++index)
+        for (uint32 index = updateMask->GetNextSetBit(0); index < m_valuesCount; index = updateMask->GetNextSetBit(index + 1))
         {
-            if (updateMask->GetBit(index))
-            {
-                // send in current format (float as float, uint32 as uint32)
-                *data << m_uint32Values[index];
-            }
+            // send in current format (float as float, uint32 as uint32)
+            *data << m_uint32Values[index];
         }
     }
 }
 
 void Object::ClearUpdateMask(bool remove)
 {
-    if (m_uint32Values)
-    {
-        for (uint16 index = 0; index < m_valuesCount; ++index)
-            { m_changedValues[index] = false; }
-    }
+    m_changedValues.Clear();
 
     if (m_objectUpdated)
     {
@@ -546,16 +572,23 @@ bool Object::LoadValues(const char* data)
 
 void Object::_SetUpdateBits(UpdateMask* updateMask, Player* /*target*/) const
 {
-    for (uint16 index = 0; index < m_valuesCount; ++index)
-        if (m_changedValues[index])
-            { updateMask->SetBit(index); }
+    *updateMask |= m_changedValues;
 }
 
 void Object::_SetCreateBits(UpdateMask* updateMask, Player* /*target*/) const
 {
-    for (uint16 index = 0; index < m_valuesCount; ++index)
-        if (GetUInt32Value(index) != 0)
-            { updateMask->SetBit(index); }
+    // build the mask a block at a time, without a branch per field
+    for (uint32 block = 0; block < updateMask->GetBlockCount(); ++block)
+    {
+        uint32 first = block << 5;
+        uint32 last = std::min(first + 32, uint32(m_valuesCount));
+
+        uint32 bits = 0;
+        for (uint32 index = first; index < last; ++index)
+            { bits |= uint32(m_uint32Values[index] != 0) << (index - first); }
+
+        updateMask->SetBlock(block, bits | updateMask->GetBlock(block));
+    }
 }
 
 void Object::SetInt32Value(uint16 index, int32 value)
@@ -565,7 +598,7 @@ void Object::SetInt32Value(uint16 index, int32 value)
     if (m_int32Values[index] != value)
     {
         m_int32Values[index] = value;
-        m_changedValues[index] = true;
+        m_changedValues.SetBit(index);
         MarkForClientUpdate();
     }
 }
@@ -577,7 +610,7 @@ void Object::SetUInt32Value(uint16 index, uint32 value)
     if (m_uint32Values[index] != value)
     {
         m_uint32Values[index] = value;
-        m_changedValues[index] = true;
+        m_changedValues.SetBit(index);
         MarkForClientUpdate();
     }
 }
@@ -587,7 +620,7 @@ void Object::UpdateUInt32Value(uint16 index, uint32 value)
     MANGOS_ASSERT(index < m_valuesCount || PrintIndexError(index, true));
 
     m_uint32Values[index] = value;
-    m_changedValues[index] = true;
+    m_changedValues.SetBit(index);
 }
 
 void Object::SetUInt64Value(uint16 index, const uint64& value)
@@ -597,8 +630,8 @@ void Object::SetUInt64Value(uint16 index, const uint64& value)
     {
         m_uint32Values[index] = *((uint32*)&value);
         m_uint32Values[index + 1] = *(((uint32*)&value) + 1);
-        m_changedValues[index] = true;
-        m_changedValues[index + 1] = true;
+        m_changedValues.SetBit(index);
+        m_changedValues.SetBit(index + 1);
         MarkForClientUpdate();
     }
 }
@@ -610,7 +643,7 @@ void Object::SetFloatValue(uint16 index, float value)
     if (m_floatValues[index] != value)
     {
         m_floatValues[index] = value;
-        m_changedValues[index] = true;
+        m_changedValues.SetBit(index);
         MarkForClientUpdate();
     }
 }
@@ -629,7 +662,7 @@ void Object::SetByteValue(uint16 index, uint8 offset, uint8 value)
     {
         m_uint32Values[index] &= ~uint32(uint32(0xFF) << (offset * 8));
         m_uint32Values[index] |= uint32(uint32(value) << (offset * 8));
-        m_changedValues[index] = true;
+        m_changedValues.SetBit(index);
         MarkForClientUpdate();
     }
 }
@@ -648,7 +681,7 @@ void Object::SetUInt16Value(uint16 index, uint8 offset, uint16 value)
     {
         m_uint32Values[index] &= ~uint32(uint32(0xFFFF) << (offset * 16));
         m_uint32Values[index] |= uint32(uint32(value) << (offset * 16));
-        m_changedValues[index] = true;
+        m_changedValues.SetBit(index);
         MarkForClientUpdate();
     }
 }
@@ -710,7 +743,7 @@ void Object::SetFlag(uint16 index, uint32 newFlag)
     if (oldval != newval)
     {
         m_uint32Values[index] = newval;
-        m_changedValues[index] = true;
+        m_changedValues.SetBit(index);
         MarkForClientUpdate();
     }
 }
@@ -724,7 +757,7 @@ void Object::RemoveFlag(uint16 index, uint32 oldFlag)
     if (oldval != newval)
     {
         m_uint32Values[index] = newval;
-        m_changedValues[index] = true;
+        m_changedValues.SetBit(index);
         MarkForClientUpdate();
     }
 }
@@ -798,7 +831,7 @@ void Object::SetByteFlag(uint16 index, uint8 offset, uint8 newFlag)
     if (!(uint8(m_uint32Values[index] >> (offset * 8)) & newFlag))
     {
         m_uint32Values[index] |= uint32(uint32(newFlag) << (offset * 8));
-        m_changedValues[index] = true;
+        m_changedValues.SetBit(index);
         MarkForClientUpdate();
     }
 }
@@ -816,7 +849,7 @@ void Object::RemoveByteFlag(uint16 index, uint8 offset, uint8 oldFlag)
     if (uint8(m_uint32Values[index] >> (offset * 8)) & oldFlag)
     {
         m_uint32Values[index] &= ~uint32(uint32(oldFlag) << (offset * 8));
-        m_changedValues[index] = true;
+        m_changedValues.SetBit(index);
         MarkForClientUpdate();
     }
 }
@@ -828,7 +861,7 @@ void Object::SetShortFlag(uint16 index, bool highpart, uint16 newFlag)
     if (!(uint16(m_uint32Values[index] >> (highpart ? 16 : 0)) & newFlag))
     {
         m_uint32Values[index] |= uint32(uint32(newFlag) << (highpart ? 16 : 0));
-        m_changedValues[index] = true;
+        m_changedValues.SetBit(index);
         MarkForClientUpdate();
     }
 }
@@ -840,7 +873,7 @@ void Object::RemoveShortFlag(uint16 index, bool highpart, uint16 oldFlag)
     if (uint16(m_uint32Values[index] >> (highpart ? 16 : 0)) & oldFlag)
     {
         m_uint32Values[index] &= ~uint32(uint32(oldFlag) << (highpart ? 16 : 0));
-        m_changedValues[index] = true;
+        m_changedValues.SetBit(index);
         MarkForClientUpdate();
     }
 }
@@ -862,7 +895,7 @@ bool Object::PrintEntryError(char const* descr) const
 }
 
 
-void Object::BuildUpdateDataForPlayer(Player* pl, UpdateDataMapType& update_players)
+void Object::BuildUpdateDataForPlayer(Player* pl, UpdateDataMapType& update_players, UpdateValuesCache* cache)
 {
     UpdateDataMapType::iterator iter = update_players.find(pl);
 
@@ -873,7 +906,7 @@ void Object::BuildUpdateDataForPlayer(Player* pl, UpdateDataMapType& update_play
         iter = p.first;
     }
 
-    BuildValuesUpdateBlockForPlayer(&iter->second, iter->first);
+    BuildValuesUpdateBlockForPlayer(&iter->second, iter->first, cache);
 }
 
 void Object::AddToClientUpdateList()
@@ -1834,6 +1867,7 @@ struct WorldObjectChangeAccumulator
 {
     UpdateDataMapType& i_updateDatas;
     WorldObject& i_object;
+    UpdateValuesCache i_cache;                              // viewers of the same class get the same values block
     WorldObjectChangeAccumulator(WorldObject& obj, UpdateDataMapType& d) : i_updateDatas(d), i_object(obj)
     {
         // send self fields changes in another way, otherwise
@@ -1848,7 +1882,7 @@ struct WorldObjectChangeAccumulator
         {
             Player* owner = iter->getSource()->GetOwner();
             if (owner != &i_object && owner->HaveAtClient(&i_object))
-                { i_object.BuildUpdateDataForPlayer(owner, i_updateDatas); }
+                { i_object.BuildUpdateDataForPlayer(owner, i_updateDatas, &i_cache); }
         }
     }
 
@@ -29,6 +29,7 @@
 #include "ByteBuffer.h"
 #include "UpdateFields.h"
 #include "UpdateData.h"
+#include "UpdateMask.h"
 #include "ObjectGuid.h"
 #include "Camera.h"
 
@@ -81,6 +82,35 @@ struct MangosStringLocale;
 
 typedef UNORDERED_MAP<Player*, UpdateData> UpdateDataMapType;
 
+// what the values update of an object depends on for a given target
+enum UpdateViewerClass
+{
+    UPDATE_VIEWER_SELF          = 0,                        // the object is the target itself, all fields visible
+    UPDATE_VIEWER_OTHER         = 1,
+    UPDATE_VIEWER_GAMEMASTER    = 2,                        // units are always selectable for gamemasters
+    UPDATE_VIEWER_TARGET        = 3,                        // depends on the target itself (loot, quests, trainer), never cached
+};
+
+#define MAX_CACHED_UPDATE_VIEWER    3
+
+// values update blocks already built while sending one object's changes to all its viewers
+struct UpdateValuesCache
+{
+    UpdateValuesCache()
+    {
+        for (int i = 0; i < MAX_CACHED_UPDATE_VIEWER; ++i)
+            { blocks[i] = NULL; }
+    }
+
+    ~UpdateValuesCache()
+    {
+        for (int i = 0; i < MAX_CACHED_UPDATE_VIEWER; ++i)
+            { delete blocks[i]; }
+    }
+
+    ByteBuffer* blocks[MAX_CACHED_UPDATE_VIEWER];
+};
+
 struct Position
 {
     Position() : x(0.0f), y(0.0f), z(0.0f), o(0.0f) {}
@@ -174,7 +204,7 @@ class MANGOS_DLL_SPEC Object
         void MarkForClientUpdate();
         void SendForcedObjectUpdate();
 
-        void BuildValuesUpdateBlockForPlayer(UpdateData* data, Player* target) const;
+        void BuildValuesUpdateBlockForPlayer(UpdateData* data, Player* target, UpdateValuesCache* cache = NULL) const;
         void BuildOutOfRangeUpdateBlock(UpdateData* data) const;
         void BuildMovementUpdateBlock(UpdateData* data, uint8 flags = 0) const;
 
@@ -406,7 +436,8 @@ class MANGOS_DLL_SPEC Object
 
         void BuildMovementUpdate(ByteBuffer* data, uint8 updateFlags) const;
         void BuildValuesUpdate(uint8 updatetype, ByteBuffer* data, UpdateMask* updateMask, Player* target) const;
-        void BuildUpdateDataForPlayer(Player* pl, UpdateDataMapType& update_players);
+        void BuildUpdateDataForPlayer(Player* pl, UpdateDataMapType& update_players, UpdateValuesCache* cache = NULL);
+        UpdateViewerClass GetUpdateViewerClass(Player* target) const;
 
         uint16 m_objectType;
 
@@ -420,7 +451,7 @@ class MANGOS_DLL_SPEC Object
             float*  m_floatValues;
         };
 
-        std::vector<bool> m_changedValues;
+        UpdateMask m_changedValues;                         // changed fields, in the layout of the update packet mask
         std::map<uint32, uint32> m_plrSpecificFlags;
 
         uint16 m_valuesCount;
@@ -136,6 +136,7 @@ ObjectMgr::ObjectMgr() :
     m_GroupIds("Group ids"),
     m_FirstTemporaryCreatureGuid(1),
     m_FirstTemporaryGameObjectGuid(1),
+    m_CharacterNamesLoaded(false),
     DBCLocaleIndex(LOCALE_enUS)
 {
 }
@@ -591,8 +592,10 @@ void ObjectMgr::LoadCreatureTemplates()
     }
 }
 
-void ObjectMgr::ConvertCreatureAddonAuras(CreatureDataAddon* addon, char const* table, char const* guidEntryStr)
+void ObjectMgr::ConvertCreatureAddonAuras(SQLStorage& storage, CreatureDataAddon* addon, char const* guidEntryStr)
 {
+    char const* table = storage.GetTableName();
+
     // Now add the auras, format "spell1 spell2 ..."
     char* p, *s;
     std::vector<int> val;
@@ -611,8 +614,7 @@ void ObjectMgr::ConvertCreatureAddonAuras(CreatureDataAddon* addon, char const*
         if (p != s)
             { val.push_back(atoi(s)); }
 
-        // free char* loaded memory
-        delete[](char*)reinterpret_cast<char const*>(addon->auras);
+        // the loaded string is interned in the storage and released with it
     }
 
     // empty list
@@ -623,7 +625,7 @@ void ObjectMgr::ConvertCreatureAddonAuras(CreatureDataAddon* addon, char const*
     }
 
     // replace by new structures array
-    const_cast<uint32*&>(addon->auras) = new uint32[val.size() + 1];
+    const_cast<uint32*&>(addon->auras) = reinterpret_cast<uint32*>(storage.AllocateRecordData((val.size() + 1) * sizeof(uint32)));
 
     uint32 i = 0;
     for (uint32 j = 0; j < val.size(); ++j)
@@ -697,7 +699,7 @@ void ObjectMgr::LoadCreatureAddons(SQLStorage& creatureaddons, char const* entry
             const_cast<CreatureDataAddon*>(addon)->emote = 0;
         }
 
-        ConvertCreatureAddonAuras(const_cast<CreatureDataAddon*>(addon), creatureaddons.GetTableName(), entryName);
+        ConvertCreatureAddonAuras(creatureaddons, const_cast<CreatureDataAddon*>(addon), entryName);
     }
 }
 
@@ -1023,8 +1025,17 @@ void ObjectMgr::LoadCreatureModelInfo()
 void ObjectMgr::LoadCreatures()
 {
     uint32 count = 0;
-    //                                                0                       1   2    3
-    QueryResult* result = WorldDatabase.Query("SELECT creature.guid, creature.id, map, modelid,"
+    // the result is streamed, so the progress bar size is queried up front
+    uint32 rowCount = 0;
+    if (QueryResult* countResult = WorldDatabase.Query("SELECT COUNT(*) FROM creature"))
+    {
+        rowCount = (*countResult)[0].GetUInt32();
+        delete countResult;
+    }
+
+    QueryResult* result = WorldDatabase.QuerySnapshot("creature_spawns", "creature, game_event_creature, pool_creature, pool_creature_template",
+                          //      0                       1   2    3
+                          "SELECT creature.guid, creature.id, map, modelid,"
                           //   4             5           6           7           8            9              10         11
                           "equipment_id, position_x, position_y, position_z, orientation, spawntimesecs, spawndist, currentwaypoint,"
                           //   12         13       14          15            16
@@ -1049,7 +1060,7 @@ void ObjectMgr::LoadCreatures()
 
     // build single time for check creature data
 
-    BarGoLink bar(result->GetRowCount());
+    BarGoLink bar(rowCount);
 
     do
     {
@@ -1192,8 +1203,17 @@ void ObjectMgr::LoadGameObjects()
 {
     uint32 count = 0;
 
-    //                                                0                           1   2    3           4           5           6
-    QueryResult* result = WorldDatabase.Query("SELECT gameobject.guid, gameobject.id, map, position_x, position_y, position_z, orientation,"
+    // the result is streamed, so the progress bar size is queried up front
+    uint32 rowCount = 0;
+    if (QueryResult* countResult = WorldDatabase.Query("SELECT COUNT(*) FROM gameobject"))
+    {
+        rowCount = (*countResult)[0].GetUInt32();
+        delete countResult;
+    }
+
+    QueryResult* result = WorldDatabase.QuerySnapshot("gameobject_spawns", "gameobject, game_event_gameobject, pool_gameobject, pool_gameobject_template",
+                          //      0                           1   2    3           4           5           6
+                          "SELECT gameobject.guid, gameobject.id, map, position_x, position_y, position_z, orientation,"
                           //   7          8          9          10         11             12            13     14
                           "rotation0, rotation1, rotation2, rotation3, spawntimesecs, animprogress, state, event,"
                           //   15                          16
@@ -1214,7 +1234,7 @@ void ObjectMgr::LoadGameObjects()
         return;
     }
 
-    BarGoLink bar(result->GetRowCount());
+    BarGoLink bar(rowCount);
 
     do
     {
@@ -1368,18 +1388,12 @@ bool ObjectMgr::GetPlayerNameByGUID(ObjectGuid guid, std::string& name) const
         return true;
     }
 
-    uint32 lowguid = guid.GetCounter();
-
-    QueryResult* result = CharacterDatabase.PQuery("SELECT name FROM characters WHERE guid = '%u'", lowguid);
-
-    if (result)
-    {
-        name = (*result)[0].GetCppString();
-        delete result;
-        return true;
-    }
+    CharacterNameData data;
+    if (!GetCharacterNameData(guid.GetCounter(), data))
+        { return false; }
 
-    return false;
+    name = data.name;
+    return true;
 }
 
 Team ObjectMgr::GetPlayerTeamByGUID(ObjectGuid guid) const
@@ -1388,18 +1402,11 @@ Team ObjectMgr::GetPlayerTeamByGUID(ObjectGuid guid) const
     if (Player* player = GetPlayer(guid))
         { return Player::TeamForRace(player->getRace()); }
 
-    uint32 lowguid = guid.GetCounter();
-
-    QueryResult* result = CharacterDatabase.PQuery("SELECT race FROM characters WHERE guid = '%u'", lowguid);
+    CharacterNameData data;
+    if (!GetCharacterNameData(guid.GetCounter(), data))
+        { return TEAM_NONE; }
 
-    if (result)
-    {
-        uint8 race = (*result)[0].GetUInt8();
-        delete result;
-        return Player::TeamForRace(race);
-    }
-
-    return TEAM_NONE;
+    return Player::TeamForRace(data.race);
 }
 
 uint32 ObjectMgr::GetPlayerAccountIdByGUID(ObjectGuid guid) const
@@ -1411,9 +1418,16 @@ uint32 ObjectMgr::GetPlayerAccountIdByGUID(ObjectGuid guid) const
     if (Player* player = GetPlayer(guid))
         { return player->GetSession()->GetAccountId(); }
 
-    uint32 lowguid = guid.GetCounter();
+    CharacterNameData data;
+    if (!GetCharacterNameData(guid.GetCounter(), data))
+        { return 0; }
+
+    return data.account;
+}
 
-    QueryResult* result = CharacterDatabase.PQuery("SELECT account FROM characters WHERE guid = '%u'", lowguid);
+uint32 ObjectMgr::GetPlayerAccountIdByPlayerName(const std::string& name) const
+{
+    QueryResult* result = CharacterDatabase.PQuery("SELECT account FROM characters WHERE name = '%s'", name.c_str());
     if (result)
     {
         uint32 acc = (*result)[0].GetUInt32();
@@ -1424,17 +1438,112 @@ uint32 ObjectMgr::GetPlayerAccountIdByGUID(ObjectGuid guid) const
     return 0;
 }
 
-uint32 ObjectMgr::GetPlayerAccountIdByPlayerName(const std::string& name) const
+void ObjectMgr::LoadCharacterNames()
 {
-    QueryResult* result = CharacterDatabase.PQuery("SELECT account FROM characters WHERE name = '%s'", name.c_str());
+    CharacterNameMap names;
+
+    //                                                     0     1     2        3     4       5
+    QueryResult* result = CharacterDatabase.Query("SELECT guid, name, account, race, gender, class FROM characters");
     if (result)
     {
-        uint32 acc = (*result)[0].GetUInt32();
+        BarGoLink bar(result->GetRowCount());
+
+        do
+        {
+            bar.step();
+            Field* fields = result->Fetch();
+
+            CharacterNameData& data = names[fields[0].GetUInt32()];
+            data.name = fields[1].GetCppString();
+            data.account = fields[2].GetUInt32();
+            data.race = fields[3].GetUInt8();
+            data.gender = fields[4].GetUInt8();
+            data.class_ = fields[5].GetUInt8();
+        }
+        while (result->NextRow());
+
         delete result;
-        return acc;
+    }
+    else
+    {
+        BarGoLink bar(1);
+        bar.step();
     }
 
-    return 0;
+    {
+        ACE_WRITE_GUARD(ACE_RW_Thread_Mutex, guard, m_CharacterNamesLock);
+        m_CharacterNames.swap(names);
+        m_CharacterNamesLoaded = true;
+    }
+
+    sLog.outString();
+    sLog.outString(">> Loaded " SIZEFMTD " character names", m_CharacterNames.size());
+}
+
+bool ObjectMgr::GetCharacterNameData(uint32 lowguid, CharacterNameData& data) const
+{
+    {
+        ACE_READ_GUARD_RETURN(ACE_RW_Thread_Mutex, guard, m_CharacterNamesLock, false);
+
+        CharacterNameMap::const_iterator itr = m_CharacterNames.find(lowguid);
+        if (itr != m_CharacterNames.end())
+        {
+            data = itr->second;
+            return true;
+        }
+
+        if (m_CharacterNamesLoaded)
+            { return false; }
+    }
+
+    // loaders running before the cache is filled still need the characters
+    QueryResult* result = CharacterDatabase.PQuery("SELECT name, account, race, gender, class FROM characters WHERE guid = '%u'", lowguid);
+    if (!result)
+        { return false; }
+
+    Field* fields = result->Fetch();
+    data.name = fields[0].GetCppString();
+    data.account = fields[1].GetUInt32();
+    data.race = fields[2].GetUInt8();
+    data.gender = fields[3].GetUInt8();
+    data.class_ = fields[4].GetUInt8();
+
+    delete result;
+    return true;
+}
+
+void ObjectMgr::SetCharacterNameData(uint32 lowguid, CharacterNameData const& data)
+{
+    ACE_WRITE_GUARD(ACE_RW_Thread_Mutex, guard, m_CharacterNamesLock);
+    m_CharacterNames[lowguid] = data;
+}
+
+void ObjectMgr::SetCharacterName(uint32 lowguid, std::string const& name)
+{
+    ACE_WRITE_GUARD(ACE_RW_Thread_Mutex, guard, m_CharacterNamesLock);
+
+    CharacterNameMap::iterator itr = m_CharacterNames.find(lowguid);
+    if (itr != m_CharacterNames.end())
+        { itr->second.name = name; }
+}
+
+void ObjectMgr::UnlinkCharacterNameData(uint32 lowguid)
+{
+    ACE_WRITE_GUARD(ACE_RW_Thread_Mutex, guard, m_CharacterNamesLock);
+
+    // same as the row: name freed, account cleared, still known as a deleted character
+    CharacterNameMap::iterator itr = m_CharacterNames.find(lowguid);
+    if (itr != m_CharacterNames.end())
+    {
+        itr->second.name.clear();
+        itr->second.account = 0;
+    }
+}
+
+void ObjectMgr::DeleteCharacterNameData(uint32 lowguid)
+{
+    ACE_WRITE_GUARD(ACE_RW_Thread_Mutex, guard, m_CharacterNamesLock);
+    m_CharacterNames.erase(lowguid);
 }
 
 void ObjectMgr::LoadItemLocales()
@@ -47,6 +47,8 @@
 #include <map>
 #include <limits>
 
+#include <ace/RW_Thread_Mutex.h>
+
 class Group;
 class Item;
 class SQLStorage;
@@ -289,6 +291,17 @@ struct GraveYardData
 typedef std::multimap < uint32 /*zoneId*/, GraveYardData > GraveYardMap;
 typedef std::pair<GraveYardMap::const_iterator, GraveYardMap::const_iterator> GraveYardMapBounds;
 
+// what name queries and guid lookups need to know about a character, online or not
+struct CharacterNameData
+{
+    std::string name;                                       // empty for characters unlinked at delete
+    uint32 account;
+    uint8 race;
+    uint8 gender;
+    uint8 class_;
+};
+typedef UNORDERED_MAP < uint32 /*lowguid*/, CharacterNameData > CharacterNameMap;
+
 enum ConditionType
 {
     //                                                      // value1       value2  for the Condition enumed
@@ -519,6 +532,13 @@ class ObjectMgr
         uint32 GetPlayerAccountIdByGUID(ObjectGuid guid) const;
         uint32 GetPlayerAccountIdByPlayerName(const std::string& name) const;
 
+        void LoadCharacterNames();
+        bool GetCharacterNameData(uint32 lowguid, CharacterNameData& data) const;
+        void SetCharacterNameData(uint32 lowguid, CharacterNameData const& data);
+        void SetCharacterName(uint32 lowguid, std::string const& name);
+        void UnlinkCharacterNameData(uint32 lowguid);
+        void DeleteCharacterNameData(uint32 lowguid);
+
         uint32 GetNearestTaxiNode(float x, float y, float z, uint32 mapid, Team team);
         void GetTaxiPath(uint32 source, uint32 destination, uint32& path, uint32& cost);
         uint32 GetTaxiMountDisplayId(uint32 id, Team team, bool allowed_alt_team = false);
@@ -1110,6 +1130,11 @@ class ObjectMgr
 
         GraveYardMap        mGraveYardMap;
 
+        // every character of the realm, kept in step with `characters` so name lookups never query it
+        CharacterNameMap    m_CharacterNames;
+        bool                m_CharacterNamesLoaded;         // until then misses are looked up in the DB
+        mutable ACE_RW_Thread_Mutex m_CharacterNamesLock;
+
         GameTeleMap         m_GameTeleMap;
 
         ItemRequiredTargetMap m_ItemRequiredTarget;
@@ -1128,7 +1153,7 @@ class ObjectMgr
 
     private:
         void LoadCreatureAddons(SQLStorage& creatureaddons, char const* entryName, char const* comment);
-        void ConvertCreatureAddonAuras(CreatureDataAddon* addon, char const* table, char const* guidEntryStr);
+        void ConvertCreatureAddonAuras(SQLStorage& storage, CreatureDataAddon* addon, char const* guidEntryStr);
         void LoadQuestRelationsHelper(QuestRelationsMap& map, char const* table);
         void LoadVendors(char const* tableName, bool isTemplates);
         void LoadTrainers(char const* tableName, bool isTemplates);
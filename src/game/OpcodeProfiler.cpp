@@ -0,0 +1,208 @@
+/**
+ * MaNGOS is a full featured server for World of Warcraft, supporting
+ * the following clients: 1.12.x, 2.4.3, 3.3.5a, 4.3.4a and 5.4.8
+ *
+ * Copyright (C) 2005-2014  MaNGOS project <http://getmangos.eu>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * World of Warcraft, and all World of Warcraft or Warcraft art, images,
+ * and lore are copyrighted by Blizzard Entertainment, Inc.
+ */
+
+#include "OpcodeProfiler.h"
+#include "WorldPacket.h"
+#include "WorldSession.h"
+#include "World.h"
+#include "Log.h"
+#include "Util.h"
+
+#include <ace/Guard_T.h>
+
+#include <algorithm>
+#include <cstdio>
+
+INSTANTIATE_SINGLETON_1(OpcodeProfiler);
+
+namespace
+{
+    /**
+     * @brief orders opcodes by total handler time, slowest first
+     *
+     */
+    struct OpcodeTimeOrder
+    {
+        explicit OpcodeTimeOrder(std::vector<OpcodeStats> const& stats) : m_stats(stats) {}
+
+        bool operator()(uint16 left, uint16 right) const
+        {
+            return m_stats[left].totalTime > m_stats[right].totalTime;
+        }
+
+        std::vector<OpcodeStats> const& m_stats;            /**< TODO */
+    };
+}
+
+OpcodeProfiler::Scope::Scope(WorldSession* session, WorldPacket const& packet) :
+    m_session(session), m_opcode(packet.GetOpcode()), m_size(uint32(packet.size())),
+    m_enabled(sWorld.getConfig(CONFIG_BOOL_OPCODE_STATS_ENABLED))
+{
+    if (m_enabled)
+        { m_timer.start(); }
+}
+
+OpcodeProfiler::Scope::~Scope()
+{
+    if (!m_enabled)
+        { return; }
+
+    m_timer.stop();
+
+    ACE_hrtime_t elapsed;
+    m_timer.elapsed_microseconds(elapsed);
+    uint32 time = elapsed > ACE_hrtime_t(0xFFFFFFFF) ? 0xFFFFFFFF : uint32(elapsed);
+
+    sOpcodeProfiler.Record(m_opcode, time, m_size);
+
+    uint32 outlierTime = sWorld.getConfig(CONFIG_UINT32_OPCODE_STATS_OUTLIER_TIME);
+    if (outlierTime && time >= outlierTime * 1000)
+    {
+        sLog.outString("OpcodeStats: %s (0x%.4X) took %u us, %u bytes, account %u, player %s, address %s",
+                       LookupOpcodeName(m_opcode), m_opcode, time, m_size,
+                       m_session->GetAccountId(), m_session->GetPlayerName(), m_session->GetRemoteAddress().c_str());
+    }
+}
+
+OpcodeProfiler::OpcodeProfiler() : m_generation(0)
+{
+}
+
+OpcodeProfiler::~OpcodeProfiler()
+{
+    for (SlotList::const_iterator itr = m_slots.begin(); itr != m_slots.end(); ++itr)
+        { delete *itr; }
+}
+
+void OpcodeProfiler::Record(uint16 opcode, uint32 time, uint32 bytes)
+{
+    if (opcode >= NUM_MSG_TYPES)
+        { return; }
+
+    Slot*& slot = m_owner->slot;
+    long generation = m_generation.value();
+
+    if (!slot)
+    {
+        slot = new Slot(generation);
+
+        ACE_GUARD(ACE_Thread_Mutex, guard, m_lock);
+        m_slots.push_back(slot);
+    }
+    else if (slot->generation.value() != generation)
+    {
+        // readers skip the slot until the new generation is published after the clear
+        slot->generation = -1;
+        for (uint32 i = 0; i < NUM_MSG_TYPES; ++i)
+            { slot->stats[i] = OpcodeStats(); }
+        slot->generation = generation;
+    }
+
+    OpcodeStats& stats = slot->stats[opcode];
+    ++stats.calls;
+    stats.totalTime += time;
+    stats.bytes += bytes;
+    if (time > stats.maxTime)
+        { stats.maxTime = time; }
+}
+
+void OpcodeProfiler::GetStats(std::vector<OpcodeStats>& stats) const
+{
+    stats.assign(NUM_MSG_TYPES, OpcodeStats());
+
+    long generation = m_generation.value();
+    std::vector<OpcodeStats> copy(NUM_MSG_TYPES);
+
+    ACE_GUARD(ACE_Thread_Mutex, guard, m_lock);
+    for (SlotList::const_iterator itr = m_slots.begin(); itr != m_slots.end(); ++itr)
+    {
+        // slots of threads that did not handle a packet since the last reset, or are clearing
+        if ((*itr)->generation.value() != generation)
+            { continue; }
+
+        std::copy((*itr)->stats, (*itr)->stats + NUM_MSG_TYPES, copy.begin());
+
+        // the owner started clearing while we copied
+        if ((*itr)->generation.value() != generation)
+            { continue; }
+
+        for (uint32 i = 0; i < NUM_MSG_TYPES; ++i)
+        {
+            OpcodeStats const& slotStats = copy[i];
+            if (!slotStats.calls)
+                { continue; }
+
+            stats[i].calls += slotStats.calls;
+            stats[i].totalTime += slotStats.totalTime;
+            stats[i].bytes += slotStats.bytes;
+            if (slotStats.maxTime > stats[i].maxTime)
+                { stats[i].maxTime = slotStats.maxTime; }
+        }
+    }
+}
+
+void OpcodeProfiler::Reset()
+{
+    ++m_generation;
+}
+
+bool OpcodeProfiler::Dump(std::string const& fileName) const
+{
+    FILE* file = fopen(fileName.c_str(), "w");
+    if (!file)
+        { return false; }
+
+    std::vector<OpcodeStats> stats;
+    GetStats(stats);
+
+    std::vector<uint16> order;
+    SortByTime(stats, order);
+
+    // tab separated, one line per handled opcode
+    fprintf(file, "Opcode handler statistics at %s\n\n", TimeToTimestampStr(time(NULL)).c_str());
+    fprintf(file, "opcode\tid\tcalls\ttotal ms\tavg us\tmax us\tbytes\n");
+
+    for (std::vector<uint16>::const_iterator itr = order.begin(); itr != order.end(); ++itr)
+    {
+        OpcodeStats const& opcodeStats = stats[*itr];
+        fprintf(file, "%s\t0x%.4X\t" UI64FMTD "\t" UI64FMTD "\t" UI64FMTD "\t%u\t" UI64FMTD "\n",
+                LookupOpcodeName(*itr), *itr, opcodeStats.calls, opcodeStats.totalTime / 1000,
+                opcodeStats.totalTime / opcodeStats.calls, opcodeStats.maxTime, opcodeStats.bytes);
+    }
+
+    fclose(file);
+    return true;
+}
+
+void OpcodeProfiler::SortByTime(std::vector<OpcodeStats> const& stats, std::vector<uint16>& order)
+{
+    order.clear();
+    for (uint32 i = 0; i < stats.size(); ++i)
+    {
+        if (stats[i].calls)
+            { order.push_back(uint16(i)); }
+    }
+
+    std::sort(order.begin(), order.end(), OpcodeTimeOrder(stats));
+}
@@ -0,0 +1,177 @@
+/**
+ * MaNGOS is a full featured server for World of Warcraft, supporting
+ * the following clients: 1.12.x, 2.4.3, 3.3.5a, 4.3.4a and 5.4.8
+ *
+ * Copyright (C) 2005-2014  MaNGOS project <http://getmangos.eu>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * World of Warcraft, and all World of Warcraft or Warcraft art, images,
+ * and lore are copyrighted by Blizzard Entertainment, Inc.
+ */
+
+#ifndef MANGOS_OPCODEPROFILER_H
+#define MANGOS_OPCODEPROFILER_H
+
+#include "Common.h"
+#include "Policies/Singleton.h"
+#include "Opcodes.h"
+
+#include <ace/Atomic_Op.h>
+#include <ace/High_Res_Timer.h>
+#include <ace/TSS_T.h>
+#include <ace/Thread_Mutex.h>
+
+class WorldPacket;
+class WorldSession;
+
+/**
+ * @brief handler counters of one opcode, times in microseconds
+ *
+ */
+struct OpcodeStats
+{
+    OpcodeStats() : calls(0), totalTime(0), bytes(0), maxTime(0) {}
+
+    uint64 calls;                                           /**< TODO */
+    uint64 totalTime;                                       /**< TODO */
+    uint64 bytes;                                           /**< TODO */
+    uint32 maxTime;                                         /**< TODO */
+};
+
+/**
+ * @brief counts calls, handler time and bytes of every client opcode
+ *
+ * Packets are handled by the world thread and by the map update threads,
+ * so every thread writes into a slot of its own and never takes a lock.
+ * Readers sum the plain counters while the writers keep going: the totals
+ * are approximate, they may lag a few packets behind and on 32 bit builds
+ * a single 64 bit counter may be read half updated.
+ */
+class OpcodeProfiler
+{
+    public:
+        /**
+         * @brief measures one handler call, records it when it goes out of scope
+         *
+         */
+        class Scope
+        {
+            public:
+                /**
+                 * @brief
+                 *
+                 * @param session
+                 * @param packet
+                 */
+                Scope(WorldSession* session, WorldPacket const& packet);
+                /**
+                 * @brief
+                 *
+                 */
+                ~Scope();
+
+            private:
+                Scope(Scope const&);
+                Scope& operator=(Scope const&);
+
+                WorldSession* m_session;                    /**< TODO */
+                ACE_High_Res_Timer m_timer;                 /**< TODO */
+                uint16 m_opcode;                            /**< TODO */
+                uint32 m_size;                              /**< TODO */
+                bool m_enabled;                             /**< TODO */
+        };
+
+        /**
+         * @brief
+         *
+         */
+        OpcodeProfiler();
+        /**
+         * @brief
+         *
+         */
+        ~OpcodeProfiler();
+
+        /**
+         * @brief adds one handler call to the slot of the calling thread
+         *
+         * @param opcode
+         * @param time microseconds spent in the handler
+         * @param bytes packet size
+         */
+        void Record(uint16 opcode, uint32 time, uint32 bytes);
+        /**
+         * @brief sums the slots of all threads
+         *
+         * @param stats filled with NUM_MSG_TYPES entries, indexed by opcode
+         */
+        void GetStats(std::vector<OpcodeStats>& stats) const;
+        /**
+         * @brief clears the counters, every thread zeroes its slot on its next call
+         *
+         */
+        void Reset();
+        /**
+         * @brief writes the counters of all handled opcodes, slowest first
+         *
+         * @param fileName replaced on every dump
+         * @return bool false if the file can not be written
+         */
+        bool Dump(std::string const& fileName) const;
+
+        /**
+         * @brief opcodes with calls, ordered by total handler time
+         *
+         * @param stats as filled by GetStats
+         * @param order filled with opcodes
+         */
+        static void SortByTime(std::vector<OpcodeStats> const& stats, std::vector<uint16>& order);
+
+    private:
+        /**
+         * @brief
+         *
+         */
+        struct Slot
+        {
+            explicit Slot(long gen) : generation(gen) {}
+
+            OpcodeStats stats[NUM_MSG_TYPES];               /**< TODO */
+            ACE_Atomic_Op<ACE_Thread_Mutex, long> generation; /**< Reset() call the counters belong to, stored after they are cleared */
+        };
+
+        /**
+         * @brief per thread holder, the slot itself outlives its thread
+         *
+         */
+        struct SlotOwner
+        {
+            SlotOwner() : slot(NULL) {}
+
+            Slot* slot;                                     /**< TODO */
+        };
+
+        typedef std::vector<Slot*> SlotList;
+
+        ACE_TSS<SlotOwner> m_owner;                         /**< TODO */
+        SlotList m_slots;                                   /**< TODO */
+        mutable ACE_Thread_Mutex m_lock;                    /**< guards m_slots */
+        ACE_Atomic_Op<ACE_Thread_Mutex, long> m_generation; /**< TODO */
+};
+
+#define sOpcodeProfiler MaNGOS::Singleton<OpcodeProfiler>::Instance()
+
+#endif
@@ -421,6 +421,8 @@ Player::Player(WorldSession* session): Unit(), m_mover(this), m_camera(this), m_
     SetGroupInvite(NULL);
     m_groupUpdateMask = 0;
     m_auraUpdateMask = 0;
+    m_groupUpdateTimer = 0;
+    m_groupPositionUpdateTimer = 0;
 
     ClearHonorInfo();
 
@@ -1293,8 +1295,31 @@ void Player::Update(uint32 update_diff, uint32 p_time)
     UpdateEnchantTime(update_diff);
     UpdateHomebindTime(update_diff);
 
-    // Group update
-    SendUpdateToOutOfRangeGroupMembers();
+    // Group update, changes are coalesced and sent at most once per interval
+    if (m_groupUpdateTimer > update_diff)
+        { m_groupUpdateTimer -= update_diff; }
+    else
+        { m_groupUpdateTimer = 0; }
+
+    if (m_groupPositionUpdateTimer > update_diff)
+        { m_groupPositionUpdateTimer -= update_diff; }
+    else
+        { m_groupPositionUpdateTimer = 0; }
+
+    if (m_groupUpdateMask != GROUP_UPDATE_FLAG_NONE)
+    {
+        bool positionOnly = (m_groupUpdateMask & ~GROUP_UPDATE_FLAG_POSITION) == GROUP_UPDATE_FLAG_NONE;
+
+        if ((m_groupUpdateMask & GROUP_UPDATE_URGENT) ||
+            (positionOnly ? m_groupPositionUpdateTimer == 0 && m_groupUpdateTimer == 0 : m_groupUpdateTimer == 0))
+        {
+            if (m_groupUpdateMask & GROUP_UPDATE_FLAG_POSITION)
+                { m_groupPositionUpdateTimer = sWorld.getConfig(CONFIG_UINT32_GROUP_MEMBER_POSITION_INTERVAL); }
+            m_groupUpdateTimer = sWorld.getConfig(CONFIG_UINT32_GROUP_MEMBER_STATS_INTERVAL);
+
+            SendUpdateToOutOfRangeGroupMembers();
+        }
+    }
 
     Pet* pet = GetPet();
     if (pet && !pet->IsWithinDistInMap(this, GetMap()->GetVisibilityDistance()) && (GetCharmGuid() && (pet->GetObjectGuid() != GetCharmGuid())))
@@ -3474,18 +3499,10 @@ Mail* Player::GetMail(uint32 id)
 
 void Player::_SetCreateBits(UpdateMask* updateMask, Player* target) const
 {
-    if (target == this)
-    {
-        Object::_SetCreateBits(updateMask, target);
-    }
-    else
-    {
-        for (uint16 index = 0; index < m_valuesCount; ++index)
-        {
-            if (GetUInt32Value(index) != 0 && updateVisualBits.GetBit(index))
-                { updateMask->SetBit(index); }
-        }
-    }
+    Object::_SetCreateBits(updateMask, target);
+
+    if (target != this)
+        { *updateMask &= updateVisualBits; }
 }
 
 void Player::_SetUpdateBits(UpdateMask* updateMask, Player* target) const
@@ -3496,8 +3513,8 @@ void Player::_SetUpdateBits(UpdateMask* updateMask, Player* target) const
     }
     else
     {
-        Object::_SetUpdateBits(updateMask, target);
-        *updateMask &= updateVisualBits;
+        // changed fields filtered by the precomputed visible fields, a word at a time
+        updateMask->SetMasked(m_changedValues, updateVisualBits);
     }
 }
 
@@ -3941,11 +3958,14 @@ void Player::DeleteFromDB(ObjectGuid playerguid, uint32 accountId, bool updateRe
             CharacterDatabase.PExecute("DELETE FROM character_pet WHERE owner = '%u'", lowguid);
             CharacterDatabase.PExecute("DELETE FROM guild_eventlog WHERE PlayerGuid1 = '%u' OR PlayerGuid2 = '%u'", lowguid, lowguid);
             CharacterDatabase.CommitTransaction();
+
+            sObjectMgr.DeleteCharacterNameData(lowguid);
             break;
         }
         // The character gets unlinked from the account, the name gets freed up and appears as deleted ingame
         case 1:
             CharacterDatabase.PExecute("UPDATE characters SET deleteInfos_Name=name, deleteInfos_Account=account, deleteDate='" UI64FMTD "', name='', account=0 WHERE guid=%u", uint64(time(NULL)), lowguid);
+            sObjectMgr.UnlinkCharacterNameData(lowguid);
             break;
         default:
             sLog.outError("Player::DeleteFromDB: Unsupported delete method: %u.", charDelete_method);
@@ -15067,6 +15087,14 @@ void Player::SaveToDB()
 
     uberInsert.Execute();
 
+    CharacterNameData nameData;
+    nameData.name = m_name;
+    nameData.account = GetSession()->GetAccountId();
+    nameData.race = getRace();
+    nameData.gender = getGender();
+    nameData.class_ = getClass();
+    sObjectMgr.SetCharacterNameData(GetGUIDLow(), nameData);
+
     if (m_mailsUpdated)                                     // save mails only when needed
         { _SaveMail(); }
 
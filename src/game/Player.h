@@ -2267,6 +2267,8 @@ class MANGOS_DLL_SPEC Player : public Unit
         Group* m_groupInvite;
         uint32 m_groupUpdateMask;
         uint64 m_auraUpdateMask;
+        uint32 m_groupUpdateTimer;                          // delay before next coalesced out of range stats update
+        uint32 m_groupPositionUpdateTimer;                  // delay before next position only stats update
 
         ObjectGuid m_miniPetGuid;
 
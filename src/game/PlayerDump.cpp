@@ -471,6 +471,10 @@ DumpReturn PlayerDumpReader::LoadDump(const std::string& file, uint32 account, s
     typedef PetIds::value_type PetIdsPair;
     PetIds petids;
 
+    CharacterNameData nameData;
+    nameData.account = account;
+    nameData.race = nameData.gender = nameData.class_ = 0;
+
     CharacterDatabase.BeginTransaction();
     while (!feof(fin))
     {
@@ -541,6 +545,11 @@ DumpReturn PlayerDumpReader::LoadDump(const std::string& file, uint32 account, s
                 if (!changenth(line, 2, chraccount))        // characters.account update
                     { ROLLBACK(DUMP_FILE_BROKEN); }
 
+                // race, class and gender are kept from the dump
+                nameData.race = uint8(atoi(getnth(line, 4).c_str()));
+                nameData.class_ = uint8(atoi(getnth(line, 5).c_str()));
+                nameData.gender = uint8(atoi(getnth(line, 6).c_str()));
+
                 if (name == "")
                 {
                     // check if the original name already exists
@@ -562,6 +571,8 @@ DumpReturn PlayerDumpReader::LoadDump(const std::string& file, uint32 account, s
                         { ROLLBACK(DUMP_FILE_BROKEN); }
                 }
 
+                nameData.name = getnth(line, 3);
+
                 break;
             }
             case DTT_INVENTORY:
@@ -696,6 +707,8 @@ DumpReturn PlayerDumpReader::LoadDump(const std::string& file, uint32 account, s
 
     CharacterDatabase.CommitTransaction();
 
+    sObjectMgr.SetCharacterNameData(guid, nameData);
+
     // FIXME: current code with post-updating guids not safe for future per-map threads
     sObjectMgr.m_ItemGuids.Set(sObjectMgr.m_ItemGuids.GetNextAfterMaxUsed() + items.size());
     sObjectMgr.m_MailIds.Set(sObjectMgr.m_MailIds.GetNextAfterMaxUsed() +  mails.size());
@@ -39,6 +39,7 @@
 #include "Pet.h"
 #include "MapManager.h"
 #include "SQLStorages.h"
+#include "QueryResponseCache.h"
 
 void WorldSession::SendNameQueryOpcode(Player* p)
 {
@@ -57,51 +58,32 @@ void WorldSession::SendNameQueryOpcode(Player* p)
     SendPacket(&data);
 }
 
-void WorldSession::SendNameQueryOpcodeFromDB(ObjectGuid guid)
+void WorldSession::SendNameQueryOpcodeFromCache(ObjectGuid guid)
 {
-    CharacterDatabase.AsyncPQuery(&WorldSession::SendNameQueryOpcodeFromDBCallBack, GetAccountId(),
-                                  //          0     1     2     3       4
-                                  "SELECT guid, name, race, gender, class "
-                                  "FROM characters WHERE guid = '%u'",
-                                  guid.GetCounter());
-}
-
-void WorldSession::SendNameQueryOpcodeFromDBCallBack(QueryResult* result, uint32 accountId)
-{
-    if (!result)
+    CharacterNameData nameData;
+    if (!sObjectMgr.GetCharacterNameData(guid.GetCounter(), nameData))
         { return; }
 
-    WorldSession* session = sWorld.FindSession(accountId);
-    if (!session)
-    {
-        delete result;
-        return;
-    }
-
-    Field* fields = result->Fetch();
-    uint32 lowguid      = fields[0].GetUInt32();
-    std::string name = fields[1].GetCppString();
     uint8 pRace = 0, pGender = 0, pClass = 0;
-    if (name == "")
-        { name         = session->GetMangosString(LANG_NON_EXIST_CHARACTER); }
+    if (nameData.name.empty())
+        { nameData.name = GetMangosString(LANG_NON_EXIST_CHARACTER); }
     else
     {
-        pRace        = fields[2].GetUInt8();
-        pGender      = fields[3].GetUInt8();
-        pClass       = fields[4].GetUInt8();
+        pRace        = nameData.race;
+        pGender      = nameData.gender;
+        pClass       = nameData.class_;
     }
 
     // guess size
     WorldPacket data(SMSG_NAME_QUERY_RESPONSE, (8 + 1 + 4 + 4 + 4 + 10));
-    data << ObjectGuid(HIGHGUID_PLAYER, lowguid);
-    data << name;
+    data << guid;
+    data << nameData.name;
     data << uint8(0);                                       // realm name for cross realm BG usage
     data << uint32(pRace);                                  // race
     data << uint32(pGender);                                // gender
     data << uint32(pClass);                                 // class
 
-    session->SendPacket(&data);
-    delete result;
+    SendPacket(&data);
 }
 
 void WorldSession::HandleNameQueryOpcode(WorldPacket& recv_data)
@@ -115,7 +97,7 @@ void WorldSession::HandleNameQueryOpcode(WorldPacket& recv_data)
     if (pChar)
         { SendNameQueryOpcode(pChar); }
     else
-        { SendNameQueryOpcodeFromDB(guid); }
+        { SendNameQueryOpcodeFromCache(guid); }
 }
 
 void WorldSession::HandleQueryTimeOpcode(WorldPacket& /*recv_data*/)
@@ -142,33 +124,45 @@ void WorldSession::HandleCreatureQueryOpcode(WorldPacket& recv_data)
     {
         int loc_idx = GetSessionDbLocaleIndex();
 
-        char const* name = ci->Name;
-        char const* subName = ci->SubName;
-        sObjectMgr.GetCreatureLocaleStrings(entry, loc_idx, &name, &subName);
-
         DETAIL_LOG("WORLD: CMSG_CREATURE_QUERY '%s' - Entry: %u.", ci->Name, entry);
-        // guess size
-        WorldPacket data(SMSG_CREATURE_QUERY_RESPONSE, 100);
-        data << uint32(entry);                              // creature entry
-        data << name;
-        data << uint8(0) << uint8(0) << uint8(0);           // name2, name3, name4, always empty
-        data << subName;
-        data << uint32(ci->CreatureTypeFlags);              // flags
-        if (unit)
-            { data << uint32(((unit->IsPet()) ? 0 : ci->CreatureType)); } // CreatureType.dbc   wdbFeild8
-        else
-            { data << uint32(ci->CreatureType); }
 
-        data << uint32(ci->Family);                         // CreatureFamily.dbc
-        data << uint32(ci->Rank);                           // Creature Rank (elite, boss, etc)
-        data << uint32(0);                                  // unknown        wdbFeild11
-        data << uint32(ci->PetSpellDataId);                 // Id from CreatureSpellData.dbc    wdbField12
+        WorldPacket data;
+        if (!sQueryResponseCache.Find(QUERY_RESPONSE_CREATURE, entry, loc_idx, data))
+        {
+            char const* name = ci->Name;
+            char const* subName = ci->SubName;
+            sObjectMgr.GetCreatureLocaleStrings(entry, loc_idx, &name, &subName);
+
+            // guess size
+            data.Initialize(SMSG_CREATURE_QUERY_RESPONSE, 100);
+            data << uint32(entry);                          // creature entry
+            data << name;
+            data << uint8(0) << uint8(0) << uint8(0);       // name2, name3, name4, always empty
+            data << subName;
+            data << uint32(ci->CreatureTypeFlags);          // flags
+            data << uint32(ci->CreatureType);               // CreatureType.dbc   wdbFeild8, set per unit below
+            data << uint32(ci->Family);                     // CreatureFamily.dbc
+            data << uint32(ci->Rank);                       // Creature Rank (elite, boss, etc)
+            data << uint32(0);                              // unknown        wdbFeild11
+            data << uint32(ci->PetSpellDataId);             // Id from CreatureSpellData.dbc    wdbField12
+            data << uint32(0);                              // DisplayID      wdbFeild13, set per unit below
+            data << uint16(ci->civilian);                   // wdbFeild14
+
+            sQueryResponseCache.Store(QUERY_RESPONSE_CREATURE, entry, loc_idx, data);
+        }
+
+        // the fixed size tail after the strings: type, family, rank, unk, pet spells, display id, civilian
+        size_t typePos = data.size() - 6 * sizeof(uint32) - sizeof(uint16);
+        size_t displayPos = data.size() - sizeof(uint32) - sizeof(uint16);
+
         if (unit)
-            { data << unit->GetUInt32Value(UNIT_FIELD_DISPLAYID); } // DisplayID      wdbFeild13
+        {
+            data.put<uint32>(typePos, unit->IsPet() ? 0 : ci->CreatureType);
+            data.put<uint32>(displayPos, unit->GetUInt32Value(UNIT_FIELD_DISPLAYID));
+        }
         else
-            { data << uint32(Creature::ChooseDisplayId(ci)); }  // workaround, way to manage models must be fixed
+            { data.put<uint32>(displayPos, Creature::ChooseDisplayId(ci)); } // workaround, way to manage models must be fixed
 
-        data << uint16(ci->civilian);                       // wdbFeild14
         SendPacket(&data);
         DEBUG_LOG("WORLD: Sent SMSG_CREATURE_QUERY_RESPONSE");
     }
@@ -194,9 +188,12 @@ void WorldSession::HandleGameObjectQueryOpcode(WorldPacket& recv_data)
     const GameObjectInfo* info = ObjectMgr::GetGameObjectInfo(entryID);
     if (info)
     {
+        int loc_idx = GetSessionDbLocaleIndex();
+        if (sQueryResponseCache.Send(this, QUERY_RESPONSE_GAMEOBJECT, entryID, loc_idx))
+            { return; }
+
         std::string Name = info->name;
 
-        int loc_idx = GetSessionDbLocaleIndex();
         if (loc_idx >= 0)
         {
             GameObjectLocale const* gl = sObjectMgr.GetGameObjectLocale(entryID);
@@ -215,6 +212,7 @@ void WorldSession::HandleGameObjectQueryOpcode(WorldPacket& recv_data)
         data << uint16(0) << uint8(0) << uint8(0);          // name2, name3, name4
         data.append(info->raw.data, 24);
         // data << float(info->size);                       // go size , to check
+        sQueryResponseCache.Store(QUERY_RESPONSE_GAMEOBJECT, entryID, loc_idx, data);
         SendPacket(&data);
         DEBUG_LOG("WORLD: Sent SMSG_GAMEOBJECT_QUERY_RESPONSE");
     }
@@ -293,6 +291,10 @@ void WorldSession::HandleNpcTextQueryOpcode(WorldPacket& recv_data)
 
     GossipText const* pGossip = sObjectMgr.GetGossipText(textID);
 
+    int loc_idx = GetSessionDbLocaleIndex();
+    if (pGossip && sQueryResponseCache.Send(this, QUERY_RESPONSE_NPC_TEXT, textID, loc_idx))
+        { return; }
+
     WorldPacket data(SMSG_NPC_TEXT_UPDATE, 100);            // guess size
     data << textID;
 
@@ -321,8 +323,6 @@ void WorldSession::HandleNpcTextQueryOpcode(WorldPacket& recv_data)
             Text_1[i] = pGossip->Options[i].Text_1;
         }
 
-        int loc_idx = GetSessionDbLocaleIndex();
-
         sObjectMgr.GetNpcTextLocaleStringsAll(textID, loc_idx, &Text_0, &Text_1);
 
         for (int i = 0; i < MAX_GOSSIP_TEXT_OPTIONS; ++i)
@@ -347,6 +347,8 @@ void WorldSession::HandleNpcTextQueryOpcode(WorldPacket& recv_data)
                 data << pGossip->Options[i].Emotes[j]._Emote;
             }
         }
+
+        sQueryResponseCache.Store(QUERY_RESPONSE_NPC_TEXT, textID, loc_idx, data);
     }
 
     SendPacket(&data);
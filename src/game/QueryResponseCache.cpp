@@ -0,0 +1,105 @@
+/**
+ * MaNGOS is a full featured server for World of Warcraft, supporting
+ * the following clients: 1.12.x, 2.4.3, 3.3.5a, 4.3.4a and 5.4.8
+ *
+ * Copyright (C) 2005-2014  MaNGOS project <http://getmangos.eu>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * World of Warcraft, and all World of Warcraft or Warcraft art, images,
+ * and lore are copyrighted by Blizzard Entertainment, Inc.
+ */
+
+#include "QueryResponseCache.h"
+#include "WorldSession.h"
+
+#include <ace/Guard_T.h>
+
+INSTANTIATE_SINGLETON_1(QueryResponseCache);
+
+QueryResponseCache::QueryResponseCache()
+{
+    for (int i = 0; i < MAX_QUERY_RESPONSE_TYPE; ++i)
+        { m_bytes[i] = 0; }
+}
+
+bool QueryResponseCache::Send(WorldSession* session, QueryResponseType type, uint32 entry, int locale)
+{
+    // copy under the lock, SendPacket may block on the socket queue
+    WorldPacket data;
+    if (!Find(type, entry, locale, data))
+        { return false; }
+
+    session->SendPacket(&data);
+    return true;
+}
+
+bool QueryResponseCache::Find(QueryResponseType type, uint32 entry, int locale, WorldPacket& data)
+{
+    {
+        ACE_READ_GUARD_RETURN(ACE_RW_Thread_Mutex, guard, m_lock, false);
+
+        ResponseMap::const_iterator itr = m_responses[type].find(MakeKey(entry, locale));
+        if (itr != m_responses[type].end())
+        {
+            ++m_hits[type];
+            data = itr->second;
+            return true;
+        }
+    }
+
+    ++m_misses[type];
+    return false;
+}
+
+void QueryResponseCache::Store(QueryResponseType type, uint32 entry, int locale, WorldPacket const& data)
+{
+    ACE_WRITE_GUARD(ACE_RW_Thread_Mutex, guard, m_lock);
+
+    std::pair<ResponseMap::iterator, bool> res = m_responses[type].insert(ResponseMap::value_type(MakeKey(entry, locale), data));
+    if (res.second)
+        { m_bytes[type] += data.size(); }
+}
+
+void QueryResponseCache::Invalidate(QueryResponseType type)
+{
+    ACE_WRITE_GUARD(ACE_RW_Thread_Mutex, guard, m_lock);
+
+    m_responses[type].clear();
+    m_bytes[type] = 0;
+}
+
+void QueryResponseCache::GetStats(QueryResponseType type, QueryResponseStats& stats)
+{
+    stats.hits = m_hits[type].value();
+    stats.misses = m_misses[type].value();
+
+    ACE_READ_GUARD(ACE_RW_Thread_Mutex, guard, m_lock);
+    stats.entries = uint32(m_responses[type].size());
+    stats.bytes = m_bytes[type];
+}
+
+char const* QueryResponseCache::GetTypeName(QueryResponseType type)
+{
+    switch (type)
+    {
+        case QUERY_RESPONSE_CREATURE:   return "creature";
+        case QUERY_RESPONSE_GAMEOBJECT: return "gameobject";
+        case QUERY_RESPONSE_ITEM:       return "item";
+        case QUERY_RESPONSE_QUEST:      return "quest";
+        case QUERY_RESPONSE_NPC_TEXT:   return "npc_text";
+        default:                        return "unknown";
+    }
+}
@@ -0,0 +1,149 @@
+/**
+ * MaNGOS is a full featured server for World of Warcraft, supporting
+ * the following clients: 1.12.x, 2.4.3, 3.3.5a, 4.3.4a and 5.4.8
+ *
+ * Copyright (C) 2005-2014  MaNGOS project <http://getmangos.eu>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * World of Warcraft, and all World of Warcraft or Warcraft art, images,
+ * and lore are copyrighted by Blizzard Entertainment, Inc.
+ */
+
+#ifndef MANGOS_QUERYRESPONSECACHE_H
+#define MANGOS_QUERYRESPONSECACHE_H
+
+#include "Common.h"
+#include "Policies/Singleton.h"
+#include "Utilities/UnorderedMapSet.h"
+#include "WorldPacket.h"
+
+#include <ace/Atomic_Op.h>
+#include <ace/RW_Thread_Mutex.h>
+#include <ace/Thread_Mutex.h>
+
+class WorldSession;
+
+/**
+ * @brief kinds of static query responses kept by QueryResponseCache
+ *
+ */
+enum QueryResponseType
+{
+    QUERY_RESPONSE_CREATURE     = 0,                        // SMSG_CREATURE_QUERY_RESPONSE
+    QUERY_RESPONSE_GAMEOBJECT   = 1,                        // SMSG_GAMEOBJECT_QUERY_RESPONSE
+    QUERY_RESPONSE_ITEM         = 2,                        // SMSG_ITEM_QUERY_SINGLE_RESPONSE
+    QUERY_RESPONSE_QUEST        = 3,                        // SMSG_QUEST_QUERY_RESPONSE
+    QUERY_RESPONSE_NPC_TEXT     = 4,                        // SMSG_NPC_TEXT_UPDATE
+    MAX_QUERY_RESPONSE_TYPE
+};
+
+/**
+ * @brief counters of one QueryResponseType
+ *
+ */
+struct QueryResponseStats
+{
+    long hits;                                              /**< TODO */
+    long misses;                                            /**< TODO */
+    uint32 entries;                                         /**< TODO */
+    size_t bytes;                                           /**< TODO */
+};
+
+/**
+ * @brief serialized query responses, built once per entry and locale
+ *
+ * The responses only carry template and locale data, so the first client
+ * asking for an entry pays for building the packet and every later one
+ * gets a copy of the stored bytes. The reload commands of the backing
+ * tables drop the affected type.
+ */
+class QueryResponseCache
+{
+    public:
+        QueryResponseCache();
+
+        /**
+         * @brief sends a copy of the stored response for entry and locale
+         *
+         * The copy is sent after the lock is released.
+         *
+         * @param session
+         * @param type
+         * @param entry
+         * @param locale db locale index of the session, -1 for default
+         * @return bool false if nothing is stored yet
+         */
+        bool Send(WorldSession* session, QueryResponseType type, uint32 entry, int locale);
+        /**
+         * @brief copies the stored response for entry and locale into data
+         *
+         * For responses the caller adjusts per object before sending.
+         *
+         * @param type
+         * @param entry
+         * @param locale
+         * @param data
+         * @return bool false if nothing is stored yet
+         */
+        bool Find(QueryResponseType type, uint32 entry, int locale, WorldPacket& data);
+        /**
+         * @brief
+         *
+         * @param type
+         * @param entry
+         * @param locale
+         * @param data
+         */
+        void Store(QueryResponseType type, uint32 entry, int locale, WorldPacket const& data);
+
+        /**
+         * @brief drops all responses of a type, called after its tables are reloaded
+         *
+         * @param type
+         */
+        void Invalidate(QueryResponseType type);
+        /**
+         * @brief
+         *
+         * @param type
+         * @param stats
+         */
+        void GetStats(QueryResponseType type, QueryResponseStats& stats);
+
+        /**
+         * @brief
+         *
+         * @param type
+         * @return const char
+         */
+        static char const* GetTypeName(QueryResponseType type);
+
+    private:
+        typedef ACE_Atomic_Op<ACE_Thread_Mutex, long> Counter;
+        typedef UNORDERED_MAP<uint64, WorldPacket> ResponseMap;
+
+        static uint64 MakeKey(uint32 entry, int locale) { return (uint64(uint32(locale + 1)) << 32) | entry; }
+
+        ACE_RW_Thread_Mutex m_lock;                         /**< guards m_responses and m_bytes */
+        ResponseMap m_responses[MAX_QUERY_RESPONSE_TYPE];   /**< TODO */
+        size_t m_bytes[MAX_QUERY_RESPONSE_TYPE];            /**< TODO */
+        Counter m_hits[MAX_QUERY_RESPONSE_TYPE];            /**< TODO */
+        Counter m_misses[MAX_QUERY_RESPONSE_TYPE];          /**< TODO */
+};
+
+#define sQueryResponseCache MaNGOS::Singleton<QueryResponseCache>::Instance()
+
+#endif
@@ -1104,6 +1104,12 @@ bool ScriptAction::HandleScriptStep()
         pSourceOrItem = pSource ? pSource : (source && source->isType(TYPEMASK_ITEM) ? source : NULL);
     }
 
+    // the command may change state the idle checks do not look at
+    if (pSource && pSource->GetTypeId() == TYPEID_UNIT)
+        { ((Creature*)pSource)->WakeUp(); }
+    if (pTarget && pTarget->GetTypeId() == TYPEID_UNIT)
+        { ((Creature*)pTarget)->WakeUp(); }
+
     switch (m_script->command)
     {
         case SCRIPT_COMMAND_TALK:                           // 0
@@ -33,6 +33,7 @@
 #include "LootMgr.h"
 #include "Unit.h"
 #include "Player.h"
+#include "GridRangeFilter.h"
 
 class WorldSession;
 class WorldPacket;
@@ -704,88 +705,109 @@ namespace MaNGOS
             if (!i_originalCaster || !i_castingObject)
                 { return; }
 
-            for (typename GridRefManager<T>::iterator itr = m.begin(); itr != m.end(); ++itr)
+            RangeFilter filter;
+            switch (i_push_type)
             {
-                // there are still more spells which can be casted on dead, but
-                // they are no AOE and don't have such a nice SPELL_ATTR flag
-                if ((i_TargetType != SPELL_TARGETS_ALL && !itr->getSource()->IsTargetableForAttack(i_spell.m_spellInfo->HasAttribute(SPELL_ATTR_EX3_CAST_ON_DEAD)))
-                    // mostly phase check
-                    || !itr->getSource()->IsInMap(i_originalCaster))
-                    { continue; }
+                case PUSH_DEST_CENTER:
+                    filter = RangeFilter(i_centerX, i_centerY, i_radius);
+                    break;
+                case PUSH_TARGET_CENTER:
+                    if (Unit* unitTarget = i_spell.m_targets.getUnitTarget())
+                        { filter = RangeFilter(i_centerX, i_centerY, i_radius + unitTarget->GetObjectBoundingRadius()); }
+                    else
+                        { return; }
+                    break;
+                default:
+                    filter = RangeFilter(i_centerX, i_centerY, i_radius + i_castingObject->GetObjectBoundingRadius());
+                    break;
+            }
+
+            // distance prefilter for the whole cell, precise checks below only for the units possibly in range
+            filter.Visit(m, *this);
+        }
 
-                switch (i_TargetType)
+        template<class T> bool OnCandidate(T* target)
+        {
+            // there are still more spells which can be casted on dead, but
+            // they are no AOE and don't have such a nice SPELL_ATTR flag
+            if ((i_TargetType != SPELL_TARGETS_ALL && !target->IsTargetableForAttack(i_spell.m_spellInfo->HasAttribute(SPELL_ATTR_EX3_CAST_ON_DEAD)))
+                // mostly phase check
+                || !target->IsInMap(i_originalCaster))
+                { return true; }
+
+            switch (i_TargetType)
+            {
+                case SPELL_TARGETS_HOSTILE:
+                    if (!i_originalCaster->IsHostileTo(target))
+                        { return true; }
+                    break;
+                case SPELL_TARGETS_NOT_FRIENDLY:
+                    if (i_originalCaster->IsFriendlyTo(target))
+                        { return true; }
+                    break;
+                case SPELL_TARGETS_NOT_HOSTILE:
+                    if (i_originalCaster->IsHostileTo(target))
+                        { return true; }
+                    break;
+                case SPELL_TARGETS_FRIENDLY:
+                    if (!i_originalCaster->IsFriendlyTo(target))
+                        { return true; }
+                    break;
+                case SPELL_TARGETS_AOE_DAMAGE:
                 {
-                    case SPELL_TARGETS_HOSTILE:
-                        if (!i_originalCaster->IsHostileTo(itr->getSource()))
-                            { continue; }
-                        break;
-                    case SPELL_TARGETS_NOT_FRIENDLY:
-                        if (i_originalCaster->IsFriendlyTo(itr->getSource()))
-                            { continue; }
-                        break;
-                    case SPELL_TARGETS_NOT_HOSTILE:
-                        if (i_originalCaster->IsHostileTo(itr->getSource()))
-                            { continue; }
-                        break;
-                    case SPELL_TARGETS_FRIENDLY:
-                        if (!i_originalCaster->IsFriendlyTo(itr->getSource()))
-                            { continue; }
-                        break;
-                    case SPELL_TARGETS_AOE_DAMAGE:
+                    if (target->GetTypeId() == TYPEID_UNIT && ((Creature*)target)->IsTotem())
+                        { return true; }
+
+                    if (i_playerControlled)
                     {
-                        if (itr->getSource()->GetTypeId() == TYPEID_UNIT && ((Creature*)itr->getSource())->IsTotem())
-                            { continue; }
-
-                        if (i_playerControlled)
-                        {
-                            if (i_originalCaster->IsFriendlyTo(itr->getSource()))
-                                { continue; }
-                        }
-                        else
-                        {
-                            if (!i_originalCaster->IsHostileTo(itr->getSource()))
-                                { continue; }
-                        }
+                        if (i_originalCaster->IsFriendlyTo(target))
+                            { return true; }
+                    }
+                    else
+                    {
+                        if (!i_originalCaster->IsHostileTo(target))
+                            { return true; }
                     }
-                    break;
-                    case SPELL_TARGETS_ALL:
-                        break;
-                    default: continue;
                 }
+                break;
+                case SPELL_TARGETS_ALL:
+                    break;
+                default: return true;
+            }
 
-                // we don't need to check InMap here, it's already done some lines above
-                switch (i_push_type)
-                {
-                    case PUSH_IN_FRONT:
-                        if (i_castingObject->isInFront((Unit*)(itr->getSource()), i_radius, 2 * M_PI_F / 3))
-                            { i_data->push_back(itr->getSource()); }
-                        break;
-                    case PUSH_IN_FRONT_90:
-                        if (i_castingObject->isInFront((Unit*)(itr->getSource()), i_radius, M_PI_F / 2))
-                            { i_data->push_back(itr->getSource()); }
-                        break;
-                    case PUSH_IN_FRONT_15:
-                        if (i_castingObject->isInFront((Unit*)(itr->getSource()), i_radius, M_PI_F / 12))
-                            { i_data->push_back(itr->getSource()); }
-                        break;
-                    case PUSH_IN_BACK:
-                        if (i_castingObject->isInBack((Unit*)(itr->getSource()), i_radius, 2 * M_PI_F / 3))
-                            { i_data->push_back(itr->getSource()); }
-                        break;
-                    case PUSH_SELF_CENTER:
-                        if (i_castingObject->IsWithinDist((Unit*)(itr->getSource()), i_radius))
-                            { i_data->push_back(itr->getSource()); }
-                        break;
-                    case PUSH_DEST_CENTER:
-                        if (itr->getSource()->IsWithinDist3d(i_centerX, i_centerY, i_centerZ, i_radius))
-                            { i_data->push_back(itr->getSource()); }
-                        break;
-                    case PUSH_TARGET_CENTER:
-                        if (i_spell.m_targets.getUnitTarget() && i_spell.m_targets.getUnitTarget()->IsWithinDist((Unit*)(itr->getSource()), i_radius))
-                            { i_data->push_back(itr->getSource()); }
-                        break;
-                }
+            // we don't need to check InMap here, it's already done some lines above
+            switch (i_push_type)
+            {
+                case PUSH_IN_FRONT:
+                    if (i_castingObject->isInFront((Unit*)(target), i_radius, 2 * M_PI_F / 3))
+                        { i_data->push_back(target); }
+                    break;
+                case PUSH_IN_FRONT_90:
+                    if (i_castingObject->isInFront((Unit*)(target), i_radius, M_PI_F / 2))
+                        { i_data->push_back(target); }
+                    break;
+                case PUSH_IN_FRONT_15:
+                    if (i_castingObject->isInFront((Unit*)(target), i_radius, M_PI_F / 12))
+                        { i_data->push_back(target); }
+                    break;
+                case PUSH_IN_BACK:
+                    if (i_castingObject->isInBack((Unit*)(target), i_radius, 2 * M_PI_F / 3))
+                        { i_data->push_back(target); }
+                    break;
+                case PUSH_SELF_CENTER:
+                    if (i_castingObject->IsWithinDist((Unit*)(target), i_radius))
+                        { i_data->push_back(target); }
+                    break;
+                case PUSH_DEST_CENTER:
+                    if (target->IsWithinDist3d(i_centerX, i_centerY, i_centerZ, i_radius))
+                        { i_data->push_back(target); }
+                    break;
+                case PUSH_TARGET_CENTER:
+                    if (i_spell.m_targets.getUnitTarget() && i_spell.m_targets.getUnitTarget()->IsWithinDist((Unit*)(target), i_radius))
+                        { i_data->push_back(target); }
+                    break;
             }
+            return true;
         }
 
 #ifdef WIN32
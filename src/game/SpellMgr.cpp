@@ -396,12 +396,8 @@ int32 CompareAuraRanks(uint32 spellId_1, uint32 spellId_2)
     return 0;
 }
 
-SpellSpecific GetSpellSpecific(uint32 spellId)
+static SpellSpecific ComputeSpellSpecific(SpellEntry const* spellInfo)
 {
-    SpellEntry const* spellInfo = sSpellStore.LookupEntry(spellId);
-    if (!spellInfo)
-        { return SPELL_NORMAL; }
-
     switch (spellInfo->SpellFamilyName)
     {
         case SPELLFAMILY_GENERIC:
@@ -547,6 +543,18 @@ SpellSpecific GetSpellSpecific(uint32 spellId)
     return SPELL_NORMAL;
 }
 
+SpellSpecific GetSpellSpecific(uint32 spellId)
+{
+    if (SpellDerivedInfo const* derived = sSpellMgr.GetSpellDerivedInfo(spellId))
+        { return SpellSpecific(derived->specific); }
+
+    SpellEntry const* spellInfo = sSpellStore.LookupEntry(spellId);
+    if (!spellInfo)
+        { return SPELL_NORMAL; }
+
+    return ComputeSpellSpecific(spellInfo);
+}
+
 // target not allow have more one spell specific from same caster
 bool IsSingleFromSpellSpecificPerTargetPerCaster(SpellSpecific spellSpec1, SpellSpecific spellSpec2)
 {
@@ -672,7 +680,7 @@ bool IsExplicitNegativeTarget(uint32 targetA)
     return false;
 }
 
-bool IsPositiveEffect(SpellEntry const* spellproto, SpellEffectIndex effIndex)
+static bool ComputePositiveEffect(SpellEntry const* spellproto, SpellEffectIndex effIndex)
 {
     switch (spellproto->Effect[effIndex])
     {
@@ -867,6 +875,14 @@ bool IsPositiveEffect(SpellEntry const* spellproto, SpellEffectIndex effIndex)
     return true;
 }
 
+bool IsPositiveEffect(SpellEntry const* spellproto, SpellEffectIndex effIndex)
+{
+    if (SpellDerivedInfo const* derived = sSpellMgr.GetSpellDerivedInfo(spellproto->Id))
+        { return derived->positiveEffectMask & (1 << effIndex); }
+
+    return ComputePositiveEffect(spellproto, effIndex);
+}
+
 bool IsPositiveSpell(uint32 spellId)
 {
     SpellEntry const* spellproto = sSpellStore.LookupEntry(spellId);
@@ -878,6 +894,9 @@ bool IsPositiveSpell(uint32 spellId)
 
 bool IsPositiveSpell(SpellEntry const* spellproto)
 {
+    if (SpellDerivedInfo const* derived = sSpellMgr.GetSpellDerivedInfo(spellproto->Id))
+        { return derived->flags & SPELL_DERIVED_POSITIVE; }
+
     // spells with at least one negative effect are considered negative
     // some self-applied spells have negative effects but in self casting case negative check ignored.
     for (int i = 0; i < MAX_EFFECT_INDEX; ++i)
@@ -886,7 +905,8 @@ bool IsPositiveSpell(SpellEntry const* spellproto)
     return true;
 }
 
-bool IsSingleTargetSpell(SpellEntry const* spellInfo)
+// specific is passed in, GetSpellSpecific would read the derived table being rebuilt
+static bool ComputeSingleTargetSpell(SpellEntry const* spellInfo, SpellSpecific specific)
 {
     // hunter's mark and similar
     if (spellInfo->SpellVisual == 3239)
@@ -933,7 +953,7 @@ bool IsSingleTargetSpell(SpellEntry const* spellInfo)
        ) { return true; }
 
     // TODO - need found Judgements rule
-    switch (GetSpellSpecific(spellInfo->Id))
+    switch (specific)
     {
         case SPELL_JUDGEMENT:
             return true;
@@ -944,6 +964,33 @@ bool IsSingleTargetSpell(SpellEntry const* spellInfo)
     return false;
 }
 
+bool IsSingleTargetSpell(SpellEntry const* spellInfo)
+{
+    if (SpellDerivedInfo const* derived = sSpellMgr.GetSpellDerivedInfo(spellInfo->Id))
+        { return derived->flags & SPELL_DERIVED_SINGLE_TARGET; }
+
+    return ComputeSingleTargetSpell(spellInfo, GetSpellSpecific(spellInfo->Id));
+}
+
+static bool ComputeAreaOfEffectSpell(SpellEntry const* spellInfo)
+{
+    if (IsAreaEffectTarget(Targets(spellInfo->EffectImplicitTargetA[EFFECT_INDEX_0])) || IsAreaEffectTarget(Targets(spellInfo->EffectImplicitTargetB[EFFECT_INDEX_0])))
+        { return true; }
+    if (IsAreaEffectTarget(Targets(spellInfo->EffectImplicitTargetA[EFFECT_INDEX_1])) || IsAreaEffectTarget(Targets(spellInfo->EffectImplicitTargetB[EFFECT_INDEX_1])))
+        { return true; }
+    if (IsAreaEffectTarget(Targets(spellInfo->EffectImplicitTargetA[EFFECT_INDEX_2])) || IsAreaEffectTarget(Targets(spellInfo->EffectImplicitTargetB[EFFECT_INDEX_2])))
+        { return true; }
+    return false;
+}
+
+bool IsAreaOfEffectSpell(SpellEntry const* spellInfo)
+{
+    if (SpellDerivedInfo const* derived = sSpellMgr.GetSpellDerivedInfo(spellInfo->Id))
+        { return derived->flags & SPELL_DERIVED_AREA_EFFECT; }
+
+    return ComputeAreaOfEffectSpell(spellInfo);
+}
+
 bool IsSingleTargetSpells(SpellEntry const* spellInfo1, SpellEntry const* spellInfo2)
 {
     // TODO - need better check
@@ -1279,6 +1326,7 @@ struct DoSpellProcEvent
 
 void SpellMgr::LoadSpellProcEvents()
 {
+    mSpellProcEventIndex.Clear();                           // points into the map
     mSpellProcEventMap.clear();                             // need for reload case
 
     //                                                0      1           2                3                 4                 5                 6          7       8        9             10
@@ -1325,6 +1373,8 @@ void SpellMgr::LoadSpellProcEvents()
 
     delete result;
 
+    mSpellProcEventIndex.Build(mSpellProcEventMap, sSpellStore.GetNumRows());
+
     sLog.outString();
     sLog.outString(">> Loaded %u extra spell proc event conditions +%u custom proc (inc. +%u custom ranks)",  rankHelper.worker.count, rankHelper.worker.customProc, rankHelper.customRank);
 }
@@ -1412,6 +1462,7 @@ struct DoSpellBonuses
 
 void SpellMgr::LoadSpellBonuses()
 {
+    mSpellBonusIndex.Clear();                           // points into the map
     mSpellBonusMap.clear();                             // need for reload case
     uint32 count = 0;
     //                                                0      1             2          3
@@ -1542,6 +1593,8 @@ void SpellMgr::LoadSpellBonuses()
 
     delete result;
 
+    mSpellBonusIndex.Build(mSpellBonusMap, sSpellStore.GetNumRows());
+
     sLog.outString();
     sLog.outString(">> Loaded %u extra spell bonus data",  count);
 }
@@ -2436,6 +2489,7 @@ static void LoadSpellChains_AbilityHelper(SpellChainMap& chainMap, AbilitySpellP
 
 void SpellMgr::LoadSpellChains()
 {
+    mSpellChainIndex.Clear();                               // points into the map
     mSpellChains.clear();                                   // need for reload case
     mSpellChainsNext.clear();                               // need for reload case
 
@@ -2773,6 +2827,8 @@ void SpellMgr::LoadSpellChains()
         }
     }
 
+    mSpellChainIndex.Build(mSpellChains, sSpellStore.GetNumRows());
+
     sLog.outString();
     sLog.outString(">> Loaded %u spell chain records (%u from DBC data with %u req field updates, and %u loaded from table)", dbc_count + new_count, dbc_count, req_count, new_count);
 }
@@ -4113,3 +4169,52 @@ void SpellMgr::LoadFacingCasterFlags()
     sLog.outString();
     sLog.outString(">> Loaded %u facing caster flags", count);
 }
+
+void SpellMgr::LoadSpellDerivedInfo()
+{
+    SpellDerivedInfoTable table(sSpellStore.GetNumRows());
+    uint32 count = 0;
+
+    BarGoLink bar(sSpellStore.GetNumRows());
+
+    for (uint32 id = 0; id < sSpellStore.GetNumRows(); ++id)
+    {
+        bar.step();
+
+        SpellDerivedInfo& derived = table[id];
+        derived.flags = 0;
+        derived.positiveEffectMask = 0;
+        derived.specific = SPELL_NORMAL;
+
+        SpellEntry const* spellInfo = sSpellStore.LookupEntry(id);
+        if (!spellInfo)
+            { continue; }
+
+        derived.flags = SPELL_DERIVED_LOADED | SPELL_DERIVED_POSITIVE;
+
+        // same rule as IsPositiveSpell: one negative effect makes the spell negative
+        for (int i = 0; i < MAX_EFFECT_INDEX; ++i)
+        {
+            if (ComputePositiveEffect(spellInfo, SpellEffectIndex(i)))
+                { derived.positiveEffectMask |= 1 << i; }
+            else if (spellInfo->Effect[i])
+                { derived.flags &= ~SPELL_DERIVED_POSITIVE; }
+        }
+
+        // from the just loaded elixir types, not from the table in use
+        SpellSpecific specific = ComputeSpellSpecific(spellInfo);
+        derived.specific = uint8(specific);
+
+        if (ComputeSingleTargetSpell(spellInfo, specific))
+            { derived.flags |= SPELL_DERIVED_SINGLE_TARGET; }
+        if (ComputeAreaOfEffectSpell(spellInfo))
+            { derived.flags |= SPELL_DERIVED_AREA_EFFECT; }
+
+        ++count;
+    }
+
+    mSpellDerivedInfo.swap(table);
+
+    sLog.outString();
+    sLog.outString(">> Derived attributes computed for %u spells", count);
+}
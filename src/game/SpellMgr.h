@@ -340,16 +340,7 @@ inline bool IsAreaEffectTarget(Targets target)
     return false;
 }
 
-inline bool IsAreaOfEffectSpell(SpellEntry const* spellInfo)
-{
-    if (IsAreaEffectTarget(Targets(spellInfo->EffectImplicitTargetA[EFFECT_INDEX_0])) || IsAreaEffectTarget(Targets(spellInfo->EffectImplicitTargetB[EFFECT_INDEX_0])))
-        { return true; }
-    if (IsAreaEffectTarget(Targets(spellInfo->EffectImplicitTargetA[EFFECT_INDEX_1])) || IsAreaEffectTarget(Targets(spellInfo->EffectImplicitTargetB[EFFECT_INDEX_1])))
-        { return true; }
-    if (IsAreaEffectTarget(Targets(spellInfo->EffectImplicitTargetA[EFFECT_INDEX_2])) || IsAreaEffectTarget(Targets(spellInfo->EffectImplicitTargetB[EFFECT_INDEX_2])))
-        { return true; }
-    return false;
-}
+bool IsAreaOfEffectSpell(SpellEntry const* spellInfo);
 
 inline bool IsAreaAuraEffect(uint32 effect)
 {
@@ -649,6 +640,36 @@ struct SpellBonusEntry
 typedef UNORDERED_MAP<uint32, SpellProcEventEntry> SpellProcEventMap;
 typedef UNORDERED_MAP<uint32, SpellBonusEntry>     SpellBonusMap;
 
+// Spell id indexed view of a spell id keyed map, for lookups on the cast, aura and proc paths.
+// Points into the map, so it must be reset before the map is cleared and rebuilt after it is loaded.
+// size is the expected id range, usually sSpellStore.GetNumRows(); it grows to fit larger keys.
+template<class T>
+class SpellIdIndex
+{
+    public:
+        template<class M>
+        void Build(M const& map, uint32 size)
+        {
+            for (typename M::const_iterator itr = map.begin(); itr != map.end(); ++itr)
+                if (itr->first >= size)
+                    { size = itr->first + 1; }
+
+            m_entries.assign(size, (T const*)NULL);
+            for (typename M::const_iterator itr = map.begin(); itr != map.end(); ++itr)
+                { m_entries[itr->first] = &itr->second; }
+        }
+
+        void Clear() { m_entries.clear(); }
+
+        T const* Find(uint32 spellId) const
+        {
+            return spellId < m_entries.size() ? m_entries[spellId] : NULL;
+        }
+
+    private:
+        std::vector<T const*> m_entries;
+};
+
 #define ELIXIR_FLASK_MASK     0x03                          // 2 bit mask for batter compatibility with more recent client version, flaks must have both bits set
 #define ELIXIR_WELL_FED       0x10                          // Some foods have SPELLFAMILY_POTION
 
@@ -854,6 +875,24 @@ inline bool IsProfessionOrRidingSkill(uint32 skill)
 
 typedef std::map<uint32, uint32> SpellFacingFlagMap;
 
+// Spell properties derived from DBC data (and spell_elixir), computed once at load (accessed using SpellMgr functions)
+enum SpellDerivedFlags
+{
+    SPELL_DERIVED_LOADED        = 0x01,                     // record is filled, spell exists
+    SPELL_DERIVED_POSITIVE      = 0x02,                     // IsPositiveSpell
+    SPELL_DERIVED_SINGLE_TARGET = 0x04,                     // IsSingleTargetSpell
+    SPELL_DERIVED_AREA_EFFECT   = 0x08,                     // IsAreaOfEffectSpell
+};
+
+struct SpellDerivedInfo
+{
+    uint8 flags;                                            // SpellDerivedFlags
+    uint8 positiveEffectMask;                               // bit per SpellEffectIndex, IsPositiveEffect
+    uint8 specific;                                         // SpellSpecific, GetSpellSpecific
+};
+
+typedef std::vector<SpellDerivedInfo> SpellDerivedInfoTable;
+
 class SpellMgr
 {
         friend struct DoSpellBonuses;
@@ -925,10 +964,7 @@ class SpellMgr
         // Spell proc events
         SpellProcEventEntry const* GetSpellProcEvent(uint32 spellId) const
         {
-            SpellProcEventMap::const_iterator itr = mSpellProcEventMap.find(spellId);
-            if (itr != mSpellProcEventMap.end())
-                { return &itr->second; }
-            return NULL;
+            return mSpellProcEventIndex.Find(spellId);
         }
 
         // Spell procs from item enchants
@@ -946,12 +982,7 @@ class SpellMgr
         // Spell bonus data
         SpellBonusEntry const* GetSpellBonusData(uint32 spellId) const
         {
-            // Lookup data
-            SpellBonusMap::const_iterator itr = mSpellBonusMap.find(spellId);
-            if (itr != mSpellBonusMap.end())
-                { return &itr->second; }
-
-            return NULL;
+            return mSpellBonusIndex.Find(spellId);
         }
 
         uint32 GetSpellFacingFlag(uint32 spellId) const
@@ -974,11 +1005,7 @@ class SpellMgr
         // Spell ranks chains
         SpellChainNode const* GetSpellChainNode(uint32 spell_id) const
         {
-            SpellChainMap::const_iterator itr = mSpellChains.find(spell_id);
-            if (itr == mSpellChains.end())
-                { return NULL; }
-
-            return &itr->second;
+            return mSpellChainIndex.Find(spell_id);
         }
 
         uint32 GetFirstSpellInChain(uint32 spell_id) const
@@ -1022,17 +1049,17 @@ class SpellMgr
 
         uint8 IsHighRankOfSpell(uint32 spell1, uint32 spell2) const
         {
-            SpellChainMap::const_iterator itr = mSpellChains.find(spell1);
+            SpellChainNode const* node = GetSpellChainNode(spell1);
 
             uint32 rank2 = GetSpellRank(spell2);
 
             // not ordered correctly by rank value
-            if (itr == mSpellChains.end() || !rank2 || itr->second.rank <= rank2)
+            if (!node || !rank2 || node->rank <= rank2)
                 { return false; }
 
             // check present in same rank chain
-            for (; itr != mSpellChains.end(); itr = mSpellChains.find(itr->second.prev))
-                if (itr->second.prev == spell2)
+            for (; node; node = GetSpellChainNode(node->prev))
+                if (node->prev == spell2)
                     { return true; }
 
             return false;
@@ -1130,6 +1157,15 @@ class SpellMgr
 
         SpellLinkedSet GetSpellLinked(uint32 spell_id, SpellLinkedType type) const;
 
+        // Derived attributes, NULL until loaded and for ids without spell
+        SpellDerivedInfo const* GetSpellDerivedInfo(uint32 spell_id) const
+        {
+            if (spell_id >= mSpellDerivedInfo.size() || !(mSpellDerivedInfo[spell_id].flags & SPELL_DERIVED_LOADED))
+                { return NULL; }
+
+            return &mSpellDerivedInfo[spell_id];
+        }
+
         // Modifiers
     public:
         static SpellMgr& Instance();
@@ -1154,9 +1190,11 @@ class SpellMgr
         void LoadSpellPetAuras();
         void LoadSpellAreas();
         void LoadFacingCasterFlags();
+        void LoadSpellDerivedInfo();
 
     private:
         SpellChainMap      mSpellChains;
+        SpellIdIndex<SpellChainNode> mSpellChainIndex;
         SpellChainMapNext  mSpellChainsNext;
         SpellLearnSkillMap mSpellLearnSkills;
         SpellLearnSpellMap mSpellLearnSpells;
@@ -1165,8 +1203,10 @@ class SpellMgr
         SpellElixirMap     mSpellElixirs;
         SpellThreatMap     mSpellThreatMap;
         SpellProcEventMap  mSpellProcEventMap;
+        SpellIdIndex<SpellProcEventEntry> mSpellProcEventIndex;
         SpellProcItemEnchantMap mSpellProcItemEnchantMap;
         SpellBonusMap      mSpellBonusMap;
+        SpellIdIndex<SpellBonusEntry> mSpellBonusIndex;
         SpellLinkedMap     mSpellLinkedMap;
         SkillLineAbilityMap mSkillLineAbilityMap;
         SkillRaceClassInfoMap mSkillRaceClassInfoMap;
@@ -1175,6 +1215,7 @@ class SpellMgr
         SpellAreaForAuraMap  mSpellAreaForAuraMap;
         SpellAreaForAreaMap  mSpellAreaForAreaMap;
         SpellFacingFlagMap  mSpellFacingFlagMap;
+        SpellDerivedInfoTable mSpellDerivedInfo;
 };
 
 #define sSpellMgr SpellMgr::Instance()
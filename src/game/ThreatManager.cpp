@@ -435,6 +435,9 @@ void ThreatManager::addThreat(Unit* pVictim, float pThreat, bool crit, SpellScho
 
 void ThreatManager::addThreatDirectly(Unit* pVictim, float threat)
 {
+    if (getOwner()->GetTypeId() == TYPEID_UNIT)
+        { ((Creature*)getOwner())->WakeUp(); }
+
     HostileReference* ref = iThreatContainer.addThreat(pVictim, threat);
     // Ref is not in the online refs, search the offline refs next
     if (!ref)
@@ -569,6 +569,9 @@ void Unit::DealDamageMods(Unit* pVictim, uint32& damage, uint32* absorb)
 
 uint32 Unit::DealDamage(Unit* pVictim, uint32 damage, CleanDamage const* cleanDamage, DamageEffectType damagetype, SpellSchoolMask damageSchoolMask, SpellEntry const* spellProto, bool durabilityLoss)
 {
+    if (pVictim->GetTypeId() == TYPEID_UNIT)
+        { ((Creature*)pVictim)->WakeUp(); }
+
     // remove affects from victim (including from 0 damage and DoTs)
     if (pVictim != this)
         { pVictim->RemoveSpellsCausingAura(SPELL_AURA_MOD_STEALTH); }
@@ -3557,6 +3560,10 @@ bool Unit::AddSpellAuraHolder(SpellAuraHolder* holder)
     holder->_AddSpellAuraHolder();
     m_spellAuraHolders.insert(SpellAuraHolderMap::value_type(holder->GetId(), holder));
 
+    // idle creatures do not check their auras every tick
+    if (GetTypeId() == TYPEID_UNIT)
+        { ((Creature*)this)->WakeUp(); }
+
     for (int32 i = 0; i < MAX_EFFECT_INDEX; ++i)
         if (Aura* aur = holder->GetAuraByEffectIndex(SpellEffectIndex(i)))
             { AddAuraToModList(aur); }
@@ -28,6 +28,10 @@
 #include "UpdateFields.h"
 #include "Errors.h"
 
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
 class UpdateMask
 {
     public:
@@ -54,6 +58,39 @@ class UpdateMask
             return (((uint8*)mUpdateMask)[ index >> 3 ] & (1 << (index & 0x7))) != 0;
         }
 
+        // index of the first set bit at or after index, GetCount() if there is none
+        uint32 GetNextSetBit(uint32 index) const
+        {
+            uint8 const* mask = (uint8 const*)mUpdateMask;
+            uint32 block = index >> 5;
+            if (block >= mBlocks)
+                { return mCount; }
+
+            // byte wise composed, the mask is sent as bytes and SetBit works on bytes
+            uint32 bits = GetBlockBits(mask, block) & (0xFFFFFFFF << (index & 0x1F));
+            while (!bits)
+            {
+                if (++block >= mBlocks)
+                    { return mCount; }
+                bits = GetBlockBits(mask, block);
+            }
+
+            index = (block << 5) + CountTrailingZeros(bits);
+            return index < mCount ? index : mCount;
+        }
+
+        // 32 fields starting at block << 5, field n of the block in bit n
+        uint32 GetBlock(uint32 block) const { return GetBlockBits((uint8 const*)mUpdateMask, block); }
+
+        void SetBlock(uint32 block, uint32 bits)
+        {
+            uint8* mask = (uint8*)mUpdateMask + (block << 2);
+            mask[0] = uint8(bits);
+            mask[1] = uint8(bits >> 8);
+            mask[2] = uint8(bits >> 16);
+            mask[3] = uint8(bits >> 24);
+        }
+
         uint32 GetBlockCount() const { return mBlocks; }
         uint32 GetLength() const { return mBlocks << 2; }
         uint32 GetCount() const { return mCount; }
@@ -98,6 +135,14 @@ class UpdateMask
                 { mUpdateMask[i] |= mask.mUpdateMask[i]; }
         }
 
+        // *this = mask & filter without a temporary mask, filter is usually a precomputed visibility mask
+        void SetMasked(const UpdateMask& mask, const UpdateMask& filter)
+        {
+            MANGOS_ASSERT(mask.mCount <= mCount && filter.mCount <= mCount);
+            for (uint32 i = 0; i < mBlocks; ++i)
+                { mUpdateMask[i] = mask.mUpdateMask[i] & filter.mUpdateMask[i]; }
+        }
+
         UpdateMask operator & (const UpdateMask& mask) const
         {
             MANGOS_ASSERT(mask.mCount <= mCount);
@@ -121,6 +166,32 @@ class UpdateMask
         }
 
     private:
+        static uint32 GetBlockBits(uint8 const* mask, uint32 block)
+        {
+            mask += block << 2;
+            return uint32(mask[0]) | (uint32(mask[1]) << 8) | (uint32(mask[2]) << 16) | (uint32(mask[3]) << 24);
+        }
+
+        // bits must not be 0
+        static uint32 CountTrailingZeros(uint32 bits)
+        {
+#if defined(__GNUC__)
+            return __builtin_ctz(bits);
+#elif defined(_MSC_VER)
+            unsigned long index;
+            _BitScanForward(&index, bits);
+            return index;
+#else
+            uint32 index = 0;
+            while (!(bits & 1))
+            {
+                bits >>= 1;
+                ++index;
+            }
+            return index;
+#endif
+        }
+
         uint32 mCount;
         uint32 mBlocks;
         uint32* mUpdateMask;
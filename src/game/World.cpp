@@ -69,6 +69,8 @@
 #include "AuctionHouseBot/AuctionHouseBot.h"
 #include "CharacterDatabaseCleaner.h"
 #include "CreatureLinkingMgr.h"
+#include "LoadGraph.h"
+#include "OpcodeProfiler.h"
 #include "LuaEngine.h"
 
 INSTANTIATE_SINGLETON_1(World);
@@ -520,6 +522,7 @@ void World::LoadConfigSettings(bool reload)
     setConfigMinMax(CONFIG_UINT32_COMPRESSION, "Compression", 1, 1, 9);
     setConfig(CONFIG_BOOL_ADDON_CHANNEL, "AddonChannel", true);
     setConfig(CONFIG_BOOL_CLEAN_CHARACTER_DB, "CleanCharacterDB", true);
+    setConfigMin(CONFIG_UINT32_LOAD_THREADS, "LoadingThreads", 4, 1);
     setConfig(CONFIG_BOOL_GRID_UNLOAD, "GridUnload", true);
     setConfig(CONFIG_UINT32_INTERVAL_SAVE, "PlayerSave.Interval", 15 * MINUTE * IN_MILLISECONDS);
     setConfigMinMax(CONFIG_UINT32_MIN_LEVEL_STAT_SAVE, "PlayerSave.Stats.MinLevel", 0, 0, MAX_LEVEL);
@@ -622,6 +625,8 @@ void World::LoadConfigSettings(bool reload)
     setConfig(CONFIG_UINT32_GM_INVISIBLE_AURA, "GM.InvisibleAura", 31748);
 
     setConfig(CONFIG_UINT32_GROUP_VISIBILITY, "Visibility.GroupMode", 0);
+    setConfig(CONFIG_UINT32_GROUP_MEMBER_STATS_INTERVAL, "Group.MemberStatsInterval", 500);
+    setConfig(CONFIG_UINT32_GROUP_MEMBER_POSITION_INTERVAL, "Group.MemberPositionInterval", 2000);
 
     setConfig(CONFIG_UINT32_MAIL_DELIVERY_DELAY, "MailDeliveryDelay", HOUR);
 
@@ -634,6 +639,18 @@ void World::LoadConfigSettings(bool reload)
         m_timers[WUPDATE_UPTIME].Reset();
     }
 
+    setConfig(CONFIG_BOOL_OPCODE_STATS_ENABLED, "OpcodeStats.Enable", true);
+    setConfig(CONFIG_UINT32_OPCODE_STATS_DUMP_INTERVAL, "OpcodeStats.DumpInterval", 0);
+    setConfig(CONFIG_UINT32_OPCODE_STATS_OUTLIER_TIME, "OpcodeStats.OutlierTime", 0);
+    m_opcodeStatsFile = sConfig.GetStringDefault("OpcodeStats.DumpFile", "world-opcodes.log");
+    if (!m_opcodeStatsFile.empty())
+        { m_opcodeStatsFile = sLog.GetLogsDir() + m_opcodeStatsFile; }
+    if (reload)
+    {
+        m_timers[WUPDATE_OPCODE_STATS].SetInterval(getConfig(CONFIG_UINT32_OPCODE_STATS_DUMP_INTERVAL) * IN_MILLISECONDS);
+        m_timers[WUPDATE_OPCODE_STATS].Reset();
+    }
+
     setConfig(CONFIG_UINT32_SKILL_CHANCE_ORANGE, "SkillChance.Orange", 100);
     setConfig(CONFIG_UINT32_SKILL_CHANCE_YELLOW, "SkillChance.Yellow", 75);
     setConfig(CONFIG_UINT32_SKILL_CHANCE_GREEN,  "SkillChance.Green",  25);
@@ -659,6 +676,7 @@ void World::LoadConfigSettings(bool reload)
     }
 
     setConfig(CONFIG_BOOL_SAVE_RESPAWN_TIME_IMMEDIATELY, "SaveRespawnTimeImmediately", true);
+    setConfig(CONFIG_UINT32_INTERVAL_SAVE_RESPAWN, "SaveRespawnTimeInterval", 10 * IN_MILLISECONDS);
     setConfig(CONFIG_BOOL_WEATHER, "ActivateWeather", true);
 
     setConfig(CONFIG_BOOL_ALWAYS_MAX_SKILL_FOR_LEVEL, "AlwaysMaxSkillForLevel", false);
@@ -707,6 +725,7 @@ void World::LoadConfigSettings(bool reload)
 
     setConfig(CONFIG_FLOAT_THREAT_RADIUS, "ThreatRadius", 100.0f);
     setConfigMin(CONFIG_UINT32_CREATURE_RESPAWN_AGGRO_DELAY, "CreatureRespawnAggroDelay", 5000, 0);
+    setConfig(CONFIG_UINT32_CREATURE_IDLE_UPDATE_INTERVAL, "CreatureIdleUpdateInterval", 1000);
 
     setConfig(CONFIG_BOOL_BATTLEGROUND_CAST_DESERTER,                  "Battleground.CastDeserter", true);
     setConfigMinMax(CONFIG_UINT32_BATTLEGROUND_QUEUE_ANNOUNCER_JOIN,   "Battleground.QueueAnnouncer.Join", 0, 0, 2);
@@ -852,6 +871,145 @@ void World::LoadConfigSettings(bool reload)
     setConfig(CONFIG_BOOL_ELUNA_ENABLED, "Eluna.Enabled", true);
 }
 
+/// Loaders scheduled by the LoadGraph in World::SetInitialWorldSettings
+static void LoadLootTablesStep()
+{
+    LoadLootTables();
+}
+
+static void LoadFishingBaseSkillLevelStep()
+{
+    sObjectMgr.LoadFishingBaseSkillLevel();
+}
+
+static void LoadNpcGossipsStep()
+{
+    sObjectMgr.LoadNpcGossips();
+}
+
+static void LoadGossipScriptsStep()
+{
+    sScriptMgr.LoadGossipScripts();                         // must be before gossip menu options
+}
+
+static void LoadGossipMenusStep()
+{
+    sObjectMgr.LoadGossipMenus();
+}
+
+static void LoadVendorsStep()
+{
+    sObjectMgr.LoadVendorTemplates();                       // must be after load ItemTemplate
+    sObjectMgr.LoadVendors();                               // must be after load CreatureTemplate, VendorTemplate, and ItemTemplate
+}
+
+static void LoadTrainersStep()
+{
+    sObjectMgr.LoadTrainerTemplates();                      // must be after load CreatureTemplate
+    sObjectMgr.LoadTrainers();                              // must be after load CreatureTemplate, TrainerTemplate
+}
+
+static void LoadCreatureMovementScriptsStep()
+{
+    sScriptMgr.LoadCreatureMovementScripts();               // before loading from creature_movement
+}
+
+static void LoadWaypointsStep()
+{
+    sWaypointMgr.Load();
+}
+
+static void LoadLocalesStep()
+{
+    sObjectMgr.LoadCreatureLocales();                       // must be after CreatureInfo loading
+    sObjectMgr.LoadGameObjectLocales();                     // must be after GameobjectInfo loading
+    sObjectMgr.LoadItemLocales();                           // must be after ItemPrototypes loading
+    sObjectMgr.LoadQuestLocales();                          // must be after QuestTemplates loading
+    sObjectMgr.LoadGossipTextLocales();                     // must be after LoadGossipText
+    sObjectMgr.LoadPageTextLocales();                       // must be after PageText loading
+    sObjectMgr.LoadGossipMenuItemsLocales();                // must be after gossip menu items loading
+    sObjectMgr.LoadPointOfInterestLocales();                // must be after POI loading
+}
+
+static void LoadAuctionsStep()
+{
+    sAuctionMgr.LoadAuctionItems();
+    sAuctionMgr.LoadAuctions();
+}
+
+static void LoadGuildsStep()
+{
+    sGuildMgr.LoadGuilds();
+}
+
+static void LoadGroupsStep()
+{
+    sObjectMgr.LoadGroups();
+}
+
+static void LoadCharacterNamesStep()
+{
+    sObjectMgr.LoadCharacterNames();
+}
+
+static void LoadReservedPlayersNamesStep()
+{
+    sObjectMgr.LoadReservedPlayersNames();
+}
+
+static void LoadGameObjectForQuestsStep()
+{
+    sObjectMgr.LoadGameObjectForQuests();
+}
+
+static void LoadBattleMastersStep()
+{
+    sBattleGroundMgr.LoadBattleMastersEntry();
+}
+
+static void LoadBattleEventIndexesStep()
+{
+    sBattleGroundMgr.LoadBattleEventIndexes();
+}
+
+static void LoadGameTeleStep()
+{
+    sObjectMgr.LoadGameTele();
+}
+
+static void LoadGMTicketsStep()
+{
+    sTicketMgr.LoadGMTickets();
+}
+
+static void ReturnOrDeleteOldMailsStep()
+{
+    sObjectMgr.ReturnOrDeleteOldMails(false);
+}
+
+static void LoadScriptsStep()
+{
+    sScriptMgr.LoadQuestStartScripts();                     // must be after load Creature/Gameobject(Template/Data) and QuestTemplate
+    sScriptMgr.LoadQuestEndScripts();                       // must be after load Creature/Gameobject(Template/Data) and QuestTemplate
+    sScriptMgr.LoadSpellScripts();                          // must be after load Creature/Gameobject(Template/Data)
+    sScriptMgr.LoadGameObjectScripts();                     // must be after load Creature/Gameobject(Template/Data)
+    sScriptMgr.LoadGameObjectTemplateScripts();             // must be after load Creature/Gameobject(Template/Data)
+    sScriptMgr.LoadEventScripts();                          // must be after load Creature/Gameobject(Template/Data)
+    sScriptMgr.LoadCreatureDeathScripts();                  // must be after load Creature/Gameobject(Template/Data)
+}
+
+static void LoadDbScriptStringsStep()
+{
+    sScriptMgr.LoadDbScriptStrings();                       // must be after Load*Scripts calls
+}
+
+static void LoadCreatureEventAIStep()
+{
+    sEventAIMgr.LoadCreatureEventAI_Texts(false);           // false, will checked in LoadCreatureEventAI_Scripts
+    sEventAIMgr.LoadCreatureEventAI_Summons(false);         // false, will checked in LoadCreatureEventAI_Scripts
+    sEventAIMgr.LoadCreatureEventAI_Scripts();
+}
+
 /// Initialize the World
 void World::SetInitialWorldSettings()
 {
@@ -921,6 +1079,9 @@ void World::SetInitialWorldSettings()
     sLog.outString("Loading SkillRaceClassInfoMultiMap Data...");
     sSpellMgr.LoadSkillRaceClassInfoMap();
 
+    sLog.outString("Loading respawn time journal...");
+    sMapPersistentStateMgr.LoadRespawnTimeJournal();        // must be called before CleanupInstances
+
     ///- Clean up and pack instances
     sLog.outString("Cleaning up instances...");
     sMapPersistentStateMgr.CleanupInstances();              // must be called before `creature_respawn`/`gameobject_respawn` tables
@@ -950,6 +1111,9 @@ void World::SetInitialWorldSettings()
     sLog.outString("Loading Spell Elixir types...");
     sSpellMgr.LoadSpellElixirs();
 
+    sLog.outString("Loading Spell derived attributes...");
+    sSpellMgr.LoadSpellDerivedInfo();                       // must be after LoadSpellElixirs
+
     sLog.outString("Loading Spell Facing Flags...");
     sSpellMgr.LoadFacingCasterFlags();
 
@@ -1127,111 +1291,39 @@ void World::SetInitialWorldSettings()
     sLog.outString("Loading Player Corpses...");
     sObjectMgr.LoadCorpses();
 
-    sLog.outString("Loading Loot Tables...");
-    sLog.outString();
-    LoadLootTables();
-    sLog.outString(">>> Loot Tables loaded");
-    sLog.outString();
-
-    sLog.outString("Loading Skill Fishing base level requirements...");
-    sObjectMgr.LoadFishingBaseSkillLevel();
-
-    sLog.outString("Loading Npc Text Id...");
-    sObjectMgr.LoadNpcGossips();                            // must be after load Creature and LoadGossipText
-
-    sLog.outString("Loading Gossip scripts...");
-    sScriptMgr.LoadGossipScripts();                         // must be before gossip menu options
-
-    sObjectMgr.LoadGossipMenus();
-
-    sLog.outString("Loading Vendors...");
-    sObjectMgr.LoadVendorTemplates();                       // must be after load ItemTemplate
-    sObjectMgr.LoadVendors();                               // must be after load CreatureTemplate, VendorTemplate, and ItemTemplate
-
-    sLog.outString("Loading Trainers...");
-    sObjectMgr.LoadTrainerTemplates();                      // must be after load CreatureTemplate
-    sObjectMgr.LoadTrainers();                              // must be after load CreatureTemplate, TrainerTemplate
-
-    sLog.outString("Loading Waypoint scripts...");          // before loading from creature_movement
-    sScriptMgr.LoadCreatureMovementScripts();
-
-    sLog.outString("Loading Waypoints...");
-    sLog.outString();
-    sWaypointMgr.Load();
-
-    ///- Loading localization data
-    sLog.outString("Loading Localization strings...");
-    sObjectMgr.LoadCreatureLocales();                       // must be after CreatureInfo loading
-    sObjectMgr.LoadGameObjectLocales();                     // must be after GameobjectInfo loading
-    sObjectMgr.LoadItemLocales();                           // must be after ItemPrototypes loading
-    sObjectMgr.LoadQuestLocales();                          // must be after QuestTemplates loading
-    sObjectMgr.LoadGossipTextLocales();                     // must be after LoadGossipText
-    sObjectMgr.LoadPageTextLocales();                       // must be after PageText loading
-    sObjectMgr.LoadGossipMenuItemsLocales();                // must be after gossip menu items loading
-    sObjectMgr.LoadPointOfInterestLocales();                // must be after POI loading
-    sLog.outString(">>> Localization strings loaded");
-    sLog.outString();
-
-    ///- Load dynamic data tables from the database
-    sLog.outString("Loading Auctions...");
-    sLog.outString();
-    sAuctionMgr.LoadAuctionItems();
-    sAuctionMgr.LoadAuctions();
-    sLog.outString(">>> Auctions loaded");
-    sLog.outString();
-
-    sLog.outString("Loading Guilds...");
-    sGuildMgr.LoadGuilds();
-
-    sLog.outString("Loading Groups...");
-    sObjectMgr.LoadGroups();
-
-    sLog.outString("Loading ReservedNames...");
-    sObjectMgr.LoadReservedPlayersNames();
-
-    sLog.outString("Loading GameObjects for quests...");
-    sObjectMgr.LoadGameObjectForQuests();
-
-    sLog.outString("Loading BattleMasters...");
-    sBattleGroundMgr.LoadBattleMastersEntry();
-
-    sLog.outString("Loading BattleGround event indexes...");
-    sBattleGroundMgr.LoadBattleEventIndexes();
-
-    sLog.outString("Loading GameTeleports...");
-    sObjectMgr.LoadGameTele();
-
-    sLog.outString("Loading GM tickets...");
-    sTicketMgr.LoadGMTickets();
-
-    ///- Handle outdated emails (delete/return)
-    sLog.outString("Returning old mails...");
-    sObjectMgr.ReturnOrDeleteOldMails(false);
-
-    ///- Load and initialize scripts
-    sLog.outString("Loading Scripts...");
-    sLog.outString();
-    sScriptMgr.LoadQuestStartScripts();                     // must be after load Creature/Gameobject(Template/Data) and QuestTemplate
-    sScriptMgr.LoadQuestEndScripts();                       // must be after load Creature/Gameobject(Template/Data) and QuestTemplate
-    sScriptMgr.LoadSpellScripts();                          // must be after load Creature/Gameobject(Template/Data)
-    sScriptMgr.LoadGameObjectScripts();                     // must be after load Creature/Gameobject(Template/Data)
-    sScriptMgr.LoadGameObjectTemplateScripts();             // must be after load Creature/Gameobject(Template/Data)
-    sScriptMgr.LoadEventScripts();                          // must be after load Creature/Gameobject(Template/Data)
-    sScriptMgr.LoadCreatureDeathScripts();                  // must be after load Creature/Gameobject(Template/Data)
-    sLog.outString(">>> Scripts loaded");
-    sLog.outString();
-
-    sLog.outString("Loading Scripts text locales...");      // must be after Load*Scripts calls
-    sScriptMgr.LoadDbScriptStrings();
-
-    sLog.outString("Loading CreatureEventAI Texts...");
-    sEventAIMgr.LoadCreatureEventAI_Texts(false);           // false, will checked in LoadCreatureEventAI_Scripts
-
-    sLog.outString("Loading CreatureEventAI Summons...");
-    sEventAIMgr.LoadCreatureEventAI_Summons(false);         // false, will checked in LoadCreatureEventAI_Scripts
-
-    sLog.outString("Loading CreatureEventAI Scripts...");
-    sEventAIMgr.LoadCreatureEventAI_Scripts();
+    ///- Independent loaders run concurrently, each waiting only for the steps it depends on
+    LoadGraph loadGraph;
+
+    uint32 lootStep = loadGraph.AddStep("Loot Tables", &LoadLootTablesStep);
+    loadGraph.AddStep("Skill Fishing base level requirements", &LoadFishingBaseSkillLevelStep);
+    uint32 npcGossipStep = loadGraph.AddStep("Npc Text Id", &LoadNpcGossipsStep);         // must be after load Creature and LoadGossipText
+    // dbscripts_* loaders share quest flags and script checks, so they run one after another
+    uint32 gossipScriptStep = loadGraph.AddStep("Gossip scripts", &LoadGossipScriptsStep);
+    uint32 gossipMenuStep = loadGraph.AddStep("Gossip menus", &LoadGossipMenusStep, gossipScriptStep, npcGossipStep);
+    loadGraph.AddStep("Vendors", &LoadVendorsStep);                                        // must be after load CreatureTemplate, and ItemTemplate
+    loadGraph.AddStep("Trainers", &LoadTrainersStep);                                      // must be after load CreatureTemplate
+    uint32 movementScriptStep = loadGraph.AddStep("Waypoint scripts", &LoadCreatureMovementScriptsStep, gossipScriptStep);
+    uint32 waypointStep = loadGraph.AddStep("Waypoints", &LoadWaypointsStep, movementScriptStep);
+    // locale loaders share the locale index table with the mangos string loaders below
+    uint32 localeStep = loadGraph.AddStep("Localization strings", &LoadLocalesStep, gossipMenuStep);
+    // character database, names first: auctions, guilds and groups look up their characters in the name cache
+    uint32 charNameStep = loadGraph.AddStep("Character names", &LoadCharacterNamesStep);
+    uint32 auctionStep = loadGraph.AddStep("Auctions", &LoadAuctionsStep, charNameStep);
+    uint32 guildStep = loadGraph.AddStep("Guilds", &LoadGuildsStep, auctionStep);
+    uint32 groupStep = loadGraph.AddStep("Groups", &LoadGroupsStep, guildStep);
+    uint32 reservedNameStep = loadGraph.AddStep("ReservedNames", &LoadReservedPlayersNamesStep, groupStep);
+    loadGraph.AddStep("GameObjects for quests", &LoadGameObjectForQuestsStep, lootStep);
+    loadGraph.AddStep("BattleMasters", &LoadBattleMastersStep);
+    loadGraph.AddStep("BattleGround event indexes", &LoadBattleEventIndexesStep);
+    loadGraph.AddStep("GameTeleports", &LoadGameTeleStep);
+    uint32 ticketStep = loadGraph.AddStep("GM tickets", &LoadGMTicketsStep, reservedNameStep);
+    loadGraph.AddStep("old mails", &ReturnOrDeleteOldMailsStep, ticketStep);                 // delete/return outdated mails
+    uint32 scriptStep = loadGraph.AddStep("Scripts", &LoadScriptsStep, movementScriptStep); // must be after load Creature/Gameobject(Template/Data) and QuestTemplate
+    uint32 scriptTextStep = loadGraph.AddStep("Scripts text locales", &LoadDbScriptStringsStep, scriptStep, waypointStep, localeStep);
+    loadGraph.AddStep("CreatureEventAI", &LoadCreatureEventAIStep, scriptTextStep);         // texts are mangos strings as well
+
+    loadGraph.Run(getConfig(CONFIG_UINT32_LOAD_THREADS));
+    loadGraph.Report();
 
     sLog.outString("Initializing Scripts...");
     switch (sScriptMgr.LoadScriptLibrary(MANGOS_SCRIPT_NAME))
@@ -1280,6 +1372,8 @@ void World::SetInitialWorldSettings()
     // for AhBot
     m_timers[WUPDATE_AHBOT].SetInterval(20 * IN_MILLISECONDS); // every 20 sec
 
+    m_timers[WUPDATE_OPCODE_STATS].SetInterval(getConfig(CONFIG_UINT32_OPCODE_STATS_DUMP_INTERVAL) * IN_MILLISECONDS);
+
     // to set mailtimer to return mails every day between 4 and 5 am
     // mailtimer is increased when updating auctions
     // one second is 1000 -(tested on win system)
@@ -1480,6 +1574,15 @@ void World::Update(uint32 diff)
         sObjectAccessor.RemoveOldCorpses();
     }
 
+    ///- Write the opcode handler statistics file
+    if (m_timers[WUPDATE_OPCODE_STATS].Passed())
+    {
+        m_timers[WUPDATE_OPCODE_STATS].Reset();
+
+        if (getConfig(CONFIG_UINT32_OPCODE_STATS_DUMP_INTERVAL) && !m_opcodeStatsFile.empty() && !sOpcodeProfiler.Dump(m_opcodeStatsFile))
+            { sLog.outError("Can not write opcode statistics to %s", m_opcodeStatsFile.c_str()); }
+    }
+
     ///- Process Game events when necessary
     if (m_timers[WUPDATE_EVENTS].Passed())
     {
@@ -1493,8 +1596,8 @@ void World::Update(uint32 diff)
     ///- Move all creatures with "delayed move" and remove and delete all objects with "delayed remove"
     sMapMgr.RemoveAllObjectsInRemoveList();
 
-    // update the instance reset times
-    sMapPersistentStateMgr.Update();
+    // update the instance reset times and save collected respawn times
+    sMapPersistentStateMgr.Update(diff);
 
     if (m_MaintenanceTimeChecker < diff)
     {
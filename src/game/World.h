@@ -80,7 +80,8 @@ enum WorldTimers
     WUPDATE_EVENTS      = 4,
     WUPDATE_DELETECHARS = 5,
     WUPDATE_AHBOT       = 6,
-    WUPDATE_COUNT       = 7
+    WUPDATE_OPCODE_STATS = 7,
+    WUPDATE_COUNT       = 8
 };
 
 /// Configuration elements
@@ -88,6 +89,7 @@ enum eConfigUInt32Values
 {
     CONFIG_UINT32_COMPRESSION = 0,
     CONFIG_UINT32_INTERVAL_SAVE,
+    CONFIG_UINT32_INTERVAL_SAVE_RESPAWN,
     CONFIG_UINT32_INTERVAL_GRIDCLEAN,
     CONFIG_UINT32_INTERVAL_MAPUPDATE,
     CONFIG_UINT32_INTERVAL_CHANGEWEATHER,
@@ -129,6 +131,8 @@ enum eConfigUInt32Values
     CONFIG_UINT32_START_GM_LEVEL,
     CONFIG_UINT32_GM_INVISIBLE_AURA,
     CONFIG_UINT32_GROUP_VISIBILITY,
+    CONFIG_UINT32_GROUP_MEMBER_STATS_INTERVAL,
+    CONFIG_UINT32_GROUP_MEMBER_POSITION_INTERVAL,
     CONFIG_UINT32_MAIL_DELIVERY_DELAY,
     CONFIG_UINT32_MASS_MAILER_SEND_PER_TICK,
     CONFIG_UINT32_UPTIME_UPDATE,
@@ -177,6 +181,10 @@ enum eConfigUInt32Values
     CONFIG_UINT32_GUID_RESERVE_SIZE_CREATURE,
     CONFIG_UINT32_GUID_RESERVE_SIZE_GAMEOBJECT,
     CONFIG_UINT32_CREATURE_RESPAWN_AGGRO_DELAY,
+    CONFIG_UINT32_CREATURE_IDLE_UPDATE_INTERVAL,
+    CONFIG_UINT32_LOAD_THREADS,
+    CONFIG_UINT32_OPCODE_STATS_DUMP_INTERVAL,
+    CONFIG_UINT32_OPCODE_STATS_OUTLIER_TIME,
     CONFIG_UINT32_VALUE_COUNT,
     CONFIG_UINT32_LOG_WHISPERS
 };
@@ -317,6 +325,7 @@ enum eConfigBoolValues
     CONFIG_BOOL_MMAP_ENABLED,
     CONFIG_BOOL_ELUNA_ENABLED,
     CONFIG_BOOL_PLAYER_COMMANDS,
+    CONFIG_BOOL_OPCODE_STATS_ENABLED,
     CONFIG_BOOL_VALUE_COUNT
 };
 
@@ -614,6 +623,7 @@ class World
         bool m_allowMovement;
         std::string m_motd;
         std::string m_dataPath;
+        std::string m_opcodeStatsFile;                      // with logs dir, empty if not dumped
 
         // for max speed access
         static float m_MaxVisibleDistanceOnContinents;
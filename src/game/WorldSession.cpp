@@ -44,6 +44,7 @@
 #include "MapManager.h"
 #include "SocialMgr.h"
 #include "LuaEngine.h"
+#include "OpcodeProfiler.h"
 
 // select opcodes appropriate for processing in Map::Update context for current session state
 static bool MapSessionFilterHelper(WorldSession* session, OpcodeHandler const& opHandle)
@@ -133,12 +134,9 @@ char const* WorldSession::GetPlayerName() const
     return GetPlayer() ? GetPlayer()->GetName() : "<none>";
 }
 
-/// Send a packet to the client
-void WorldSession::SendPacket(WorldPacket const* packet)
+/// Network use statistic of the sent packets, debug builds only
+static void CountSentPacket(WorldPacket const* packet)
 {
-    if (!m_Socket)
-        { return; }
-
 #ifdef MANGOS_DEBUG
 
     // Code for network use statistic
@@ -174,11 +172,35 @@ void WorldSession::SendPacket(WorldPacket const* packet)
     }
 
 #endif                                                  // !MANGOS_DEBUG
+}
+
+/// Send a packet to the client
+void WorldSession::SendPacket(WorldPacket const* packet)
+{
+    if (!m_Socket)
+        { return; }
+
+    CountSentPacket(packet);
 
     if (m_Socket->SendPacket(*packet) == -1)
         { m_Socket->CloseSocket(); }
 }
 
+/// Send a packet the caller is done with, handing its storage to the socket
+void WorldSession::SendOwnedPacket(WorldPacket& packet)
+{
+    if (!m_Socket)
+        { return; }
+
+    CountSentPacket(&packet);
+
+    if (m_Socket->SendOwnedPacket(packet) == -1)
+        { m_Socket->CloseSocket(); }
+
+    // the socket either copied the data out or took the storage, leave it ready for reuse
+    packet.clear();
+}
+
 /// Add an incoming packet to the queue
 void WorldSession::QueuePacket(WorldPacket* new_packet)
 {
@@ -713,6 +735,8 @@ void WorldSession::ExecuteOpcode(OpcodeHandler const& opHandle, WorldPacket* pac
     if (_player)
         { _player->SetCanDelayTeleport(true); }
 
+    OpcodeProfiler::Scope profile(this, *packet);
+
     (this->*opHandle.handler)(*packet);
 
     if (_player)
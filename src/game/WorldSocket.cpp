@@ -87,6 +87,7 @@ WorldSocket::WorldSocket(void) :
     m_OutBuffer(0),
     m_OutBufferSize(65536),
     m_OutActive(false),
+    m_NetStats(NULL),
     m_Seed(static_cast<uint32>(rand32()))
 {
     reference_counting_policy().value(ACE_Event_Handler::Reference_Counting_Policy::ENABLED);
@@ -138,25 +139,37 @@ const std::string& WorldSocket::GetRemoteAddress(void) const
 }
 
 int WorldSocket::SendPacket(const WorldPacket& pkt)
+{
+    // the send hook may rewrite the packet, work on a private copy
+    WorldPacket pct = pkt;
+
+    return SendOwnedPacket(pct);
+}
+
+int WorldSocket::SendOwnedPacket(WorldPacket& pct)
 {
     ACE_GUARD_RETURN(LockType, Guard, m_OutBufferLock, -1);
 
     if (closing_)
         { return -1; }
 
-    WorldPacket pct = pkt;
-
     // Dump outgoing packet.
     sLog.outWorldPacketDump(uint32(get_handle()), pct.GetOpcode(), pct.GetOpcodeName(), &pct, false);
 
     if (!sEluna->OnPacketSend(m_Session, pct))
         return 0;
 
+    if (m_NetStats)
+        { ++m_NetStats->packetsOut; }
+
     if (iSendPacket(pct) == -1)
     {
         WorldPacket* npct;
 
-        ACE_NEW_RETURN(npct, WorldPacket(pct), -1);
+        ACE_NEW_RETURN(npct, WorldPacket(), -1);
+
+        // pct is owned by us, hand its storage over instead of copying it again
+        npct->swap(pct);
 
         // NOTE maybe check of the size of the queue can be good ?
         // to make it bounded instead of unbounded
@@ -296,6 +309,9 @@ int WorldSocket::handle_output(ACE_HANDLE)
     ssize_t n = peer().send(m_OutBuffer->rd_ptr(), send_len);
 #endif // MSG_NOSIGNAL
 
+    if (n > 0 && m_NetStats)
+        { m_NetStats->bytesOut += long(n); }
+
     if (n == 0)
         { return -1; }
     else if (n == -1)
@@ -409,6 +425,9 @@ int WorldSocket::handle_input_payload(void)
     MANGOS_ASSERT(m_Header.space() == 0);
     MANGOS_ASSERT(m_RecvWPct != NULL);
 
+    if (m_NetStats)
+        { ++m_NetStats->packetsIn; }
+
     const int ret = ProcessIncoming(m_RecvWPct);
 
     m_RecvPct.base(NULL, 0);
@@ -447,6 +466,9 @@ int WorldSocket::handle_input_missing_data(void)
     if (n <= 0)
         { return (int)n; }
 
+    if (m_NetStats)
+        { m_NetStats->bytesIn += long(n); }
+
     message_block.wr_ptr(n);
 
     while (message_block.length() > 0)
@@ -968,3 +990,29 @@ bool WorldSocket::iFlushPacketQueue()
 
     return haveone;
 }
+
+int WorldSocketListener::open(const ACE_Addr& local_sap, int reuse_addr, int protocol_family, int backlog, int protocol)
+{
+    if (!m_ReusePort)
+        { return ACE_SOCK_Acceptor::open(local_sap, reuse_addr, protocol_family, backlog, protocol); }
+
+    if (local_sap != ACE_Addr::sap_any)
+        { protocol_family = local_sap.get_type(); }
+    else if (protocol_family == PF_UNSPEC)
+        { protocol_family = PF_INET; }
+
+    if (ACE_SOCK::open(SOCK_STREAM, protocol_family, protocol, reuse_addr) == -1)
+        { return -1; }
+
+#ifdef SO_REUSEPORT
+    // must be set before binding, every network thread binds the same address
+    int one = 1;
+    if (set_option(SOL_SOCKET, SO_REUSEPORT, &one, sizeof(one)) == -1)
+    {
+        close();
+        return -1;
+    }
+#endif
+
+    return shared_open(local_sap, protocol_family, backlog);
+}
@@ -52,10 +52,27 @@
 class ACE_Message_Block;
 class WorldPacket;
 class WorldSession;
+struct NetworkThreadStats;
 
 /// Handler that can communicate over stream sockets.
 typedef ACE_Svc_Handler<ACE_SOCK_STREAM, ACE_NULL_SYNCH> WorldHandler;
 
+/// Listening socket that can share its port with the listeners of other network threads.
+class WorldSocketListener : public ACE_SOCK_Acceptor
+{
+    public:
+        WorldSocketListener() : m_ReusePort(false) {}
+
+        /// Set SO_REUSEPORT on the socket opened by the next open() call.
+        void SetReusePort(bool reusePort) { m_ReusePort = reusePort; }
+
+        /// Same as ACE_SOCK_Acceptor::open, with SO_REUSEPORT set before binding if requested.
+        int open(const ACE_Addr& local_sap, int reuse_addr = 0, int protocol_family = PF_UNSPEC, int backlog = ACE_DEFAULT_BACKLOG, int protocol = 0);
+
+    private:
+        bool m_ReusePort;
+};
+
 /**
  * WorldSocket.
  *
@@ -96,12 +113,12 @@ class WorldSocket : protected WorldHandler
 {
     public:
         /// Declare some friends
-        friend class ACE_Acceptor< WorldSocket, ACE_SOCK_ACCEPTOR >;
+        friend class ACE_Acceptor< WorldSocket, WorldSocketListener >;
         friend class WorldSocketMgr;
         friend class ReactorRunnable;
 
         /// Declare the acceptor for this class
-        typedef ACE_Acceptor< WorldSocket, ACE_SOCK_ACCEPTOR > Acceptor;
+        typedef ACE_Acceptor< WorldSocket, WorldSocketListener > Acceptor;
 
         /// Mutex type used for various synchronizations.
         typedef ACE_Thread_Mutex LockType;
@@ -124,6 +141,13 @@ class WorldSocket : protected WorldHandler
         /// @return -1 of failure
         int SendPacket(const WorldPacket& pct);
 
+        /// Send a packet the caller has no further use for, this function is reentrant.
+        /// The send hook works on pct directly and a packet that has to be
+        /// queued takes over its storage instead of being copied.
+        /// @param pct packet to send, its contents are unspecified afterwards
+        /// @return -1 of failure
+        int SendOwnedPacket(WorldPacket& pct);
+
         /// Add reference to this object.
         long AddReference(void);
 
@@ -231,6 +255,9 @@ class WorldSocket : protected WorldHandler
         /// True if the socket is registered with the reactor for output
         bool m_OutActive;
 
+        /// Counters of the network thread handling the socket
+        NetworkThreadStats* m_NetStats;
+
         uint32 m_Seed;
 };
 
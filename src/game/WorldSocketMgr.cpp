@@ -37,6 +37,7 @@
 #include <ace/Dev_Poll_Reactor.h>
 #include <ace/Guard_T.h>
 #include <ace/Atomic_Op.h>
+#include <ace/OS_NS_unistd.h>
 #include <ace/os_include/arpa/os_inet.h>
 #include <ace/os_include/netinet/os_tcp.h>
 #include <ace/os_include/sys/os_types.h>
@@ -44,6 +45,11 @@
 
 #include <set>
 
+#if PLATFORM == PLATFORM_UNIX && defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
 #include "Log.h"
 #include "Common.h"
 #include "Config/Config.h"
@@ -60,8 +66,9 @@ class ReactorRunnable : protected ACE_Task_Base
     public:
         ReactorRunnable() :
             m_Reactor(0),
-            m_Connections(0),
-            m_ThreadId(-1)
+            m_ThreadId(-1),
+            m_Cpu(-1),
+            m_Acceptor(0)
         {
             ACE_Reactor_Impl* imp = 0;
 
@@ -87,9 +94,28 @@ class ReactorRunnable : protected ACE_Task_Base
             Stop();
             Wait();
 
+            delete m_Acceptor;
             delete m_Reactor;
         }
 
+        /// Open a listening socket handled by this thread's reactor
+        int Listen(const ACE_INET_Addr& listen_addr, bool reusePort)
+        {
+            m_Acceptor = new WorldSocket::Acceptor;
+            m_Acceptor->acceptor().SetReusePort(reusePort);
+
+            return m_Acceptor->open(listen_addr, m_Reactor, ACE_NONBLOCK);
+        }
+
+        void CloseListener()
+        {
+            if (m_Acceptor)
+                { m_Acceptor->close(); }
+        }
+
+        /// Pin the thread to a processor when it starts, -1 for no affinity
+        void SetCpu(int cpu) { m_Cpu = cpu; }
+
         void Stop()
         {
             m_Reactor->end_reactor_event_loop();
@@ -107,21 +133,27 @@ class ReactorRunnable : protected ACE_Task_Base
 
         long Connections()
         {
-            return static_cast<long>(m_Connections.value());
+            return static_cast<long>(m_Stats.connections.value());
         }
 
         int AddSocket(WorldSocket* sock)
         {
             ACE_GUARD_RETURN(ACE_Thread_Mutex, Guard, m_NewSockets_Lock, -1);
 
-            ++m_Connections;
+            ++m_Stats.connections;
             sock->AddReference();
             sock->reactor(m_Reactor);
+            sock->m_NetStats = &m_Stats;
             m_NewSockets.insert(sock);
 
             return 0;
         }
 
+        NetworkThreadStats& GetStats()
+        {
+            return m_Stats;
+        }
+
         ACE_Reactor* GetReactor()
         {
             return m_Reactor;
@@ -142,7 +174,7 @@ class ReactorRunnable : protected ACE_Task_Base
                 if (sock->IsClosed())
                 {
                     sock->RemoveReference();
-                    --m_Connections;
+                    --m_Stats.connections;
                 }
                 else
                     { m_Sockets.insert(sock); }
@@ -155,6 +187,9 @@ class ReactorRunnable : protected ACE_Task_Base
         {
             DEBUG_LOG("Network Thread Starting");
 
+            if (m_Cpu >= 0)
+                { BindToCpu(); }
+
             WorldDatabase.ThreadStart();
 
             MANGOS_ASSERT(m_Reactor);
@@ -180,7 +215,7 @@ class ReactorRunnable : protected ACE_Task_Base
                         ++i;
                         (*t)->CloseSocket();
                         (*t)->RemoveReference();
-                        --m_Connections;
+                        --m_Stats.connections;
                         m_Sockets.erase(t);
                     }
                     else
@@ -196,12 +231,30 @@ class ReactorRunnable : protected ACE_Task_Base
         }
 
     private:
-        typedef ACE_Atomic_Op<ACE_SYNCH_MUTEX, long> AtomicInt;
+        void BindToCpu()
+        {
+#if PLATFORM == PLATFORM_WINDOWS
+            if (!SetThreadAffinityMask(GetCurrentThread(), DWORD_PTR(1) << m_Cpu))
+                { sLog.outError("Network thread could not be bound to processor %d", m_Cpu); }
+#elif defined(__linux__)
+            cpu_set_t cpus;
+            CPU_ZERO(&cpus);
+            CPU_SET(m_Cpu, &cpus);
+            if (pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus) != 0)
+                { sLog.outError("Network thread could not be bound to processor %d", m_Cpu); }
+#else
+            sLog.outError("Network.CpuAffinity is not supported on this platform");
+#endif
+        }
+
         typedef std::set<WorldSocket*> SocketSet;
 
         ACE_Reactor* m_Reactor;
-        AtomicInt m_Connections;
+        NetworkThreadStats m_Stats;
         int m_ThreadId;
+        int m_Cpu;
+
+        WorldSocket::Acceptor* m_Acceptor;
 
         SocketSet m_Sockets;
 
@@ -215,32 +268,56 @@ WorldSocketMgr::WorldSocketMgr():
     m_SockOutKBuff(-1),
     m_SockOutUBuff(65536),
     m_UseNoDelay(true),
-    m_Acceptor(0)
+    m_ReusePort(false)
 {
 }
 
 WorldSocketMgr::~WorldSocketMgr()
 {
     delete[] m_NetThreads;
-    delete m_Acceptor;
 }
 
 int WorldSocketMgr::StartReactiveIO(ACE_UINT16 port, const char* address)
 {
     m_UseNoDelay = sConfig.GetBoolDefault("Network.TcpNodelay", true);
 
-    int num_threads = sConfig.GetIntDefault("Network.Threads", 1);
+    int num_threads = sConfig.GetIntDefault("Network.Threads", 0);
 
-    if (num_threads <= 0)
+    if (num_threads < 0)
     {
         sLog.outError("Network.Threads is wrong in your config file");
         return -1;
     }
 
-    m_NetThreadsCount = static_cast<size_t>(num_threads + 1);
+    if (num_threads == 0)
+        { num_threads = ACE_OS::num_processors_online() > 0 ? int(ACE_OS::num_processors_online()) : 1; }
+
+#if defined(SO_REUSEPORT) && defined(__linux__)
+    // the kernel spreads new connections over all listening sockets of a port
+    m_ReusePort = sConfig.GetBoolDefault("Network.ReusePort", true);
+#else
+    m_ReusePort = false;
+#endif
+
+    // without own listeners an extra thread does the accepting
+    m_NetThreadsCount = static_cast<size_t>(m_ReusePort ? num_threads : num_threads + 1);
 
     m_NetThreads = new ReactorRunnable[m_NetThreadsCount];
 
+    if (uint32 cpuMask = uint32(sConfig.GetIntDefault("Network.CpuAffinity", 0)))
+    {
+        // thread i is pinned to the i-th processor of the mask, wrapping around
+        std::vector<int> cpus;
+        for (int cpu = 0; cpu < 32; ++cpu)
+        {
+            if (cpuMask & (1u << cpu))
+                { cpus.push_back(cpu); }
+        }
+
+        for (size_t i = 0; i < m_NetThreadsCount; ++i)
+            { m_NetThreads[i].SetCpu(cpus[i % cpus.size()]); }
+    }
+
     BASIC_LOG("Max allowed socket connections %d", ACE::max_handles());
 
     // -1 means use default
@@ -254,17 +331,32 @@ int WorldSocketMgr::StartReactiveIO(ACE_UINT16 port, const char* address)
         return -1;
     }
 
-    WorldSocket::Acceptor* acc = new WorldSocket::Acceptor;
-    m_Acceptor = acc;
-
     ACE_INET_Addr listen_addr(port, address);
 
-    if (acc->open(listen_addr, m_NetThreads[0].GetReactor(), ACE_NONBLOCK) == -1)
+    if (m_ReusePort)
     {
-        sLog.outError("Failed to open acceptor, check if the port is free");
-        return -1;
+        // SO_REUSEPORT listeners would silently share the port with another running server,
+        // a plain bind still fails while anyone listens on it
+        ACE_SOCK_Acceptor probe;
+        if (probe.open(listen_addr, 1) == -1)
+        {
+            sLog.outError("Failed to open acceptor, check if the port is free");
+            return -1;
+        }
+        probe.close();
     }
 
+    for (size_t i = 0; i < (m_ReusePort ? m_NetThreadsCount : 1); ++i)
+    {
+        if (m_NetThreads[i].Listen(listen_addr, m_ReusePort) == -1)
+        {
+            sLog.outError("Failed to open acceptor, check if the port is free");
+            return -1;
+        }
+    }
+
+    BASIC_LOG("Using %u network threads%s", uint32(m_NetThreadsCount), m_ReusePort ? ", each listening with SO_REUSEPORT" : "");
+
     for (size_t i = 0; i < m_NetThreadsCount; ++i)
         { m_NetThreads[i].Start(); }
 
@@ -284,13 +376,8 @@ int WorldSocketMgr::StartNetwork(ACE_UINT16 port, std::string& address)
 
 void WorldSocketMgr::StopNetwork()
 {
-    if (m_Acceptor)
-    {
-        WorldSocket::Acceptor* acc = dynamic_cast<WorldSocket::Acceptor*>(m_Acceptor);
-
-        if (acc)
-            { acc->close(); }
-    }
+    for (size_t i = 0; i < m_NetThreadsCount; ++i)
+        { m_NetThreads[i].CloseListener(); }
 
     if (m_NetThreadsCount != 0)
     {
@@ -336,6 +423,21 @@ int WorldSocketMgr::OnSocketOpen(WorldSocket* sock)
 
     sock->m_OutBufferSize = static_cast<size_t>(m_SockOutUBuff);
 
+    // a socket stays on the thread whose listener accepted it
+    if (m_ReusePort)
+    {
+        for (size_t i = 0; i < m_NetThreadsCount; ++i)
+        {
+            if (m_NetThreads[i].GetReactor() == sock->reactor())
+            {
+                ++m_NetThreads[i].GetStats().accepted;
+                return m_NetThreads[i].AddSocket(sock);
+            }
+        }
+    }
+
+    ++m_NetThreads[0].GetStats().accepted;
+
     // we skip the Acceptor Thread
     size_t min = 1;
 
@@ -348,6 +450,12 @@ int WorldSocketMgr::OnSocketOpen(WorldSocket* sock)
     return m_NetThreads[min].AddSocket(sock);
 }
 
+NetworkThreadStats const& WorldSocketMgr::GetNetworkThreadStats(size_t index) const
+{
+    MANGOS_ASSERT(index < m_NetThreadsCount);
+    return m_NetThreads[index].GetStats();
+}
+
 WorldSocketMgr* WorldSocketMgr::Instance()
 {
     return ACE_Singleton<WorldSocketMgr, ACE_Thread_Mutex>::instance();
@@ -31,6 +31,7 @@
 #ifndef MANGOS_H_WORLDSOCKETMGR
 #define MANGOS_H_WORLDSOCKETMGR
 
+#include <ace/Atomic_Op.h>
 #include <ace/Basic_Types.h>
 #include <ace/Singleton.h>
 #include <ace/Thread_Mutex.h>
@@ -39,7 +40,21 @@
 
 class WorldSocket;
 class ReactorRunnable;
-class ACE_Event_Handler;
+
+/// Traffic counters of one network thread
+struct NetworkThreadStats
+{
+    typedef ACE_Atomic_Op<ACE_Thread_Mutex, long> Counter;
+
+    NetworkThreadStats() : connections(0), accepted(0), bytesIn(0), bytesOut(0), packetsIn(0), packetsOut(0) {}
+
+    Counter connections;                                    ///< sockets currently handled
+    Counter accepted;                                       ///< sockets accepted by the thread's listener
+    Counter bytesIn;
+    Counter bytesOut;
+    Counter packetsIn;
+    Counter packetsOut;
+};
 
 /// Manages all sockets connected to peers and network threads
 class WorldSocketMgr
@@ -60,6 +75,12 @@ class WorldSocketMgr
         /// Make this class singleton .
         static WorldSocketMgr* Instance();
 
+        /// Number of network threads, including a dedicated acceptor thread .
+        size_t GetNetworkThreadCount() const { return m_NetThreadsCount; }
+
+        /// Counters of a network thread .
+        NetworkThreadStats const& GetNetworkThreadStats(size_t index) const;
+
     private:
         int OnSocketOpen(WorldSocket* sock);
         int StartReactiveIO(ACE_UINT16 port, const char* address);
@@ -74,10 +95,11 @@ class WorldSocketMgr
         int m_SockOutUBuff;
         bool m_UseNoDelay;
 
+        /// each network thread listens on its own SO_REUSEPORT socket
+        bool m_ReusePort;
+
         std::string m_addr;
         ACE_UINT16 m_port;
-
-        ACE_Event_Handler* m_Acceptor;
 };
 
 #define sWorldSocketMgr WorldSocketMgr::Instance()
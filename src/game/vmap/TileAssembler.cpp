@@ -32,6 +32,8 @@
 #include <sstream>
 #include <iomanip>
 
+#include <ace/Thread_Manager.h>
+
 using G3D::Vector3;
 using G3D::AABox;
 using G3D::inf;
@@ -44,6 +46,68 @@ template<> struct BoundsTrait<VMAP::ModelSpawn*>
 
 namespace VMAP
 {
+    /// file in the destination directory keeping the content hashes of the last run
+    static const char ASSEMBLER_HASH_CACHE[] = "assembler_hash_cache";
+
+    static const uint64 FNV_OFFSET_BASIS = 14695981039346656037ULL;
+    static const uint64 FNV_PRIME = 1099511628211ULL;
+
+    /// FNV-1a, good enough to notice changed input files
+    static uint64 hashBytes(uint64 hash, const void* data, size_t len)
+    {
+        const uint8* bytes = static_cast<const uint8*>(data);
+        for (size_t i = 0; i < len; ++i)
+        {
+            hash ^= bytes[i];
+            hash *= FNV_PRIME;
+        }
+        return hash;
+    }
+
+    static bool hashFile(const std::string& pFileName, uint64& pHash)
+    {
+        FILE* rf = fopen(pFileName.c_str(), "rb");
+        if (!rf)
+            { return false; }
+
+        char buffer[0x10000];
+        pHash = FNV_OFFSET_BASIS;
+        while (size_t read = fread(buffer, 1, sizeof(buffer), rf))
+            { pHash = hashBytes(pHash, buffer, read); }
+
+        bool success = (ferror(rf) == 0);
+        fclose(rf);
+        return success;
+    }
+
+    static bool fileExists(const std::string& pFileName)
+    {
+        if (FILE* f = fopen(pFileName.c_str(), "rb"))
+        {
+            fclose(f);
+            return true;
+        }
+        return false;
+    }
+
+    /// what a worker thread runs, see TileAssembler::runWorkers
+    struct AssemblerWorkerTask
+    {
+        TileAssembler* assembler;
+        void (TileAssembler::*work)();
+    };
+
+    static ACE_THR_FUNC_RETURN AssemblerWorker(void* arg)
+    {
+        AssemblerWorkerTask* task = static_cast<AssemblerWorkerTask*>(arg);
+        (task->assembler->*task->work)();
+        return 0;
+    }
+
+    MapSpawns::MapSpawns() : SpawnsHash(FNV_OFFSET_BASIS)
+    {
+    }
+
     bool readChunk(FILE* rf, char* dest, const char* compare, uint32 len)
     {
         if (fread(dest, sizeof(char), len, rf) != len) { return false; }
@@ -59,8 +123,10 @@ namespace VMAP
 
     //=================================================================
 
-    TileAssembler::TileAssembler(const std::string& pSrcDirName, const std::string& pDestDirName)
+    TileAssembler::TileAssembler(const std::string& pSrcDirName, const std::string& pDestDirName, uint32 pThreads)
     {
+        iThreads = pThreads ? pThreads : 1;
+        iFailed = false;
         iCurrentUniqueNameId = 0;
         iFilterMethod = NULL;
         iSrcDir = pSrcDirName;
@@ -80,130 +146,295 @@ namespace VMAP
         if (!success)
             { return false; }
 
-        // export Map data
-        for (MapData::iterator map_iter = mapData.begin(); map_iter != mapData.end() && success; ++map_iter)
+        // collect the models spawned on maps, M2 bounds are calculated per map later on
+        for (MapData::iterator map_iter = mapData.begin(); map_iter != mapData.end(); ++map_iter)
         {
-            // build global map tree
-            std::vector<ModelSpawn*> mapSpawns;
             UniqueEntryMap::iterator entry;
-            printf("Calculating model bounds for map %u...\n", map_iter->first);
             for (entry = map_iter->second->UniqueEntries.begin(); entry != map_iter->second->UniqueEntries.end(); ++entry)
+                { spawnedModelFiles.insert(entry->second.name); }
+        }
+
+        // add an object models, listed in temp_gameobject_models file
+        exportGameobjectModels();
+
+        readHashCache();
+
+        // export objects
+        std::cout << "\nConverting Model Files" << std::endl;
+        for (std::set<std::string>::iterator mfile = spawnedModelFiles.begin(); mfile != spawnedModelFiles.end(); ++mfile)
+            { iModelQueue.add(*mfile); }
+        runWorkers(&TileAssembler::convertQueuedModels);
+        success = !iFailed;
+
+        // export Map data, map hashes include the hashes of the M2 models used for bounds
+        if (success)
+        {
+            for (MapData::iterator map_iter = mapData.begin(); map_iter != mapData.end(); ++map_iter)
+                { iMapQueue.add(map_iter->first); }
+            runWorkers(&TileAssembler::convertQueuedMaps);
+            success = !iFailed;
+        }
+
+        // only what was written successfully is stored, so failed parts are redone next run
+        writeHashCache();
+
+        // cleanup:
+        for (MapData::iterator map_iter = mapData.begin(); map_iter != mapData.end(); ++map_iter)
+        {
+            delete map_iter->second;
+        }
+        return success;
+    }
+
+    bool TileAssembler::convertMap(uint32 pMapId, MapSpawns* pSpawns)
+    {
+        bool success = true;
+
+        // build global map tree
+        std::vector<ModelSpawn*> mapSpawns;
+        UniqueEntryMap::iterator entry;
+        printf("Calculating model bounds for map %u...\n", pMapId);
+        for (entry = pSpawns->UniqueEntries.begin(); entry != pSpawns->UniqueEntries.end(); ++entry)
+        {
+            // M2 models don't have a bound set in WDT/ADT placement data, i still think they're not used for LoS at all on retail
+            if (entry->second.flags & MOD_M2)
             {
-                // M2 models don't have a bound set in WDT/ADT placement data, i still think they're not used for LoS at all on retail
-                if (entry->second.flags & MOD_M2)
-                {
-                    if (!calculateTransformedBound(entry->second))
-                        { break; }
-                }
-                else if (entry->second.flags & MOD_WORLDSPAWN) // WMO maps and terrain maps use different origin, so we need to adapt :/
-                {
-                    // TODO: remove extractor hack and uncomment below line:
-                    // entry->second.iPos += Vector3(533.33333f*32, 533.33333f*32, 0.f);
-                    entry->second.iBound = entry->second.iBound + Vector3(533.33333f * 32, 533.33333f * 32, 0.f);
-                }
-                mapSpawns.push_back(&(entry->second));
-                spawnedModelFiles.insert(entry->second.name);
+                if (!calculateTransformedBound(entry->second))
+                    { break; }
+            }
+            else if (entry->second.flags & MOD_WORLDSPAWN) // WMO maps and terrain maps use different origin, so we need to adapt :/
+            {
+                // TODO: remove extractor hack and uncomment below line:
+                // entry->second.iPos += Vector3(533.33333f*32, 533.33333f*32, 0.f);
+                entry->second.iBound = entry->second.iBound + Vector3(533.33333f * 32, 533.33333f * 32, 0.f);
             }
+            mapSpawns.push_back(&(entry->second));
+        }
 
-            printf("Creating map tree...\n");
-            BIH pTree;
-            pTree.build(mapSpawns, BoundsTrait<ModelSpawn*>::getBounds);
+        printf("Creating map tree for map %u...\n", pMapId);
+        BIH pTree;
+        pTree.build(mapSpawns, BoundsTrait<ModelSpawn*>::getBounds);
 
-            // ===> possibly move this code to StaticMapTree class
-            std::map<uint32, uint32> modelNodeIdx;
-            for (uint32 i = 0; i < mapSpawns.size(); ++i)
-                { modelNodeIdx.insert(pair<uint32, uint32>(mapSpawns[i]->ID, i)); }
+        // ===> possibly move this code to StaticMapTree class
+        std::map<uint32, uint32> modelNodeIdx;
+        for (uint32 i = 0; i < mapSpawns.size(); ++i)
+            { modelNodeIdx.insert(pair<uint32, uint32>(mapSpawns[i]->ID, i)); }
 
-            // write map tree file
-            std::stringstream mapfilename;
-            mapfilename << iDestDir << "/" << std::setfill('0') << std::setw(3) << map_iter->first << ".vmtree";
-            FILE* mapfile = fopen(mapfilename.str().c_str(), "wb");
-            if (!mapfile)
+        // write map tree file
+        std::stringstream mapfilename;
+        mapfilename << iDestDir << "/" << std::setfill('0') << std::setw(3) << pMapId << ".vmtree";
+        FILE* mapfile = fopen(mapfilename.str().c_str(), "wb");
+        if (!mapfile)
+        {
+            printf("Can not open %s\n", mapfilename.str().c_str());
+            return false;
+        }
+
+        // general info
+        if (success && fwrite(VMAP_MAGIC, 1, 8, mapfile) != 8) { success = false; }
+        uint32 globalTileID = StaticMapTree::packTileID(65, 65);
+        pair<TileMap::iterator, TileMap::iterator> globalRange = pSpawns->TileEntries.equal_range(globalTileID);
+        char isTiled = globalRange.first == globalRange.second; // only maps without terrain (tiles) have global WMO
+        if (success && fwrite(&isTiled, sizeof(char), 1, mapfile) != 1) { success = false; }
+        // Nodes
+        if (success && fwrite("NODE", 4, 1, mapfile) != 1) { success = false; }
+        if (success) { success = pTree.writeToFile(mapfile); }
+        // global map spawns (WDT), if any (most instances)
+        if (success && fwrite("GOBJ", 4, 1, mapfile) != 1) { success = false; }
+
+        for (TileMap::iterator glob = globalRange.first; glob != globalRange.second && success; ++glob)
+        {
+            success = ModelSpawn::writeToFile(mapfile, pSpawns->UniqueEntries[glob->second]);
+        }
+
+        fclose(mapfile);
+
+        // <====
+
+        // write map tile files, similar to ADT files, only with extra BSP tree node info
+        TileMap& tileEntries = pSpawns->TileEntries;
+        TileMap::iterator tile;
+        for (tile = tileEntries.begin(); tile != tileEntries.end(); ++tile)
+        {
+            const ModelSpawn& spawn = pSpawns->UniqueEntries[tile->second];
+            if (spawn.flags & MOD_WORLDSPAWN)           // WDT spawn, saved as tile 65/65 currently...
+                { continue; }
+            uint32 nSpawns = tileEntries.count(tile->first);
+            std::stringstream tilefilename;
+            tilefilename.fill('0');
+            tilefilename << iDestDir << "/" << std::setw(3) << pMapId << "_";
+            uint32 x, y;
+            StaticMapTree::unpackTileID(tile->first, x, y);
+            tilefilename << std::setw(2) << x << "_" << std::setw(2) << y << ".vmtile";
+            FILE* tilefile = fopen(tilefilename.str().c_str(), "wb");
+            // file header
+            if (success && fwrite(VMAP_MAGIC, 1, 8, tilefile) != 8) { success = false; }
+            // write number of tile spawns
+            if (success && fwrite(&nSpawns, sizeof(uint32), 1, tilefile) != 1) { success = false; }
+            // write tile spawns
+            for (uint32 s = 0; s < nSpawns; ++s)
             {
-                success = false;
-                printf("Can not open %s\n", mapfilename.str().c_str());
-                break;
+                if (s && tile != tileEntries.end())
+                    { ++tile; }
+                const ModelSpawn& spawn2 = pSpawns->UniqueEntries[tile->second];
+                success = success && ModelSpawn::writeToFile(tilefile, spawn2);
+                // MapTree nodes to update when loading tile:
+                std::map<uint32, uint32>::iterator nIdx = modelNodeIdx.find(spawn2.ID);
+                if (success && fwrite(&nIdx->second, sizeof(uint32), 1, tilefile) != 1) { success = false; }
             }
+            fclose(tilefile);
+        }
 
-            // general info
-            if (success && fwrite(VMAP_MAGIC, 1, 8, mapfile) != 8) { success = false; }
-            uint32 globalTileID = StaticMapTree::packTileID(65, 65);
-            pair<TileMap::iterator, TileMap::iterator> globalRange = map_iter->second->TileEntries.equal_range(globalTileID);
-            char isTiled = globalRange.first == globalRange.second; // only maps without terrain (tiles) have global WMO
-            if (success && fwrite(&isTiled, sizeof(char), 1, mapfile) != 1) { success = false; }
-            // Nodes
-            if (success && fwrite("NODE", 4, 1, mapfile) != 1) { success = false; }
-            if (success) { success = pTree.writeToFile(mapfile); }
-            // global map spawns (WDT), if any (most instances)
-            if (success && fwrite("GOBJ", 4, 1, mapfile) != 1) { success = false; }
-
-            for (TileMap::iterator glob = globalRange.first; glob != globalRange.second && success; ++glob)
+        return success;
+    }
+
+    void TileAssembler::convertQueuedModels()
+    {
+        std::string modelName;
+        while (!iFailed && iModelQueue.next(modelName))
+        {
+            uint64 hash = 0;
+            bool hashed = hashFile(iSrcDir + "/" + modelName, hash);
+
+            ModelHashMap::const_iterator cached = iCachedModelHashes.find(modelName);
+            if (hashed && cached != iCachedModelHashes.end() && cached->second == hash &&
+                fileExists(iDestDir + "/" + modelName + ".vmo"))
             {
-                success = ModelSpawn::writeToFile(mapfile, map_iter->second->UniqueEntries[glob->second]);
+                printf("Unchanged %s\n", modelName.c_str());
+            }
+            else
+            {
+                printf("Converting %s\n", modelName.c_str());
+                if (!convertRawFile(modelName))
+                {
+                    printf("error converting %s\n", modelName.c_str());
+                    ACE_Guard<ACE_Thread_Mutex> guard(iResultLock);
+                    iFailed = true;
+                    break;
+                }
             }
 
-            fclose(mapfile);
+            if (hashed)
+            {
+                ACE_Guard<ACE_Thread_Mutex> guard(iResultLock);
+                iModelHashes[modelName] = hash;
+            }
+        }
+    }
 
-            // <====
+    void TileAssembler::convertQueuedMaps()
+    {
+        uint32 mapId;
+        while (!iFailed && iMapQueue.next(mapId))
+        {
+            MapSpawns* spawns = mapData.find(mapId)->second;
 
-            // write map tile files, similar to ADT files, only with extra BSP tree node info
-            TileMap& tileEntries = map_iter->second->TileEntries;
-            TileMap::iterator tile;
-            for (tile = tileEntries.begin(); tile != tileEntries.end(); ++tile)
+            // M2 bounds are calculated from the raw model, so those are part of the map content
+            uint64 hash = spawns->SpawnsHash;
+            bool hashed = true;
+            for (UniqueEntryMap::const_iterator entry = spawns->UniqueEntries.begin(); entry != spawns->UniqueEntries.end(); ++entry)
             {
-                const ModelSpawn& spawn = map_iter->second->UniqueEntries[tile->second];
-                if (spawn.flags & MOD_WORLDSPAWN)           // WDT spawn, saved as tile 65/65 currently...
+                if (!(entry->second.flags & MOD_M2))
                     { continue; }
-                uint32 nSpawns = tileEntries.count(tile->first);
-                std::stringstream tilefilename;
-                tilefilename.fill('0');
-                tilefilename << iDestDir << "/" << std::setw(3) << map_iter->first << "_";
-                uint32 x, y;
-                StaticMapTree::unpackTileID(tile->first, x, y);
-                tilefilename << std::setw(2) << x << "_" << std::setw(2) << y << ".vmtile";
-                FILE* tilefile = fopen(tilefilename.str().c_str(), "wb");
-                // file header
-                if (success && fwrite(VMAP_MAGIC, 1, 8, tilefile) != 8) { success = false; }
-                // write number of tile spawns
-                if (success && fwrite(&nSpawns, sizeof(uint32), 1, tilefile) != 1) { success = false; }
-                // write tile spawns
-                for (uint32 s = 0; s < nSpawns; ++s)
+
+                ModelHashMap::const_iterator modelHash = iModelHashes.find(entry->second.name);
+                if (modelHash == iModelHashes.end())
                 {
-                    if (s && tile != tileEntries.end())
-                        { ++tile; }
-                    const ModelSpawn& spawn2 = map_iter->second->UniqueEntries[tile->second];
-                    success = success && ModelSpawn::writeToFile(tilefile, spawn2);
-                    // MapTree nodes to update when loading tile:
-                    std::map<uint32, uint32>::iterator nIdx = modelNodeIdx.find(spawn2.ID);
-                    if (success && fwrite(&nIdx->second, sizeof(uint32), 1, tilefile) != 1) { success = false; }
+                    hashed = false;
+                    break;
                 }
-                fclose(tilefile);
+                hash = hashBytes(hash, &modelHash->second, sizeof(uint64));
             }
-            // break; // test, extract only first map; TODO: remvoe this line
-        }
 
-        // add an object models, listed in temp_gameobject_models file
-        exportGameobjectModels();
+            std::stringstream mapfilename;
+            mapfilename << iDestDir << "/" << std::setfill('0') << std::setw(3) << mapId << ".vmtree";
 
-        // export objects
-        std::cout << "\nConverting Model Files" << std::endl;
-        for (std::set<std::string>::iterator mfile = spawnedModelFiles.begin(); mfile != spawnedModelFiles.end(); ++mfile)
-        {
-            std::cout << "Converting " << *mfile << std::endl;
-            if (!convertRawFile(*mfile))
+            MapHashMap::const_iterator cached = iCachedMapHashes.find(mapId);
+            if (hashed && cached != iCachedMapHashes.end() && cached->second == hash && fileExists(mapfilename.str()))
             {
-                std::cout << "error converting " << *mfile << std::endl;
-                success = false;
+                printf("Unchanged map %u\n", mapId);
+            }
+            else if (!convertMap(mapId, spawns))
+            {
+                printf("error converting map %u\n", mapId);
+                ACE_Guard<ACE_Thread_Mutex> guard(iResultLock);
+                iFailed = true;
                 break;
             }
+
+            if (hashed)
+            {
+                ACE_Guard<ACE_Thread_Mutex> guard(iResultLock);
+                iMapHashes[mapId] = hash;
+            }
         }
+    }
 
-        // cleanup:
-        for (MapData::iterator map_iter = mapData.begin(); map_iter != mapData.end(); ++map_iter)
+    void TileAssembler::runWorkers(void (TileAssembler::*pWork)())
+    {
+        AssemblerWorkerTask task;
+        task.assembler = this;
+        task.work = pWork;
+
+        int groupId = -1;
+        if (iThreads > 1)
+            { groupId = ACE_Thread_Manager::instance()->spawn_n(iThreads, AssemblerWorker, &task); }
+
+        // single threaded or no threads available, do the work ourselves
+        if (groupId == -1)
         {
-            delete map_iter->second;
+            (this->*pWork)();
+            return;
         }
-        return success;
+
+        ACE_Thread_Manager::instance()->wait_grp(groupId);
+    }
+
+    void TileAssembler::readHashCache()
+    {
+        FILE* cf = fopen((iDestDir + "/" + ASSEMBLER_HASH_CACHE).c_str(), "rb");
+        if (!cf)
+            { return; }
+
+        char line[600];
+        while (fgets(line, sizeof(line), cf))
+        {
+            // M <hash high> <hash low> <model file name>
+            // T <hash high> <hash low> <map id>
+            char type;
+            uint32 hashHigh, hashLow;
+            int nameOffset = 0;
+            if (sscanf(line, "%c %8X %8X %n", &type, &hashHigh, &hashLow, &nameOffset) != 3 || !nameOffset)
+                { continue; }
+
+            std::string name(line + nameOffset);
+            while (!name.empty() && (name[name.size() - 1] == '\n' || name[name.size() - 1] == '\r'))
+                { name.erase(name.size() - 1); }
+
+            uint64 hash = (uint64(hashHigh) << 32) | hashLow;
+            if (type == 'M')
+                { iCachedModelHashes[name] = hash; }
+            else if (type == 'T')
+                { iCachedMapHashes[uint32(atoi(name.c_str()))] = hash; }
+        }
+        fclose(cf);
+    }
+
+    void TileAssembler::writeHashCache()
+    {
+        FILE* cf = fopen((iDestDir + "/" + ASSEMBLER_HASH_CACHE).c_str(), "wb");
+        if (!cf)
+        {
+            printf("Can not write %s, next run will rebuild everything\n", ASSEMBLER_HASH_CACHE);
+            return;
+        }
+
+        for (ModelHashMap::const_iterator itr = iModelHashes.begin(); itr != iModelHashes.end(); ++itr)
+            { fprintf(cf, "M %08X %08X %s\n", uint32(itr->second >> 32), uint32(itr->second), itr->first.c_str()); }
+        for (MapHashMap::const_iterator itr = iMapHashes.begin(); itr != iMapHashes.end(); ++itr)
+            { fprintf(cf, "T %08X %08X %u\n", uint32(itr->second >> 32), uint32(itr->second), itr->first); }
+
+        fclose(cf);
     }
 
     bool TileAssembler::readMapSpawns()
@@ -240,6 +471,20 @@ namespace VMAP
             }
             else { current = (*map_iter).second; }
             current->UniqueEntries.insert(pair<uint32, ModelSpawn>(spawn.ID, spawn));
+
+            // hash what ends up in the map and tile files
+            uint64& hash = current->SpawnsHash;
+            hash = hashBytes(hash, &tileX, sizeof(uint32));
+            hash = hashBytes(hash, &tileY, sizeof(uint32));
+            hash = hashBytes(hash, &spawn.flags, sizeof(uint32));
+            hash = hashBytes(hash, &spawn.adtId, sizeof(uint16));
+            hash = hashBytes(hash, &spawn.ID, sizeof(uint32));
+            hash = hashBytes(hash, &spawn.iPos, sizeof(float) * 3);
+            hash = hashBytes(hash, &spawn.iRot, sizeof(float) * 3);
+            hash = hashBytes(hash, &spawn.iScale, sizeof(float));
+            hash = hashBytes(hash, &spawn.iBound.low(), sizeof(float) * 3);
+            hash = hashBytes(hash, &spawn.iBound.high(), sizeof(float) * 3);
+            hash = hashBytes(hash, spawn.name.c_str(), spawn.name.length());
             current->TileEntries.insert(pair<uint32, uint32>(StaticMapTree::packTileID(tileX, tileY), spawn.ID));
         }
         bool success = (ferror(dirf) == 0);
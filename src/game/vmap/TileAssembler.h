@@ -33,6 +33,9 @@
 #include "ModelInstance.h"
 #include "WorldModel.h"
 
+#include "LockedQueue.h"
+#include <ace/Thread_Mutex.h>
+
 namespace VMAP
 {
     /**
@@ -87,8 +90,11 @@ namespace VMAP
      */
     struct MapSpawns
     {
+        MapSpawns();
+
         UniqueEntryMap UniqueEntries; /**< TODO */
         TileMap TileEntries; /**< TODO */
+        uint64 SpawnsHash; /**< content hash of the map's spawn records in dir_bin */
     };
 
     /**
@@ -96,6 +102,16 @@ namespace VMAP
      *
      */
     typedef std::map<uint32, MapSpawns*> MapData;
+    /**
+     * @brief content hash per raw model file name
+     *
+     */
+    typedef std::map<std::string, uint64> ModelHashMap;
+    /**
+     * @brief content hash per map id
+     *
+     */
+    typedef std::map<uint32, uint64> MapHashMap;
     //===============================================
 
     /**
@@ -172,14 +188,25 @@ namespace VMAP
             MapData mapData; /**< TODO */
             std::set<std::string> spawnedModelFiles; /**< TODO */
 
+            uint32 iThreads; /**< number of threads converting models and maps */
+            ACE_Based::LockedQueue<std::string, ACE_Thread_Mutex> iModelQueue; /**< model files waiting for conversion */
+            ACE_Based::LockedQueue<uint32, ACE_Thread_Mutex> iMapQueue; /**< maps waiting for conversion */
+            ACE_Thread_Mutex iResultLock; /**< guards the results written by the worker threads */
+            bool iFailed; /**< set by a worker thread when a conversion failed */
+            ModelHashMap iCachedModelHashes; /**< model hashes of the previous run, read from the cache file */
+            MapHashMap iCachedMapHashes; /**< map hashes of the previous run, read from the cache file */
+            ModelHashMap iModelHashes; /**< model hashes of the models converted or found up to date in this run */
+            MapHashMap iMapHashes; /**< map hashes of the maps converted or found up to date in this run */
+
         public:
             /**
              * @brief
              *
              * @param pSrcDirName
              * @param pDestDirName
+             * @param pThreads number of threads converting models and maps
              */
-            TileAssembler(const std::string& pSrcDirName, const std::string& pDestDirName);
+            TileAssembler(const std::string& pSrcDirName, const std::string& pDestDirName, uint32 pThreads = 1);
             /**
              * @brief
              *
@@ -198,6 +225,42 @@ namespace VMAP
              * @return bool
              */
             bool readMapSpawns();
+            /**
+             * @brief writes the map tree and the tile files of a map
+             *
+             * @param pMapId
+             * @param pSpawns
+             * @return bool
+             */
+            bool convertMap(uint32 pMapId, MapSpawns* pSpawns);
+            /**
+             * @brief converts queued model files until the queue is empty, skips models
+             * whose raw file did not change since the last run
+             *
+             */
+            void convertQueuedModels();
+            /**
+             * @brief converts queued maps until the queue is empty, skips maps whose spawns
+             * and M2 models did not change since the last run
+             *
+             */
+            void convertQueuedMaps();
+            /**
+             * @brief runs the given work on iThreads threads and waits for it to be done
+             *
+             * @param pWork
+             */
+            void runWorkers(void (TileAssembler::*pWork)());
+            /**
+             * @brief reads the content hashes of the previous run from the destination directory
+             *
+             */
+            void readHashCache();
+            /**
+             * @brief stores the content hashes of this run in the destination directory
+             *
+             */
+            void writeHashCache();
             /**
              * @brief
              *
@@ -100,6 +100,7 @@ class FreezeDetectorRunnable : public ACE_Based::Runnable
                 else if (WorldTimer::getMSTimeDiff(w_lastchange, curtime) > _delaytime)
                 {
                     sLog.outError("World Thread hangs, kicking out server!");
+                    sLog.Flush();                           // buffered records would die with the crash
                     *((uint32 volatile*)NULL) = 0;          // bang crash
                 }
             }
@@ -453,6 +454,11 @@ bool Master::_StartDB()
         sLog.outError("Database not specified in configuration file");
         return false;
     }
+
+    ///- Startup loaders run on LoadingThreads threads, give each of them a query connection
+    int nLoadThreads = sConfig.GetIntDefault("LoadingThreads", 4);
+    if (nConnections < nLoadThreads)
+        { nConnections = nLoadThreads; }
     sLog.outString("World Database total connections: %i", nConnections + 1);
 
     ///- Initialise the world database
@@ -469,6 +475,9 @@ bool Master::_StartDB()
         return false;
     }
 
+    ///- Serve unchanged world tables from snapshot files
+    WorldDatabase.SetSnapshotDir(sConfig.GetStringDefault("WorldDatabaseSnapshotDir", ""), sConfig.GetBoolDefault("WorldDatabaseSnapshotChecksum", true));
+
     dbstring = sConfig.GetStringDefault("CharacterDatabaseInfo", "");
     nConnections = sConfig.GetIntDefault("CharacterDatabaseConnections", 1);
     if (dbstring.empty())
@@ -479,6 +488,9 @@ bool Master::_StartDB()
         WorldDatabase.HaltDelayThread();
         return false;
     }
+
+    if (nConnections < nLoadThreads)
+        { nConnections = nLoadThreads; }
     sLog.outString("Character Database total connections: %i", nConnections + 1);
 
     ///- Initialise the Character database
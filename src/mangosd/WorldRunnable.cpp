@@ -33,6 +33,7 @@
 #include "Timer.h"
 #include "ObjectAccessor.h"
 #include "MapManager.h"
+#include "MapPersistentStateMgr.h"
 
 #include "Database/DatabaseEnv.h"
 
@@ -93,4 +94,6 @@ void WorldRunnable::run()
     sWorldSocketMgr->StopNetwork();
 
     sMapMgr.UnloadAll();                                    // unload all grids (including locked in memory)
+
+    sMapPersistentStateMgr.SaveRespawnTimes();              // write respawn times collected since the last interval
 }
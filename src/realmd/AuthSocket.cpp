@@ -192,6 +192,7 @@ AuthSocket::AuthSocket()
     _authed = false;
 
     _accountSecurityLevel = SEC_PLAYER;
+    _accountId = 0;
 
     _build = 0;
     patch_ = ACE_INVALID_HANDLE;
@@ -508,6 +509,7 @@ bool AuthSocket::_HandleLogonChallenge()
 
                     uint8 secLevel = (*result)[4].GetUInt8();
                     _accountSecurityLevel = secLevel <= SEC_ADMINISTRATOR ? AccountTypes(secLevel) : SEC_ADMINISTRATOR;
+                    _accountId = (*result)[1].GetUInt32();
 
                     _localizationName.resize(4);
                     for (int i = 0; i < 4; ++i)
@@ -691,6 +693,9 @@ bool AuthSocket::_HandleLogonProof()
 
         SendProof(sha);
 
+        ///- Character counts may have changed since the account was last seen
+        sRealmList.InvalidateAccountCharacterCounts(_accountId);
+
         ///- Set _authed to true!
         _authed = true;
     }
@@ -788,7 +793,7 @@ bool AuthSocket::_HandleReconnectChallenge()
     EndianConvert(ch->build);
     _build = ch->build;
     
-    QueryResult* result = LoginDatabase.PQuery("SELECT sessionkey FROM account WHERE username = '%s'", _safelogin.c_str());
+    QueryResult* result = LoginDatabase.PQuery("SELECT sessionkey, id FROM account WHERE username = '%s'", _safelogin.c_str());
     
     // Stop if the account is not found
     if (!result)
@@ -800,6 +805,7 @@ bool AuthSocket::_HandleReconnectChallenge()
     
     Field* fields = result->Fetch();
     K.SetHexStr(fields[0].GetString());
+    _accountId = fields[1].GetUInt32();
     delete result;
     
     ///- Sending response
@@ -845,7 +851,10 @@ bool AuthSocket::_HandleReconnectProof()
         if (_build > 6141) // Last vanilla, 1.12.3
             pkt << (uint16) 0x00;                               // 2 bytes zeros
         send((char const*)pkt.contents(), pkt.size());
-        
+
+        ///- The client comes back from the world server, where it may have created or deleted characters
+        sRealmList.InvalidateAccountCharacterCounts(_accountId);
+
         ///- Set _authed to true!
         _authed = true;
         
@@ -870,7 +879,7 @@ bool AuthSocket::_HandleRealmList()
     ///- Get the user id (else close the connection)
     // No SQL injection (escaped user name)
     
-    QueryResult* result = LoginDatabase.PQuery("SELECT id,sha_pass_hash FROM account WHERE username = '%s'", _safelogin.c_str());
+    QueryResult* result = LoginDatabase.PQuery("SELECT id FROM account WHERE username = '%s'", _safelogin.c_str());
     if (!result)
     {
         sLog.outError("[ERROR] user %s tried to login and we can not find him in the database.", _login.c_str());
@@ -878,16 +887,15 @@ bool AuthSocket::_HandleRealmList()
         return false;
     }
     
-    uint32 id = (*result)[0].GetUInt32();
-    std::string rI = (*result)[1].GetCppString();
+    _accountId = (*result)[0].GetUInt32();
     delete result;
     
     ///- Update realm list if need
     sRealmList.UpdateIfNeed();
     
-    ///- Circle through realms in the RealmList and construct the return packet (including # of user characters in each realm)
+    ///- Take the pre-serialized realm list and fill in the # of user characters in each realm
     ByteBuffer pkt;
-    LoadRealmlist(pkt, id);
+    LoadRealmlist(pkt, _accountId);
     
     ByteBuffer hdr;
     hdr << (uint8) CMD_REALM_LIST;
@@ -900,138 +908,16 @@ bool AuthSocket::_HandleRealmList()
 
 void AuthSocket::LoadRealmlist(ByteBuffer& pkt, uint32 acctid)
 {
-    RealmList::RealmListIterators iters;
-    iters = sRealmList.GetIteratorsForBuild(_build);
-    uint32 numRealms = sRealmList.NumRealmsForBuild(_build);
-    
-    switch (_build)
-    {
-        case 5875:                                          // 1.12.1
-        case 6005:                                          // 1.12.2
-        case 6141:                                          // 1.12.3
-        {
-            pkt << uint32(0);                               // unused value
-            pkt << uint8(numRealms);
-            
-            for (RealmList::RealmStlList::const_iterator itr = iters.first;
-                 itr != iters.second;
-                 ++itr)
-            {
-                uint8 AmountOfCharacters;
-                
-                // No SQL injection. id of realm is controlled by the database.
-                QueryResult* result = LoginDatabase.PQuery("SELECT numchars FROM realmcharacters WHERE realmid = '%d' AND acctid='%u'", (*itr)->m_ID, acctid);
-                if (result)
-                {
-                    Field* fields = result->Fetch();
-                    AmountOfCharacters = fields[0].GetUInt8();
-                    delete result;
-                }
-                else
-                    AmountOfCharacters = 0;
-                
-                bool ok_build = std::find((*itr)->realmbuilds.begin(), (*itr)->realmbuilds.end(), _build) != (*itr)->realmbuilds.end();
-                
-                RealmBuildInfo const* buildInfo = ok_build ? FindBuildInfo(_build) : NULL;
-                if (!buildInfo)
-                    buildInfo = &(*itr)->realmBuildInfo;
-                
-                RealmFlags realmflags = (*itr)->realmflags;
-
-                // 1.x clients not support explicitly REALM_FLAG_SPECIFYBUILD, so manually form similar name as show in more recent clients
-                std::string name = (*itr)->name;
-                if (realmflags & REALM_FLAG_SPECIFYBUILD)
-                {
-                    char buf[20];
-                    snprintf(buf, 20, " (%u,%u,%u)", buildInfo->major_version, buildInfo->minor_version, buildInfo->bugfix_version);
-                    name += buf;
-                }
-
-                // Show offline state for unsupported client builds and locked realms (1.x clients not support locked state show)
-                if (!ok_build || ((*itr)->allowedSecurityLevel > _accountSecurityLevel))
-                    realmflags = RealmFlags(realmflags | REALM_FLAG_OFFLINE);
-
-                pkt << uint32((*itr)->icon);              // realm type
-                pkt << uint8(realmflags);                   // realmflags
-                pkt << name;                                // name
-                pkt << (*itr)->address;                   // address
-                pkt << float((*itr)->populationLevel);
-                pkt << uint8(AmountOfCharacters);
-                pkt << uint8((*itr)->timezone);           // realm category
-                pkt << uint8(0x00);                         // unk, may be realm number/id?
-            }
-
-            pkt << uint16(0x0002);                          // unused value (why 2?)
-            break;
-        }
-
-        case 8606:                                          // 2.4.3
-        case 10505:                                         // 3.2.2a
-        case 11159:                                         // 3.3.0a
-        case 11403:                                         // 3.3.2
-        case 11723:                                         // 3.3.3a
-        case 12340:                                         // 3.3.5a
-        default:                                            // and later
-        {
-            pkt << uint32(0);                               // unused value
-            pkt << uint16(numRealms);
-            
-            for (RealmList::RealmStlList::const_iterator itr = iters.first;
-                 itr != iters.second;
-                 ++itr)
-            {
-                uint8 AmountOfCharacters;
-
-                // No SQL injection. id of realm is controlled by the database.
-                QueryResult* result = LoginDatabase.PQuery("SELECT numchars FROM realmcharacters WHERE realmid = '%d' AND acctid='%u'", (*itr)->m_ID, acctid);
-                if (result)
-                {
-                    Field* fields = result->Fetch();
-                    AmountOfCharacters = fields[0].GetUInt8();
-                    delete result;
-                }
-                else
-                    { AmountOfCharacters = 0; }
-
-                bool ok_build = std::find((*itr)->realmbuilds.begin(), (*itr)->realmbuilds.end(), _build) != (*itr)->realmbuilds.end();
+    RealmList::RealmListPacket const& realmList = sRealmList.GetRealmListPacket(_build, _accountSecurityLevel);
+    RealmList::RealmCharacterCounts const& charCounts = sRealmList.GetAccountCharacterCounts(acctid);
 
-                RealmBuildInfo const* buildInfo = ok_build ? FindBuildInfo(_build) : NULL;
-                if (!buildInfo)
-                    { buildInfo = &(*itr)->realmBuildInfo; }
+    pkt.append(realmList.data);
 
-                uint8 lock = ((*itr)->allowedSecurityLevel > _accountSecurityLevel) ? 1 : 0;
-
-                RealmFlags realmFlags = (*itr)->realmflags;
-
-                // Show offline state for unsupported client builds
-                if (!ok_build)
-                    { realmFlags = RealmFlags(realmFlags | REALM_FLAG_OFFLINE); }
-
-                if (!buildInfo)
-                    { realmFlags = RealmFlags(realmFlags & ~REALM_FLAG_SPECIFYBUILD); }
-
-                pkt << uint8((*itr)->icon);               // realm type (this is second column in Cfg_Configs.dbc)
-                pkt << uint8(lock);                         // flags, if 0x01, then realm locked
-                pkt << uint8(realmFlags);                   // see enum RealmFlags
-                pkt << (*itr)->name;                            // name
-                pkt << (*itr)->address;                   // address
-                pkt << float((*itr)->populationLevel);
-                pkt << uint8(AmountOfCharacters);
-                pkt << uint8((*itr)->timezone);           // realm category (Cfg_Categories.dbc)
-                pkt << uint8(0x2C);                         // unk, may be realm number/id?
-
-                if (realmFlags & REALM_FLAG_SPECIFYBUILD)
-                {
-                    pkt << uint8(buildInfo->major_version);
-                    pkt << uint8(buildInfo->minor_version);
-                    pkt << uint8(buildInfo->bugfix_version);
-                    pkt << uint16(_build);
-                }
-            }
-
-            pkt << uint16(0x0010);                          // unused value (why 10?)
-            break;
-        }
+    for (std::vector<std::pair<uint32, size_t> >::const_iterator itr = realmList.charCountPos.begin(); itr != realmList.charCountPos.end(); ++itr)
+    {
+        RealmList::RealmCharacterCounts::const_iterator count = charCounts.find(itr->first);
+        if (count != charCounts.end())
+            { pkt.put<uint8>(itr->second, count->second); }
     }
 }
 
@@ -152,6 +152,7 @@ class AuthSocket: public BufferedSocket
         std::string _localizationName; /**< Since GetLocaleByName() is _NOT_ bijective, we have to store the locale as a string. Otherwise we can't differ between enUS and enGB, which is important for the patch system */
         uint16 _build; /**< TODO */
         AccountTypes _accountSecurityLevel; /**< TODO */
+        uint32 _accountId; /**< Account id, known once the logon or reconnect challenge found the account */
 
         ACE_HANDLE patch_; /**< TODO */
 
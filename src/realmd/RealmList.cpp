@@ -37,6 +37,9 @@ INSTANTIATE_SINGLETON_1(RealmList);
 
 extern DatabaseType LoginDatabase;
 
+// cached account character counts not requested for this long are dropped
+#define ACCOUNT_CHARACTERS_CACHE_TIME   (5 * MINUTE)
+
 // will only support WoW 1.12.1/1.12.2/1.12.3 , WoW:TBC 2.4.3 and official release for WoW:WotLK and later, client builds 10505, 8606, 6141, 6005, 5875
 // if you need more from old build then add it in cases in realmd sources code
 // list sorted from high to low build and first build used as low bound for accepted by default range (any > it will accepted by realmd at least)
@@ -70,7 +73,7 @@ RealmBuildInfo const* FindBuildInfo(uint16 _build)
     return NULL;
 }
 
-RealmList::RealmList() : m_UpdateInterval(0), m_NextUpdateTime(time(NULL))
+RealmList::RealmList() : m_UpdateInterval(0), m_NextUpdateTime(time(NULL)), m_NextCharactersCleanupTime(time(NULL) + ACCOUNT_CHARACTERS_CACHE_TIME)
 {
 }
 
@@ -202,6 +205,8 @@ void RealmList::UpdateRealm(uint32 ID, const std::string& name, const std::strin
 
 void RealmList::UpdateIfNeed()
 {
+    CleanupAccountCharacterCounts();
+
     // maybe disabled or updated recently
     if (!m_UpdateInterval || m_NextUpdateTime > time(NULL))
         { return; }
@@ -221,6 +226,8 @@ void RealmList::UpdateRealms(bool init)
 {
     DETAIL_LOG("Updating Realm List...");
 
+    std::string signature;
+
     ////                                               0   1     2        3     4     5           6         7                     8           9
     QueryResult* result = LoginDatabase.Query("SELECT id, name, address, port, icon, realmflags, timezone, allowedSecurityLevel, population, realmbuilds FROM realmlist WHERE (realmflags & 1) = 0 ORDER BY name");
 
@@ -231,6 +238,12 @@ void RealmList::UpdateRealms(bool init)
         {
             Field* fields = result->Fetch();
 
+            for (uint32 i = 0; i < result->GetFieldCount(); ++i)
+            {
+                signature += fields[i].GetCppString();
+                signature += '\0';
+            }
+
             uint32 Id                  = fields[0].GetUInt32();
             std::string name           = fields[1].GetCppString();
             uint8 realmflags           = fields[5].GetUInt8();
@@ -254,4 +267,182 @@ void RealmList::UpdateRealms(bool init)
         while (result->NextRow());
         delete result;
     }
+
+    ///- Serialized realm lists only need rebuilding when some realm changed state
+    if (init || signature != m_realmsSignature)
+    {
+        m_realmsSignature = signature;
+        m_packets.clear();
+    }
+}
+
+RealmList::RealmListPacket const& RealmList::GetRealmListPacket(uint16 build, AccountTypes security)
+{
+    uint32 key = (uint32(build) << 8) | uint8(security);
+
+    RealmListPacketMap::iterator itr = m_packets.find(key);
+    if (itr != m_packets.end())
+        { return itr->second; }
+
+    RealmListPacket& packet = m_packets[key];
+    BuildRealmListPacket(build, security, packet);
+    return packet;
+}
+
+void RealmList::BuildRealmListPacket(uint16 build, AccountTypes security, RealmListPacket& packet) const
+{
+    RealmListIterators iters = GetIteratorsForBuild(build);
+    uint32 numRealms = NumRealmsForBuild(build);
+    ByteBuffer& pkt = packet.data;
+
+    switch (build)
+    {
+        case 5875:                                          // 1.12.1
+        case 6005:                                          // 1.12.2
+        case 6141:                                          // 1.12.3
+        {
+            pkt << uint32(0);                               // unused value
+            pkt << uint8(numRealms);
+
+            for (RealmStlList::const_iterator itr = iters.first;
+                 itr != iters.second;
+                 ++itr)
+            {
+                bool ok_build = std::find((*itr)->realmbuilds.begin(), (*itr)->realmbuilds.end(), build) != (*itr)->realmbuilds.end();
+
+                RealmBuildInfo const* buildInfo = ok_build ? FindBuildInfo(build) : NULL;
+                if (!buildInfo)
+                    buildInfo = &(*itr)->realmBuildInfo;
+
+                RealmFlags realmflags = (*itr)->realmflags;
+
+                // 1.x clients not support explicitly REALM_FLAG_SPECIFYBUILD, so manually form similar name as show in more recent clients
+                std::string name = (*itr)->name;
+                if (realmflags & REALM_FLAG_SPECIFYBUILD)
+                {
+                    char buf[20];
+                    snprintf(buf, 20, " (%u,%u,%u)", buildInfo->major_version, buildInfo->minor_version, buildInfo->bugfix_version);
+                    name += buf;
+                }
+
+                // Show offline state for unsupported client builds and locked realms (1.x clients not support locked state show)
+                if (!ok_build || ((*itr)->allowedSecurityLevel > security))
+                    realmflags = RealmFlags(realmflags | REALM_FLAG_OFFLINE);
+
+                pkt << uint32((*itr)->icon);              // realm type
+                pkt << uint8(realmflags);                   // realmflags
+                pkt << name;                                // name
+                pkt << (*itr)->address;                   // address
+                pkt << float((*itr)->populationLevel);
+                packet.charCountPos.push_back(std::make_pair((*itr)->m_ID, pkt.wpos()));
+                pkt << uint8(0);                            // amount of characters, filled per account
+                pkt << uint8((*itr)->timezone);           // realm category
+                pkt << uint8(0x00);                         // unk, may be realm number/id?
+            }
+
+            pkt << uint16(0x0002);                          // unused value (why 2?)
+            break;
+        }
+
+        case 8606:                                          // 2.4.3
+        case 10505:                                         // 3.2.2a
+        case 11159:                                         // 3.3.0a
+        case 11403:                                         // 3.3.2
+        case 11723:                                         // 3.3.3a
+        case 12340:                                         // 3.3.5a
+        default:                                            // and later
+        {
+            pkt << uint32(0);                               // unused value
+            pkt << uint16(numRealms);
+
+            for (RealmStlList::const_iterator itr = iters.first;
+                 itr != iters.second;
+                 ++itr)
+            {
+                bool ok_build = std::find((*itr)->realmbuilds.begin(), (*itr)->realmbuilds.end(), build) != (*itr)->realmbuilds.end();
+
+                RealmBuildInfo const* buildInfo = ok_build ? FindBuildInfo(build) : NULL;
+                if (!buildInfo)
+                    { buildInfo = &(*itr)->realmBuildInfo; }
+
+                uint8 lock = ((*itr)->allowedSecurityLevel > security) ? 1 : 0;
+
+                RealmFlags realmFlags = (*itr)->realmflags;
+
+                // Show offline state for unsupported client builds
+                if (!ok_build)
+                    { realmFlags = RealmFlags(realmFlags | REALM_FLAG_OFFLINE); }
+
+                if (!buildInfo)
+                    { realmFlags = RealmFlags(realmFlags & ~REALM_FLAG_SPECIFYBUILD); }
+
+                pkt << uint8((*itr)->icon);               // realm type (this is second column in Cfg_Configs.dbc)
+                pkt << uint8(lock);                         // flags, if 0x01, then realm locked
+                pkt << uint8(realmFlags);                   // see enum RealmFlags
+                pkt << (*itr)->name;                            // name
+                pkt << (*itr)->address;                   // address
+                pkt << float((*itr)->populationLevel);
+                packet.charCountPos.push_back(std::make_pair((*itr)->m_ID, pkt.wpos()));
+                pkt << uint8(0);                            // amount of characters, filled per account
+                pkt << uint8((*itr)->timezone);           // realm category (Cfg_Categories.dbc)
+                pkt << uint8(0x2C);                         // unk, may be realm number/id?
+
+                if (realmFlags & REALM_FLAG_SPECIFYBUILD)
+                {
+                    pkt << uint8(buildInfo->major_version);
+                    pkt << uint8(buildInfo->minor_version);
+                    pkt << uint8(buildInfo->bugfix_version);
+                    pkt << uint16(build);
+                }
+            }
+
+            pkt << uint16(0x0010);                          // unused value (why 10?)
+            break;
+        }
+    }
+}
+
+RealmList::RealmCharacterCounts const& RealmList::GetAccountCharacterCounts(uint32 accountId)
+{
+    AccountCharactersMap::iterator itr = m_accountCharacters.find(accountId);
+    if (itr != m_accountCharacters.end())
+    {
+        itr->second.lastUsed = time(NULL);
+        return itr->second.counts;
+    }
+
+    CachedCharacterCounts& cached = m_accountCharacters[accountId];
+    cached.lastUsed = time(NULL);
+
+    // No SQL injection. id of account is controlled by the database.
+    QueryResult* result = LoginDatabase.PQuery("SELECT realmid, numchars FROM realmcharacters WHERE acctid='%u'", accountId);
+    if (result)
+    {
+        do
+        {
+            Field* fields = result->Fetch();
+            cached.counts[fields[0].GetUInt32()] = fields[1].GetUInt8();
+        }
+        while (result->NextRow());
+        delete result;
+    }
+
+    return cached.counts;
+}
+
+void RealmList::CleanupAccountCharacterCounts()
+{
+    time_t now = time(NULL);
+    if (m_NextCharactersCleanupTime > now)
+        { return; }
+
+    m_NextCharactersCleanupTime = now + ACCOUNT_CHARACTERS_CACHE_TIME;
+
+    for (AccountCharactersMap::iterator itr = m_accountCharacters.begin(); itr != m_accountCharacters.end();)
+    {
+        if (itr->second.lastUsed + ACCOUNT_CHARACTERS_CACHE_TIME <= now)
+            { m_accountCharacters.erase(itr++); }
+        else
+            { ++itr; }
+    }
 }
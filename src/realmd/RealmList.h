@@ -30,6 +30,7 @@
 #define MANGOS_H_REALMLIST
 
 #include "Common.h"
+#include "ByteBuffer.h"
 
 /**
  * @brief
@@ -102,6 +103,24 @@ class RealmList
         typedef std::list<const Realm*> RealmStlList;
         typedef std::pair<RealmStlList::const_iterator, RealmStlList::const_iterator> RealmListIterators;
         typedef std::map<uint32, RealmVersion> RealmBuildVersionMap;
+
+        /**
+         * Character count per realm id for a single account, as stored in realmd.realmcharacters
+         */
+        typedef std::map<uint32, uint8> RealmCharacterCounts;
+
+        /**
+         * A serialized CMD_REALM_LIST body for one client build and account security level.
+         * The character count of every realm is left at zero and patched in per account
+         * using the stored offsets, so sending the list costs a copy and a few byte writes.
+         */
+        struct RealmListPacket
+        {
+            RealmListPacket() : data(64) {}
+
+            ByteBuffer data;                                            ///< packet body without the command header
+            std::vector<std::pair<uint32, size_t> > charCountPos;       ///< realm id and offset of its character count byte
+        };
         
         /**
          * @brief
@@ -158,6 +177,31 @@ class RealmList
          * \see RealmList::NumRealmsForBuild
          */
         uint32 size() const { return m_realms.size(); };
+
+        /**
+         * Returns the pre-serialized realm list for the given client build and account security
+         * level, building it on first use. Cached packets are dropped whenever the realmlist table
+         * content changes (status, population, flags, ...).
+         * @param build the client build the list is sent to
+         * @param security the security level of the requesting account
+         * @return the cached packet, character counts are not filled in
+         */
+        RealmListPacket const& GetRealmListPacket(uint16 build, AccountTypes security);
+
+        /**
+         * Returns the character counts of an account on all realms, loading them from
+         * realmcharacters with a single query if the account is not cached yet.
+         * @param accountId the account to get the character counts for
+         */
+        RealmCharacterCounts const& GetAccountCharacterCounts(uint32 accountId);
+
+        /**
+         * Forgets the cached character counts of an account. Called when the client
+         * (re)authenticates, which is what happens when it comes back from mangosd
+         * after creating or deleting characters there.
+         * @param accountId the account to drop from the cache
+         */
+        void InvalidateAccountCharacterCounts(uint32 accountId) { m_accountCharacters.erase(accountId); }
     private:
         /** 
          * Checks what version (ie, vanilla, tbc) a certain build number belongs to
@@ -202,12 +246,41 @@ class RealmList
          * @param builds
          */
         void UpdateRealm(uint32 ID, const std::string& name, const std::string& address, uint32 port, uint8 icon, RealmFlags realmflags, uint8 timezone, AccountTypes allowedSecurityLevel, float popu, const std::string& builds);
+        /**
+         * Serializes the realm list for the given build and security level, this is
+         * what \ref RealmList::GetRealmListPacket caches.
+         * @param build the client build the list is sent to
+         * @param security the security level of the requesting account
+         * @param packet the packet to fill
+         */
+        void BuildRealmListPacket(uint16 build, AccountTypes security, RealmListPacket& packet) const;
+
+        /**
+         * Drops cached account character counts that have not been requested for a while.
+         */
+        void CleanupAccountCharacterCounts();
+
+        /**
+         * Cached character counts of one account with the time they were last requested
+         */
+        struct CachedCharacterCounts
+        {
+            RealmCharacterCounts counts;
+            time_t lastUsed;
+        };
+
+        typedef std::map<uint32, RealmListPacket> RealmListPacketMap;          ///< (build << 8 | security) -> packet
+        typedef std::map<uint32, CachedCharacterCounts> AccountCharactersMap;   ///< account id -> character counts
     private:
         RealmMap m_realms;                                    ///< Internal map of realms
         RealmStlList m_realmsByVersion[REALM_VERSION_COUNT]; ///< This sorts the realms by their supported build
         RealmBuildVersionMap m_buildToVersion;
         uint32   m_UpdateInterval;
         time_t   m_NextUpdateTime;
+        std::string m_realmsSignature;                      ///< Raw content of the last realmlist query, used to detect changes
+        RealmListPacketMap m_packets;                       ///< Pre-serialized realm list packets
+        AccountCharactersMap m_accountCharacters;           ///< Per account character count cache
+        time_t   m_NextCharactersCleanupTime;
 };
 
 #define sRealmList RealmList::Instance()
@@ -81,6 +81,9 @@ struct MANGOS_DLL_DECL ScriptedAI : public CreatureAI
         // Called if IsVisible(Unit* pWho) is true at each relative pWho move
         void MoveInLineOfSight(Unit* pWho) override;
 
+        // Scripts may run out of combat timers in UpdateAI, keep them updated every tick
+        bool CanSleep() const override { return false; }
+
         // Called for reaction at enter to combat if not in combat yet (enemy can be NULL)
         void EnterCombat(Unit* pEnemy) override;
 
@@ -27,6 +27,7 @@
 
 #include "Common.h"
 #include "Utilities/ByteConverter.h"
+#include "PacketBuffer.h"
 
 /**
  * @brief
@@ -110,6 +111,21 @@ class ByteBuffer
          */
         ByteBuffer(const ByteBuffer& buf): _rpos(buf._rpos), _wpos(buf._wpos), _storage(buf._storage) { }
 
+        /**
+         * @brief exchanges contents with another buffer without copying
+         *
+         * Use it to hand a finished buffer over to its new owner instead of
+         * copy constructing it.
+         *
+         * @param buf
+         */
+        void swap(ByteBuffer& buf)
+        {
+            std::swap(_rpos, buf._rpos);
+            std::swap(_wpos, buf._wpos);
+            _storage.swap(buf._storage);
+        }
+
         /**
          * @brief
          *
@@ -765,8 +781,10 @@ class ByteBuffer
         }
 
     protected:
+        typedef std::vector<uint8, PacketAllocator<uint8> > Storage; /**< TODO */
+
         size_t _rpos, _wpos; /**< TODO */
-        std::vector<uint8> _storage; /**< TODO */
+        Storage _storage; /**< TODO */
 };
 
 template <typename T>
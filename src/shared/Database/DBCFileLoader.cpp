@@ -27,11 +27,34 @@
 #include <string.h>
 
 #include "DBCFileLoader.h"
+#include "StorageArena.h"
+
+#include <ace/Mem_Map.h>
 
 DBCFileLoader::DBCFileLoader()
 {
     data = NULL;
     fieldsOffset = NULL;
+    m_map = NULL;
+    recordSize = 0;
+    recordCount = 0;
+    fieldCount = 0;
+    stringSize = 0;
+}
+
+void DBCFileLoader::InitFieldOffsets(const char* fmt)
+{
+    delete[] fieldsOffset;
+    fieldsOffset = new uint32[fieldCount];
+    fieldsOffset[0] = 0;
+    for (uint32 i = 1; i < fieldCount; ++i)
+    {
+        fieldsOffset[i] = fieldsOffset[i - 1];
+        if (fmt[i - 1] == 'b' || fmt[i - 1] == 'X')         // byte fields
+            { fieldsOffset[i] += 1; }
+        else                                                // 4 byte fields (int32/float/strings)
+            { fieldsOffset[i] += 4; }
+    }
 }
 
 bool DBCFileLoader::Load(const char* filename, const char* fmt)
@@ -87,16 +110,7 @@ bool DBCFileLoader::Load(const char* filename, const char* fmt)
 
     EndianConvert(stringSize);
 
-    fieldsOffset = new uint32[fieldCount];
-    fieldsOffset[0] = 0;
-    for (uint32 i = 1; i < fieldCount; ++i)
-    {
-        fieldsOffset[i] = fieldsOffset[i - 1];
-        if (fmt[i - 1] == 'b' || fmt[i - 1] == 'X')         // byte fields
-            { fieldsOffset[i] += 1; }
-        else                                                // 4 byte fields (int32/float/strings)
-            { fieldsOffset[i] += 4; }
-    }
+    InitFieldOffsets(fmt);
 
     data = new unsigned char[recordSize * recordCount + stringSize];
     stringTable = data + recordSize * recordCount;
@@ -111,9 +125,54 @@ bool DBCFileLoader::Load(const char* filename, const char* fmt)
     return true;
 }
 
+bool DBCFileLoader::Map(const char* filename, const char* fmt)
+{
+    uint32 header[5];
+
+    delete m_map;
+    m_map = new ACE_Mem_Map;
+    data = NULL;
+
+    // private writable mapping, entries patched at runtime only copy their own page
+    if (m_map->map(ACE_TEXT_CHAR_TO_TCHAR(filename), static_cast<size_t>(-1), O_RDONLY, ACE_DEFAULT_FILE_PERMS, PROT_RDWR, ACE_MAP_PRIVATE) == -1)
+        { return false; }
+
+    size_t size = m_map->size();
+    if (size < sizeof(header))
+        { return false; }
+
+    memcpy(header, m_map->addr(), sizeof(header));
+    for (uint32 i = 0; i < 5; ++i)
+        { EndianConvert(header[i]); }
+
+    if (header[0] != 0x43424457)                            //'WDBC'
+        { return false; }
+
+    recordCount = header[1];
+    fieldCount = header[2];
+    recordSize = header[3];
+    stringSize = header[4];
+
+    if (!fieldCount || uint64(recordSize) * recordCount + stringSize > size - sizeof(header))
+        { return false; }
+
+    // records are used in place, the file layout must match the format exactly
+    if (strlen(fmt) != fieldCount || recordSize != GetFileRecordSize(fmt))
+        { return false; }
+
+    InitFieldOffsets(fmt);
+
+    data = static_cast<unsigned char*>(m_map->addr()) + sizeof(header);
+    stringTable = data + recordSize * recordCount;
+    return true;
+}
+
 DBCFileLoader::~DBCFileLoader()
 {
-    delete[] data;
+    if (m_map)
+        { delete m_map; }
+    else
+        { delete[] data; }
     delete[] fieldsOffset;
 }
 
@@ -123,6 +182,15 @@ DBCFileLoader::Record DBCFileLoader::getRecord(size_t id)
     return Record(*this, data + id * recordSize);
 }
 
+uint32 DBCFileLoader::GetFileRecordSize(const char* format)
+{
+    // byte fields take one byte in the file, every other field four, see InitFieldOffsets()
+    uint32 recordsize = 0;
+    for (uint32 x = 0; format[x]; ++x)
+        { recordsize += (format[x] == 'b' || format[x] == 'X') ? 1 : 4; }
+    return recordsize;
+}
+
 uint32 DBCFileLoader::GetFormatRecordSize(const char* format, int32* index_pos)
 {
     uint32 recordsize = 0;
@@ -261,13 +329,10 @@ char* DBCFileLoader::AutoProduceData(const char* format, uint32& records, char**
     return dataTable;
 }
 
-char* DBCFileLoader::AutoProduceStrings(const char* format, char* dataTable)
+bool DBCFileLoader::AutoProduceStrings(const char* format, char* dataTable, StorageArena& strings)
 {
     if (strlen(format) != fieldCount)
-        { return NULL; }
-
-    char* stringPool = new char[stringSize];
-    memcpy(stringPool, stringTable, stringSize);
+        { return false; }
 
     uint32 offset = 0;
 
@@ -292,10 +357,7 @@ char* DBCFileLoader::AutoProduceStrings(const char* format, char* dataTable)
                     // fill only not filled entries
                     char** slot = (char**)(&dataTable[offset]);
                     if (!*slot || !** slot)
-                    {
-                        const char* st = getRecord(y).getString(x);
-                        *slot = stringPool + (st - (const char*)stringTable);
-                    }
+                        { *slot = strings.Intern(getRecord(y).getString(x)); }
                     offset += sizeof(char*);
                     break;
                 }
@@ -313,5 +375,57 @@ char* DBCFileLoader::AutoProduceStrings(const char* format, char* dataTable)
         }
     }
 
-    return stringPool;
+    return true;
+}
+
+char** DBCFileLoader::AutoProduceIndex(const char* format, uint32& records)
+{
+    typedef char* ptr;
+    if (strlen(format) != fieldCount)
+        { return NULL; }
+
+    int32 i;
+    GetFormatRecordSize(format, &i);
+
+    if (i >= 0)
+    {
+        uint32 maxi = 0;
+        // find max index
+        for (uint32 y = 0; y < recordCount; ++y)
+        {
+            uint32 ind = getRecord(y).getUInt(i);
+            if (ind > maxi) { maxi = ind; }
+        }
+
+        ++maxi;
+        records = maxi;
+    }
+    else
+        { records = recordCount; }
+
+    ptr* indexTable = new ptr[records];
+    memset(indexTable, 0, records * sizeof(ptr));
+
+    for (uint32 y = 0; y < recordCount; ++y)
+        { indexTable[i >= 0 ? getRecord(y).getUInt(i) : y] = reinterpret_cast<char*>(data + y * recordSize); }
+
+    return indexTable;
+}
+
+bool DBCFileLoader::IsInPlaceFormat(const char* format)
+{
+#if MANGOS_ENDIAN == MANGOS_LITTLEENDIAN
+    uint32 x = 0;
+    for (; format[x] == DBC_FF_IND || format[x] == DBC_FF_INT || format[x] == DBC_FF_FLOAT; ++x) {}
+
+    if (!x)
+        { return false; }
+
+    // ignored fields are allowed only after all stored ones, the struct then is a prefix of the record
+    for (; format[x] == DBC_FF_NA || format[x] == DBC_FF_NA_BYTE; ++x) {}
+
+    return !format[x];
+#else
+    return false;
+#endif
 }
@@ -29,6 +29,9 @@
 #include "Utilities/ByteConverter.h"
 #include <cassert>
 
+class StorageArena;
+class ACE_Mem_Map;
+
 /**
  * @brief
  *
@@ -74,6 +77,14 @@ class DBCFileLoader
          * @return bool
          */
         bool Load(const char* filename, const char* fmt);
+        /**
+         * @brief maps the file instead of reading it, records stay in the file pages
+         *
+         * @param filename
+         * @param fmt
+         * @return bool
+         */
+        bool Map(const char* filename, const char* fmt);
 
         /**
          * @brief
@@ -191,13 +202,39 @@ class DBCFileLoader
          */
         char* AutoProduceData(const char* fmt, uint32& count, char**& indexTable);
         /**
-         * @brief
+         * @brief fills the still empty string fields, only strings in use are copied
          *
          * @param fmt
          * @param dataTable
+         * @param strings arena the strings are interned in
+         * @return bool
+         */
+        bool AutoProduceStrings(const char* fmt, char* dataTable, StorageArena& strings);
+        /**
+         * @brief builds an index table pointing at the records in place
+         *
+         * @param fmt
+         * @param count
          * @return char
          */
-        char* AutoProduceStrings(const char* fmt, char* dataTable);
+        char** AutoProduceIndex(const char* fmt, uint32& count);
+        /**
+         * @brief true if records of this format can be used without decoding
+         *
+         * Holds for formats made of 4 byte numeric fields, optionally followed by
+         * ignored fields, on little endian hosts.
+         *
+         * @param format
+         * @return bool
+         */
+        static bool IsInPlaceFormat(const char* format);
+        /**
+         * @brief size of a record in the DBC file described by format
+         *
+         * @param format
+         * @return uint32
+         */
+        static uint32 GetFileRecordSize(const char* format);
         /**
          * @brief
          *
@@ -207,6 +244,12 @@ class DBCFileLoader
          */
         static uint32 GetFormatRecordSize(const char* format, int32* index_pos = NULL);
     private:
+        /**
+         * @brief
+         *
+         * @param fmt
+         */
+        void InitFieldOffsets(const char* fmt);
 
         uint32 recordSize; /**< TODO */
         uint32 recordCount; /**< TODO */
@@ -215,5 +258,6 @@ class DBCFileLoader
         uint32* fieldsOffset; /**< TODO */
         unsigned char* data; /**< TODO */
         unsigned char* stringTable; /**< TODO */
+        ACE_Mem_Map* m_map; /**< mapping data points into, NULL if read into memory */
 };
 #endif
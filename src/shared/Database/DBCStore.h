@@ -26,6 +26,22 @@
 #define DBCSTORE_H
 
 #include "DBCFileLoader.h"
+#include "StorageArena.h"
+
+#include <ace/Guard_T.h>
+#include <ace/Thread_Mutex.h>
+
+// Flag publishing the lazily built index of a mapped store. The release store
+// orders the index table writes before the flag, the acquire load orders the
+// flag before any index read, without a locked instruction on the lookup path.
+#if COMPILER == COMPILER_MICROSOFT
+// volatile accesses have acquire and release semantics (/volatile:ms)
+#  define DBC_LOAD_ACQUIRE(var)         (var)
+#  define DBC_STORE_RELEASE(var, value) ((var) = (value))
+#else
+#  define DBC_LOAD_ACQUIRE(var)         __atomic_load_n(&(var), __ATOMIC_ACQUIRE)
+#  define DBC_STORE_RELEASE(var, value) __atomic_store_n(&(var), (value), __ATOMIC_RELEASE)
+#endif
 
 template<class T>
 /**
@@ -34,18 +50,13 @@ template<class T>
  */
 class DBCStorage
 {
-        /**
-         * @brief
-         *
-         */
-        typedef std::list<char*> StringPoolList;
     public:
         /**
          * @brief
          *
          * @param f
          */
-        explicit DBCStorage(const char* f) : nCount(0), fieldCount(0), fmt(f), indexTable(NULL), m_dataTable(NULL) { }
+        explicit DBCStorage(const char* f) : nCount(0), fieldCount(0), fmt(f), indexTable(NULL), m_dataTable(NULL), loaded(false), m_rowCount(0), m_mappedFile(NULL), m_indexBuilt(0) { }
         /**
          * @brief
          *
@@ -58,7 +69,7 @@ class DBCStorage
 		* @return uint32
 		*/
 		//uint32  GetNumRows() const { return nCount; }
-		uint32  GetNumRows() const { return loaded ? data.size() : nCount; }
+		uint32  GetNumRows() const { EnsureIndex(); return loaded ? data.size() : nCount; }
         /**
          * @brief
          *
@@ -81,6 +92,7 @@ class DBCStorage
 		//T const* LookupEntry(uint32 id) const { return (id >= nCount) ? NULL : indexTable[id]; }
 		T const* LookupEntry(uint32 id) const
 		{
+            EnsureIndex();
             if (loaded)
             {
                 typename std::map<uint32, T const*>::const_iterator it = data.find(id);
@@ -97,6 +109,13 @@ class DBCStorage
          */
         bool Load(char const* fn)
         {
+            // release a previous load, its records and strings
+            Clear();
+
+            // fixed layout records are used straight from the mapped file
+            if (DBCFileLoader::IsInPlaceFormat(fmt))
+                { return LoadMapped(fn); }
+
             DBCFileLoader dbc;
             // Check if load was sucessful, only then continue
             if (!dbc.Load(fn, fmt))
@@ -107,8 +126,10 @@ class DBCStorage
             // load raw non-string data
             m_dataTable = (T*)dbc.AutoProduceData(fmt, nCount, (char**&)indexTable);
 
-            // load strings from dbc data
-            m_stringPoolList.push_back(dbc.AutoProduceStrings(fmt, (char*)m_dataTable));
+            m_rowCount = dbc.GetNumRows();
+
+            // load strings from dbc data, only the used ones are kept
+            dbc.AutoProduceStrings(fmt, (char*)m_dataTable, m_strings);
 
             // error in dbc file at loading if NULL
             return indexTable != NULL;
@@ -138,6 +159,10 @@ class DBCStorage
          */
         bool LoadStringsFrom(char const* fn)
         {
+            // mapped stores have no strings to localize
+            if (m_mappedFile)
+                { return true; }
+
             // DBC must be already loaded using Load
             if (!indexTable)
                 { return false; }
@@ -148,7 +173,7 @@ class DBCStorage
                 { return false; }
 
             // load strings from another locale dbc data
-            m_stringPoolList.push_back(dbc.AutoProduceStrings(fmt, (char*)m_dataTable));
+            dbc.AutoProduceStrings(fmt, (char*)m_dataTable, m_strings);
 
             return true;
         }
@@ -165,6 +190,18 @@ class DBCStorage
                 loaded = false;
             }
 
+            if (m_mappedFile)
+            {
+                delete[]((char*)indexTable);
+                indexTable = NULL;
+                delete m_mappedFile;
+                m_mappedFile = NULL;
+                m_indexBuilt = 0;
+                nCount = 0;
+                m_rowCount = 0;
+                return;
+            }
+
             if (!indexTable)
                 { return; }
 
@@ -173,12 +210,9 @@ class DBCStorage
             delete[]((char*)m_dataTable);
             m_dataTable = NULL;
 
-            while (!m_stringPoolList.empty())
-            {
-                delete[] m_stringPoolList.front();
-                m_stringPoolList.pop_front();
-            }
+            m_strings.Clear();
             nCount = 0;
+            m_rowCount = 0;
         }
 
         /**
@@ -186,24 +220,104 @@ class DBCStorage
          *
          * @param id
          */
-        void EraseEntry(uint32 id) { assert(id < nCount && "Entry to be erased must be in bounds!") ; indexTable[id] = NULL; }
+        void EraseEntry(uint32 id) { EnsureIndex(); assert(id < nCount && "Entry to be erased must be in bounds!") ; indexTable[id] = NULL; }
         /**
          * @brief
          *
          * @param entry
          * @param id
          */
-        void InsertEntry(T* entry, uint32 id) { assert(id < nCount && "Entry to be inserted must be in bounds!"); indexTable[id] = entry; }
+        void InsertEntry(T* entry, uint32 id) { EnsureIndex(); assert(id < nCount && "Entry to be inserted must be in bounds!"); indexTable[id] = entry; }
+
+        /**
+         * @brief called once all locales are loaded, drops the string lookup table
+         *
+         */
+        void EndStringLoading() { m_strings.EndInterning(); }
+        /**
+         * @brief
+         *
+         * @return size_t bytes of index, records and strings
+         */
+        size_t GetMemoryUsage() const { return nCount * sizeof(T*) + (m_mappedFile ? 0 : m_rowCount * sizeof(T)) + m_strings.GetReservedBytes(); }
+        /**
+         * @brief
+         *
+         * @return bool true if the records are used in place from the mapped file
+         */
+        bool IsMapped() const { return m_mappedFile != NULL; }
+        /**
+         * @brief
+         *
+         * @return size_t string bytes not stored thanks to shared strings
+         */
+        size_t GetSharedStringBytes() const { return m_strings.GetSharedStringBytes(); }
 
     private:
-        uint32 nCount; /**< TODO */
+        /**
+         * @brief maps the file, the index is built on first access
+         *
+         * @param fn
+         * @return bool
+         */
+        bool LoadMapped(char const* fn)
+        {
+            m_mappedFile = new DBCFileLoader;
+            bool mapped = m_mappedFile->Map(fn, fmt);
+
+            // reported by the caller when the layout does not match the format
+            fieldCount = m_mappedFile->GetCols();
+            if (!mapped)
+            {
+                delete m_mappedFile;
+                m_mappedFile = NULL;
+                return false;
+            }
+
+            m_rowCount = m_mappedFile->GetNumRows();
+            return true;
+        }
+
+        /**
+         * @brief
+         *
+         */
+        void EnsureIndex() const
+        {
+            if (m_mappedFile && !DBC_LOAD_ACQUIRE(m_indexBuilt))
+                { BuildIndex(); }
+        }
+
+        /**
+         * @brief
+         *
+         */
+        void BuildIndex() const
+        {
+            ACE_GUARD(ACE_Thread_Mutex, guard, m_indexLock);
+            if (m_indexBuilt)
+                { return; }
+
+            indexTable = (T**)m_mappedFile->AutoProduceIndex(fmt, nCount);
+            if (!indexTable)
+                { nCount = 0; }
+
+            // publish indexTable and nCount to the threads not taking the lock
+            DBC_STORE_RELEASE(m_indexBuilt, 1);
+        }
+
+        mutable uint32 nCount; /**< TODO */
         uint32 fieldCount; /**< TODO */
         char const* fmt; /**< TODO */
-        T** indexTable; /**< TODO */
+        mutable T** indexTable; /**< TODO */
         T* m_dataTable; /**< TODO */
         std::map<uint32, T const*> data;
         bool loaded;
-        StringPoolList m_stringPoolList; /**< TODO */
+        uint32 m_rowCount; /**< TODO */
+        StorageArena m_strings; /**< strings of all loaded locales */
+        DBCFileLoader* m_mappedFile; /**< file the records are used from in place, NULL if decoded */
+        mutable ACE_Thread_Mutex m_indexLock; /**< TODO */
+        mutable volatile long m_indexBuilt; /**< index of a mapped store is built, see DBC_LOAD_ACQUIRE */
 };
 
 #endif
@@ -25,6 +25,7 @@
 #include "DatabaseEnv.h"
 #include "Config/Config.h"
 #include "Database/SqlOperations.h"
+#include "Database/QueryResultSnapshot.h"
 
 #include <ctime>
 #include <iostream>
@@ -309,6 +310,148 @@ QueryResult* Database::PQuery(const char* format, ...)
     return Query(szQuery);
 }
 
+QueryResult* Database::PQueryStream(const char* format, ...)
+{
+    if (!format) { return NULL; }
+
+    va_list ap;
+    char szQuery [MAX_QUERY_LEN];
+    va_start(ap, format);
+    int res = vsnprintf(szQuery, MAX_QUERY_LEN, format, ap);
+    va_end(ap);
+
+    if (res == -1)
+    {
+        sLog.outError("SQL Query truncated (and not execute) for format: %s", format);
+        return NULL;
+    }
+
+    return QueryStream(szQuery);
+}
+
+void Database::SetSnapshotDir(std::string const& dir, bool fullChecksum)
+{
+    m_snapshotDir = dir;
+    if (!m_snapshotDir.empty() && m_snapshotDir[m_snapshotDir.size() - 1] != '/' && m_snapshotDir[m_snapshotDir.size() - 1] != '\\')
+        { m_snapshotDir.push_back('/'); }
+
+    m_snapshotChecksum = fullChecksum;
+}
+
+/**
+ * @brief adds all fields of all rows to the snapshot key, deletes the result
+ *
+ */
+static uint64 HashSnapshotKeyRows(QueryResult* result, uint64 key)
+{
+    do
+    {
+        Field* fields = result->Fetch();
+        for (uint32 i = 0; i < result->GetFieldCount(); ++i)
+        {
+            // keeps NULL apart from an empty value
+            char const* value = fields[i].IsNULL() ? "\\N" : fields[i].GetString();
+            key = SnapshotHash(value, strlen(value) + 1, key);
+        }
+    }
+    while (result->NextRow());
+
+    delete result;
+    return key;
+}
+
+bool Database::GetSnapshotKey(char const* tables, char const* sql, uint64& key)
+{
+#ifdef DO_POSTGRESQL
+    return false;
+#else
+    key = SnapshotHash(sql, strlen(sql));
+
+    // db_version changes with every database update, even ones not touching the tables
+    QueryResult* result = Query("SELECT * FROM db_version");
+    if (!result)
+        { return false; }
+    key = HashSnapshotKeyRows(result, key);
+
+    if (m_snapshotChecksum)
+    {
+        // reads the full tables on InnoDB, but sees every changed row
+        result = PQuery("CHECKSUM TABLE %s", tables);
+        if (!result)
+            { return false; }
+
+        do
+        {
+            Field* fields = result->Fetch();
+            if (fields[1].IsNULL())                         // table does not exist
+            {
+                delete result;
+                return false;
+            }
+
+            key = SnapshotHash(fields[0].GetString(), strlen(fields[0].GetString()), key);
+            key = SnapshotHash(fields[1].GetString(), strlen(fields[1].GetString()), key);
+        }
+        while (result->NextRow());
+
+        delete result;
+        return true;
+    }
+
+    // 'a', 'b' from "a, b"
+    std::string names;
+    uint32 count = 0;
+    for (char const* pos = tables; *pos;)
+    {
+        size_t len = strcspn(pos, ", ");
+        if (len)
+        {
+            names.append(names.empty() ? "'" : ", '").append(pos, len).append("'");
+            ++count;
+        }
+        pos += len + strspn(pos + len, ", ");
+    }
+
+    // table metadata only, no table data is read; an UPDATE of an existing row does not
+    // change it reliably (UPDATE_TIME is NULL on MariaDB InnoDB, lost at restart, cached
+    // by MySQL 8), see WorldDatabaseSnapshotChecksum
+    result = PQuery("SELECT TABLE_NAME, CREATE_TIME, UPDATE_TIME, TABLE_ROWS, DATA_LENGTH, AUTO_INCREMENT "
+                    "FROM information_schema.TABLES WHERE TABLE_SCHEMA = DATABASE() AND TABLE_NAME IN (%s) ORDER BY TABLE_NAME",
+                    names.c_str());
+    if (!result)
+        { return false; }
+
+    if (result->GetRowCount() != count)                     // table does not exist
+    {
+        delete result;
+        return false;
+    }
+
+    key = HashSnapshotKeyRows(result, key);
+    return true;
+#endif
+}
+
+QueryResult* Database::QuerySnapshot(const char* name, const char* tables, const char* sql)
+{
+    uint64 key = 0;
+    if (m_snapshotDir.empty() || !GetSnapshotKey(tables, sql, key))
+        { return QueryStream(sql); }
+
+    std::string fileName = m_snapshotDir + name + ".snapshot";
+    if (QueryResult* snapshot = QueryResultSnapshot::Open(fileName, key))
+    {
+        DETAIL_LOG("Using snapshot %s", fileName.c_str());
+        return snapshot;
+    }
+
+    QueryResult* result = QueryStream(sql);
+    if (!result)
+        { return NULL; }
+
+    return new QueryResultSnapshotWriter(result, fileName, key);
+}
+
 QueryNamedResult* Database::PQueryNamed(const char* format, ...)
 {
     if (!format) { return NULL; }
@@ -77,6 +77,17 @@ class MANGOS_DLL_SPEC SqlConnection
          * @return QueryNamedResult
          */
         virtual QueryNamedResult* QueryNamed(const char* sql) = 0;
+        /**
+         * @brief unbuffered query, rows are transferred while the result is read
+         *
+         * The connection stays locked until the result is deleted, so the result
+         * has to be consumed by the thread that issued the query. Backends without
+         * streaming support return a normal buffered result.
+         *
+         * @param sql
+         * @return QueryResult
+         */
+        virtual QueryResult* QueryStream(const char* sql) { return Query(sql); }
 
         /**
          * @brief public methods for making requests
@@ -192,6 +203,17 @@ class MANGOS_DLL_SPEC SqlConnection
          */
         void FreePreparedStatements();
 
+        /**
+         * @brief keep the connection locked after the current call returns
+         *
+         */
+        void AcquireLock() { m_mutex.acquire(); }
+        /**
+         * @brief
+         *
+         */
+        void ReleaseLock() { m_mutex.release(); }
+
     private:
         /**
          * @brief
@@ -264,6 +286,18 @@ class MANGOS_DLL_SPEC Database
             return guard->QueryNamed(sql);
         }
 
+        /**
+         * @brief Synchronous unbuffered query for large loads, see SqlConnection::QueryStream
+         *
+         * @param sql
+         * @return QueryResult
+         */
+        inline QueryResult* QueryStream(const char* sql)
+        {
+            SqlConnection::Lock guard(getQueryConnection());
+            return guard->QueryStream(sql);
+        }
+
         /**
          * @brief
          *
@@ -271,6 +305,37 @@ class MANGOS_DLL_SPEC Database
          * @return QueryResult
          */
         QueryResult* PQuery(const char* format, ...) ATTR_PRINTF(2, 3);
+        /**
+         * @brief
+         *
+         * @param format...
+         * @return QueryResult
+         */
+        QueryResult* PQueryStream(const char* format, ...) ATTR_PRINTF(2, 3);
+
+        /**
+         * @brief query that is served from a snapshot file while the source tables are unchanged
+         *
+         * The snapshot is keyed by the db_version row, the query and the full checksums of
+         * the given tables or, if asked for, only their information_schema metadata (creation
+         * and update time, row count, size), which misses in place edits of existing rows.
+         * It is written while the result of a fresh query is read. Without a snapshot
+         * directory this is a plain QueryStream().
+         *
+         * @param name snapshot file name
+         * @param tables comma separated tables the query reads
+         * @param sql
+         * @return QueryResult
+         */
+        QueryResult* QuerySnapshot(const char* name, const char* tables, const char* sql);
+        /**
+         * @brief enables snapshots, see QuerySnapshot()
+         *
+         * @param dir empty to disable
+         * @param fullChecksum key on CHECKSUM TABLE, reads the full tables at every start;
+         *        false keys on table metadata only, edited rows may then be served stale
+         */
+        void SetSnapshotDir(std::string const& dir, bool fullChecksum = true);
         /**
          * @brief
          *
@@ -620,6 +685,15 @@ class MANGOS_DLL_SPEC Database
          * @return bool
          */
         bool CheckRequiredField(char const* table_name, char const* required_name);
+        /**
+         * @brief
+         *
+         * @param tables
+         * @param sql
+         * @param key hash of db_version, the table metadata or checksums and the query
+         * @return bool false if a table does not exist
+         */
+        bool GetSnapshotKey(char const* tables, char const* sql, uint64& key);
         /**
          * @brief
          *
@@ -650,7 +724,7 @@ class MANGOS_DLL_SPEC Database
          */
         Database() :
             m_nQueryConnPoolSize(1), m_pAsyncConn(NULL), m_pResultQueue(NULL),
-            m_threadBody(NULL), m_delayThread(NULL), m_bAllowAsyncTransactions(false),
+            m_threadBody(NULL), m_delayThread(NULL), m_bAllowAsyncTransactions(false), m_snapshotChecksum(true),
             m_iStmtIndex(-1), m_logSQL(false), m_pingIntervallms(0)
         {
             m_nQueryCounter = -1;
@@ -785,6 +859,9 @@ class MANGOS_DLL_SPEC Database
 
         bool m_bAllowAsyncTransactions;                     /**< flag which specifies if async transactions are enabled */
 
+        std::string m_snapshotDir;                          /**< directory for QuerySnapshot() files, empty if disabled */
+        bool m_snapshotChecksum;                            /**< key snapshots on CHECKSUM TABLE */
+
         // PREPARED STATEMENT REGISTRY
         /**
          * @brief
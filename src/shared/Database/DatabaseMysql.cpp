@@ -181,10 +181,10 @@ bool MySQLConnection::Initialize(const char* infoString)
     return true;
 }
 
-bool MySQLConnection::_Query(const char* sql, MYSQL_RES** pResult, MYSQL_FIELD** pFields, uint64* pRowCount, uint32* pFieldCount)
+bool MySQLConnection::_SendQuery(const char* sql)
 {
     if (!mMysql)
-        { return 0; }
+        { return false; }
 
     uint32 _s = WorldTimer::getMSTime();
 
@@ -199,6 +199,14 @@ bool MySQLConnection::_Query(const char* sql, MYSQL_RES** pResult, MYSQL_FIELD**
         DEBUG_FILTER_LOG(LOG_FILTER_SQL_TEXT, "[%u ms] SQL: %s", WorldTimer::getMSTimeDiff(_s, WorldTimer::getMSTime()), sql);
     }
 
+    return true;
+}
+
+bool MySQLConnection::_Query(const char* sql, MYSQL_RES** pResult, MYSQL_FIELD** pFields, uint64* pRowCount, uint32* pFieldCount)
+{
+    if (!_SendQuery(sql))
+        { return false; }
+
     *pResult = mysql_store_result(mMysql);
     *pRowCount = mysql_affected_rows(mMysql);
     *pFieldCount = mysql_field_count(mMysql);
@@ -252,6 +260,33 @@ QueryNamedResult* MySQLConnection::QueryNamed(const char* sql)
     return new QueryNamedResult(queryResult, names);
 }
 
+QueryResult* MySQLConnection::QueryStream(const char* sql)
+{
+    if (!_SendQuery(sql))
+        { return NULL; }
+
+    // rows stay on the server until fetched, so the whole result is never held in client memory
+    MYSQL_RES* result = mysql_use_result(mMysql);
+    if (!result)
+        { return NULL; }
+
+    uint32 fieldCount = mysql_field_count(mMysql);
+    MYSQL_FIELD* fields = mysql_fetch_fields(result);
+
+    // no other statement can run on this connection until the result is freed
+    AcquireLock();
+
+    QueryResultMysql* queryResult = new QueryResultMysql(result, fields, 0, fieldCount, this);
+
+    if (!queryResult->NextRow())                            // keep Query() behaviour for empty results
+    {
+        delete queryResult;
+        return NULL;
+    }
+
+    return queryResult;
+}
+
 bool MySQLConnection::Execute(const char* sql)
 {
     if (!mMysql)
@@ -155,6 +155,13 @@ class MANGOS_DLL_SPEC MySQLConnection : public SqlConnection
          * @return QueryNamedResult
          */
         QueryNamedResult* QueryNamed(const char* sql) override;
+        /**
+         * @brief mysql_use_result based query, rows are fetched from the server on NextRow()
+         *
+         * @param sql
+         * @return QueryResult
+         */
+        QueryResult* QueryStream(const char* sql) override;
         /**
          * @brief
          *
@@ -202,6 +209,8 @@ class MANGOS_DLL_SPEC MySQLConnection : public SqlConnection
         SqlPreparedStatement* CreateStatement(const std::string& fmt) override;
 
     private:
+        friend class QueryResultMysql;
+
         /**
          * @brief
          *
@@ -209,6 +218,18 @@ class MANGOS_DLL_SPEC MySQLConnection : public SqlConnection
          * @return bool
          */
         bool _TransactionCmd(const char* sql);
+        /**
+         * @brief
+         *
+         * @param sql
+         * @return bool
+         */
+        bool _SendQuery(const char* sql);
+        /**
+         * @brief called by a streamed result once it is freed, unlocks the connection
+         *
+         */
+        void _EndStream() { ReleaseLock(); }
         /**
          * @brief
          *
@@ -27,8 +27,8 @@
 #include "DatabaseEnv.h"
 #include "Errors.h"
 
-QueryResultMysql::QueryResultMysql(MYSQL_RES* result, MYSQL_FIELD* fields, uint64 rowCount, uint32 fieldCount) :
-    QueryResult(rowCount, fieldCount), mResult(result)
+QueryResultMysql::QueryResultMysql(MYSQL_RES* result, MYSQL_FIELD* fields, uint64 rowCount, uint32 fieldCount, MySQLConnection* streamConn) :
+    QueryResult(rowCount, fieldCount), mResult(result), mStreamConn(streamConn)
 {
     mCurrentRow = new Field[mFieldCount];
     MANGOS_ASSERT(mCurrentRow);
@@ -52,10 +52,17 @@ bool QueryResultMysql::NextRow()
     row = mysql_fetch_row(mResult);
     if (!row)
     {
+        if (mStreamConn && mysql_errno(mStreamConn->mMysql))
+            { sLog.outErrorDb("query ERROR: %s (streamed result truncated after " UI64FMTD " rows)", mysql_error(mStreamConn->mMysql), mRowCount); }
+
         EndQuery();
         return false;
     }
 
+    // unbuffered results only know how many rows were read so far
+    if (mStreamConn)
+        { ++mRowCount; }
+
     for (uint32 i = 0; i < mFieldCount; ++i)
         { mCurrentRow[i].SetValue(row[i]); }
 
@@ -69,9 +76,15 @@ void QueryResultMysql::EndQuery()
 
     if (mResult)
     {
-        mysql_free_result(mResult);
+        mysql_free_result(mResult);                         // also drains rows left unread by a streamed result
         mResult = 0;
     }
+
+    if (mStreamConn)
+    {
+        mStreamConn->_EndStream();
+        mStreamConn = NULL;
+    }
 }
 
 enum Field::DataTypes QueryResultMysql::ConvertNativeType(enum_field_types mysqlType) const
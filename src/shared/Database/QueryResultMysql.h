@@ -36,6 +36,8 @@
 #include <mysql.h>
 #endif
 
+class MySQLConnection;
+
 /**
  * @brief
  *
@@ -50,8 +52,9 @@ class QueryResultMysql : public QueryResult
          * @param fields
          * @param rowCount
          * @param fieldCount
+         * @param streamConn connection locked by an unbuffered result, NULL for stored results
          */
-        QueryResultMysql(MYSQL_RES* result, MYSQL_FIELD* fields, uint64 rowCount, uint32 fieldCount);
+        QueryResultMysql(MYSQL_RES* result, MYSQL_FIELD* fields, uint64 rowCount, uint32 fieldCount, MySQLConnection* streamConn = NULL);
 
         /**
          * @brief
@@ -81,6 +84,7 @@ class QueryResultMysql : public QueryResult
         void EndQuery();
 
         MYSQL_RES* mResult; /**< TODO */
+        MySQLConnection* mStreamConn; /**< set while an unbuffered result holds its connection */
 };
 #endif
 #endif
@@ -0,0 +1,255 @@
+/**
+ * MaNGOS is a full featured server for World of Warcraft, supporting
+ * the following clients: 1.12.x, 2.4.3, 3.3.5a, 4.3.4a and 5.4.8
+ *
+ * Copyright (C) 2005-2014  MaNGOS project <http://getmangos.eu>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * World of Warcraft, and all World of Warcraft or Warcraft art, images,
+ * and lore are copyrighted by Blizzard Entertainment, Inc.
+ */
+
+#include "DatabaseEnv.h"
+#include "Database/QueryResultSnapshot.h"
+
+#define SNAPSHOT_MAGIC      "MSNP"
+#define SNAPSHOT_VERSION    1
+
+/**
+ * @brief on-disk header, followed by one uint32 type per field and the rows
+ *
+ * Every field of a row is a marker byte, 0 for NULL, or 1 followed by the
+ * zero terminated value.
+ */
+struct SnapshotHeader
+{
+    char magic[4];                                          /**< TODO */
+    uint32 version;                                         /**< TODO */
+    uint64 key;                                             /**< TODO */
+    uint64 rowCount;                                        /**< TODO */
+    uint64 hash;                                            /**< checksum over the field types and rows */
+    uint32 fieldCount;                                      /**< TODO */
+    uint32 reserved;                                        /**< TODO */
+};
+
+uint64 SnapshotHash(void const* data, size_t size, uint64 hash)
+{
+    // FNV-1a
+    uint8 const* bytes = static_cast<uint8 const*>(data);
+    for (size_t i = 0; i < size; ++i)
+    {
+        hash ^= bytes[i];
+        hash *= UI64LIT(0x100000001b3);
+    }
+    return hash;
+}
+
+QueryResultSnapshot::QueryResultSnapshot(uint64 rowCount, uint32 fieldCount) :
+    QueryResult(rowCount, fieldCount), mPos(NULL), mEnd(NULL)
+{
+    mCurrentRow = new Field[mFieldCount];
+}
+
+QueryResultSnapshot::~QueryResultSnapshot()
+{
+    delete[] mCurrentRow;
+}
+
+QueryResultSnapshot* QueryResultSnapshot::Open(std::string const& fileName, uint64 key)
+{
+    QueryResultSnapshot* result = new QueryResultSnapshot(0, 0);
+    if (result->mMap.map(ACE_TEXT_CHAR_TO_TCHAR(fileName.c_str()), static_cast<size_t>(-1), O_RDONLY, ACE_DEFAULT_FILE_PERMS, PROT_READ, ACE_MAP_PRIVATE) == -1)
+    {
+        delete result;
+        return NULL;
+    }
+
+    char const* data = static_cast<char const*>(result->mMap.addr());
+    size_t size = result->mMap.size();
+
+    SnapshotHeader header;
+    if (size < sizeof(header))
+    {
+        delete result;
+        return NULL;
+    }
+
+    memcpy(&header, data, sizeof(header));
+    size_t typesSize = header.fieldCount * sizeof(uint32);
+    if (memcmp(header.magic, SNAPSHOT_MAGIC, 4) != 0 || header.version != SNAPSHOT_VERSION || header.key != key ||
+        !header.fieldCount || size < sizeof(header) + typesSize ||
+        SnapshotHash(data + sizeof(header), size - sizeof(header)) != header.hash)
+    {
+        delete result;
+        return NULL;
+    }
+
+    delete[] result->mCurrentRow;
+    result->mFieldCount = header.fieldCount;
+    result->mRowCount = header.rowCount;
+    result->mCurrentRow = new Field[result->mFieldCount];
+
+    for (uint32 i = 0; i < result->mFieldCount; ++i)
+    {
+        uint32 type;
+        memcpy(&type, data + sizeof(header) + i * sizeof(uint32), sizeof(uint32));
+        result->mCurrentRow[i].SetType(Field::DataTypes(type));
+    }
+
+    result->mPos = data + sizeof(header) + typesSize;
+    result->mEnd = data + size;
+
+    if (!result->NextRow())
+    {
+        delete result;
+        return NULL;
+    }
+
+    return result;
+}
+
+bool QueryResultSnapshot::NextRow()
+{
+    if (mPos >= mEnd)
+        { return false; }
+
+    for (uint32 i = 0; i < mFieldCount; ++i)
+    {
+        if (mPos >= mEnd)
+            { return false; }
+
+        if (!*mPos++)
+        {
+            mCurrentRow[i].SetValue(NULL);
+            continue;
+        }
+
+        char const* terminator = static_cast<char const*>(memchr(mPos, 0, mEnd - mPos));
+        if (!terminator)
+            { return false; }
+
+        mCurrentRow[i].SetValue(mPos);
+        mPos = terminator + 1;
+    }
+
+    return true;
+}
+
+QueryResultSnapshotWriter::QueryResultSnapshotWriter(QueryResult* source, std::string const& fileName, uint64 key) :
+    QueryResult(source->GetRowCount(), source->GetFieldCount()), mSource(source), mFileName(fileName),
+    mFile(NULL), mKey(key), mRowsWritten(0), mHash(0)
+{
+    // the source updates its fields in place, so they can be handed out directly
+    mCurrentRow = mSource->Fetch();
+
+    mFile = fopen((mFileName + ".tmp").c_str(), "wb");
+    if (!mFile)
+    {
+        sLog.outError("Can't create snapshot file %s.tmp, snapshot not saved", mFileName.c_str());
+        return;
+    }
+
+    SnapshotHeader header;
+    memset(&header, 0, sizeof(header));
+    fwrite(&header, sizeof(header), 1, mFile);              // written again with the totals in Finish()
+
+    mHash = SnapshotHash(NULL, 0);
+    for (uint32 i = 0; i < mFieldCount; ++i)
+    {
+        uint32 type = mCurrentRow[i].GetType();
+        fwrite(&type, sizeof(type), 1, mFile);
+        mHash = SnapshotHash(&type, sizeof(type), mHash);
+    }
+
+    WriteRow();
+}
+
+QueryResultSnapshotWriter::~QueryResultSnapshotWriter()
+{
+    // not read to the end, an incomplete snapshot must not be used
+    if (mFile)
+    {
+        fclose(mFile);
+        remove((mFileName + ".tmp").c_str());
+    }
+
+    delete mSource;
+}
+
+bool QueryResultSnapshotWriter::NextRow()
+{
+    if (!mSource->NextRow())
+    {
+        mCurrentRow = NULL;
+        Finish();
+        return false;
+    }
+
+    WriteRow();
+    return true;
+}
+
+void QueryResultSnapshotWriter::WriteRow()
+{
+    if (!mFile)
+        { return; }
+
+    for (uint32 i = 0; i < mFieldCount; ++i)
+    {
+        char const* value = mCurrentRow[i].GetString();
+        uint8 marker = value ? 1 : 0;
+
+        fwrite(&marker, 1, 1, mFile);
+        mHash = SnapshotHash(&marker, 1, mHash);
+
+        if (value)
+        {
+            size_t length = strlen(value) + 1;
+            fwrite(value, 1, length, mFile);
+            mHash = SnapshotHash(value, length, mHash);
+        }
+    }
+
+    ++mRowsWritten;
+}
+
+void QueryResultSnapshotWriter::Finish()
+{
+    if (!mFile)
+        { return; }
+
+    SnapshotHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, SNAPSHOT_MAGIC, 4);
+    header.version = SNAPSHOT_VERSION;
+    header.key = mKey;
+    header.rowCount = mRowsWritten;
+    header.hash = mHash;
+    header.fieldCount = mFieldCount;
+
+    fseek(mFile, 0, SEEK_SET);
+    bool written = fwrite(&header, sizeof(header), 1, mFile) == 1;
+    written = fclose(mFile) == 0 && written;
+    mFile = NULL;
+
+    std::string tmpName = mFileName + ".tmp";
+    remove(mFileName.c_str());
+    if (!written || rename(tmpName.c_str(), mFileName.c_str()) != 0)
+    {
+        sLog.outError("Can't write snapshot file %s", mFileName.c_str());
+        remove(tmpName.c_str());
+    }
+}
@@ -0,0 +1,137 @@
+/**
+ * MaNGOS is a full featured server for World of Warcraft, supporting
+ * the following clients: 1.12.x, 2.4.3, 3.3.5a, 4.3.4a and 5.4.8
+ *
+ * Copyright (C) 2005-2014  MaNGOS project <http://getmangos.eu>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * World of Warcraft, and all World of Warcraft or Warcraft art, images,
+ * and lore are copyrighted by Blizzard Entertainment, Inc.
+ */
+
+#ifndef QUERYRESULTSNAPSHOT_H
+#define QUERYRESULTSNAPSHOT_H
+
+#include "Common.h"
+#include "Database/QueryResult.h"
+#include <ace/Mem_Map.h>
+
+/**
+ * @brief result set read from a memory mapped snapshot file
+ *
+ * Field values point straight into the mapping, so they stay valid until the
+ * result is deleted.
+ */
+class QueryResultSnapshot : public QueryResult
+{
+    public:
+        /**
+         * @brief maps a snapshot file and checks it against key and checksum
+         *
+         * @param fileName
+         * @param key hash of the data the snapshot was made from
+         * @return QueryResultSnapshot NULL if the file is missing, stale or damaged
+         */
+        static QueryResultSnapshot* Open(std::string const& fileName, uint64 key);
+
+        /**
+         * @brief
+         *
+         */
+        ~QueryResultSnapshot();
+
+        /**
+         * @brief
+         *
+         * @return bool
+         */
+        bool NextRow() override;
+
+    private:
+        /**
+         * @brief
+         *
+         * @param rowCount
+         * @param fieldCount
+         */
+        QueryResultSnapshot(uint64 rowCount, uint32 fieldCount);
+
+        ACE_Mem_Map mMap; /**< TODO */
+        char const* mPos; /**< next unread row */
+        char const* mEnd; /**< TODO */
+};
+
+/**
+ * @brief passes rows of another result through and writes them to a snapshot file
+ *
+ * The snapshot only replaces an older one once every row has been read.
+ */
+class QueryResultSnapshotWriter : public QueryResult
+{
+    public:
+        /**
+         * @brief takes ownership of source, which has to be positioned on its first row
+         *
+         * @param source
+         * @param fileName
+         * @param key
+         */
+        QueryResultSnapshotWriter(QueryResult* source, std::string const& fileName, uint64 key);
+
+        /**
+         * @brief
+         *
+         */
+        ~QueryResultSnapshotWriter();
+
+        /**
+         * @brief
+         *
+         * @return bool
+         */
+        bool NextRow() override;
+
+    private:
+        /**
+         * @brief
+         *
+         */
+        void WriteRow();
+        /**
+         * @brief
+         *
+         */
+        void Finish();
+
+        QueryResult* mSource; /**< TODO */
+        std::string mFileName; /**< TODO */
+        FILE* mFile; /**< NULL once finished or when the file could not be created */
+        uint64 mKey; /**< TODO */
+        uint64 mRowsWritten; /**< TODO */
+        uint64 mHash; /**< running checksum of the written rows */
+};
+
+/**
+ * @brief
+ *
+ * @param data
+ * @param size
+ * @param hash
+ * @return uint64
+ */
+uint64 SnapshotHash(void const* data, size_t size, uint64 hash = UI64LIT(0xcbf29ce484222325));
+
+#endif
@@ -34,6 +34,7 @@ SQLStorageBase::SQLStorageBase() :
     m_dstFieldCount(0),
     m_srcFieldCount(0),
     m_recordCount(0),
+    m_recordCapacity(0),
     m_maxEntry(0),
     m_recordSize(0),
     m_data(NULL)
@@ -52,6 +53,9 @@ void SQLStorageBase::Initialize(const char* tableName, const char* entry_field,
 
 char* SQLStorageBase::createRecord(uint32 recordId)
 {
+    if (m_recordCount >= m_recordCapacity || recordId >= m_maxEntry)
+        { return NULL; }
+
     char* newRecord = &m_data[m_recordCount * m_recordSize];
     ++m_recordCount;
 
@@ -64,63 +68,23 @@ void SQLStorageBase::prepareToLoad(uint32 maxEntry, uint32 recordCount, uint32 r
     m_maxEntry = maxEntry;
     m_recordSize = recordSize;
 
-    delete[] m_data;
-    m_data = new char[recordCount * m_recordSize];
+    // records and their strings share one arena, released together in Free().
+    // Release the previous load here as well, a reload must not grow the arena.
+    m_arena.Clear();
+    m_data = m_arena.Allocate(recordCount * m_recordSize);
     memset(m_data, 0, recordCount * m_recordSize);
 
     m_recordCount = 0;
+    m_recordCapacity = recordCount;
 }
 
 // Function to delete the data
 void SQLStorageBase::Free()
 {
-    if (!m_data)
-        { return; }
-
-    uint32 offset = 0;
-    for (uint32 x = 0; x < m_dstFieldCount; ++x)
-    {
-        switch (m_dst_format[x])
-        {
-            case DBC_FF_LOGIC:
-                offset += sizeof(bool);
-                break;
-            case DBC_FF_STRING:
-            {
-                for (uint32 recordItr = 0; recordItr < m_recordCount; ++recordItr)
-                    { delete[] *(char**)((char*)(m_data + (recordItr * m_recordSize)) + offset); }
-
-                offset += sizeof(char*);
-                break;
-            }
-            case DBC_FF_NA:
-            case DBC_FF_INT:
-                offset += sizeof(uint32);
-                break;
-            case DBC_FF_BYTE:
-            case DBC_FF_NA_BYTE:
-                offset += sizeof(char);
-                break;
-            case DBC_FF_FLOAT:
-            case DBC_FF_NA_FLOAT:
-                offset += sizeof(float);
-                break;
-            case DBC_FF_NA_POINTER:
-                // TODO- possible (and small) memleak here possible
-                offset += sizeof(char*);
-                break;
-            case DBC_FF_IND:
-            case DBC_FF_SORT:
-                assert(false && "SQL storage not have sort field types");
-                break;
-            default:
-                assert(false && "unknown format character");
-                break;
-        }
-    }
-    delete[] m_data;
+    m_arena.Clear();
     m_data = NULL;
     m_recordCount = 0;
+    m_recordCapacity = 0;
 }
 
 // -----------------------------------  SQLStorage  -------------------------------------------- //
@@ -28,6 +28,7 @@
 #include "Common.h"
 #include "Database/DatabaseEnv.h"
 #include "DBCFileLoader.h"
+#include "StorageArena.h"
 
 /**
  * @brief
@@ -166,6 +167,14 @@ class SQLStorageBase
          */
         SQLSIterator<T> getDataEnd() const { return SQLSIterator<T>(m_data + m_recordCount * m_recordSize, m_recordSize); }
 
+        /**
+         * @brief memory released together with the records, for data derived from them
+         *
+         * @param size
+         * @return char
+         */
+        char* AllocateRecordData(size_t size) { return m_arena.Allocate(size); }
+
     protected:
         /**
          * @brief
@@ -233,7 +242,7 @@ class SQLStorageBase
          * @brief
          *
          * @param recordId
-         * @return char
+         * @return char NULL if recordId or the record count exceed what prepareToLoad was given
          */
         char* createRecord(uint32 recordId);
 
@@ -247,11 +256,13 @@ class SQLStorageBase
         uint32 m_dstFieldCount; /**< TODO */
         uint32 m_srcFieldCount; /**< TODO */
         uint32 m_recordCount; /**< TODO */
+        uint32 m_recordCapacity; /**< records prepareToLoad made room for */
         uint32 m_maxEntry; /**< TODO */
         uint32 m_recordSize; /**< TODO */
 
         // Data Storage
         char* m_data; /**< TODO */
+        StorageArena m_arena; /**< holds the records and their strings */
 };
 
 /**
@@ -715,6 +726,9 @@ class SQLStorageLoaderBase
          */
         void convert_str_to_str(uint32 field_pos, char* src, char*& dst);
 
+    protected:
+        StorageArena* m_strings; /**< arena of the storage being loaded, strings are interned in it */
+
     private:
         template<class V>
         /**
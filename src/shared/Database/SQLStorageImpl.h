@@ -53,17 +53,7 @@ template<class DerivedLoader, class StorageClass>
  */
 void SQLStorageLoaderBase<DerivedLoader, StorageClass>::convert_str_to_str(uint32 /*field_pos*/, char const* src, char*& dst)
 {
-    if (!src)
-    {
-        dst = new char[1];
-        *dst = 0;
-    }
-    else
-    {
-        uint32 l = strlen(src) + 1;
-        dst = new char[l];
-        memcpy(dst, src, l);
-    }
+    dst = m_strings->Intern(src);
 }
 
 template<class DerivedLoader, class StorageClass>
@@ -77,8 +67,7 @@ template<class S>
  */
 void SQLStorageLoaderBase<DerivedLoader, StorageClass>::convert_to_str(uint32 /*field_pos*/, S /*src*/, char*& dst)
 {
-    dst = new char[1];
-    *dst = 0;
+    dst = m_strings->Intern("");
 }
 
 template<class DerivedLoader, class StorageClass>
@@ -119,8 +108,7 @@ template<class DerivedLoader, class StorageClass>
  */
 void SQLStorageLoaderBase<DerivedLoader, StorageClass>::default_fill_to_str(uint32 /*field_pos*/, char const* /*src*/, char*& dst)
 {
-    dst = new char[1];
-    *dst = 0;
+    dst = m_strings->Intern("");
 }
 
 template<class DerivedLoader, class StorageClass>
@@ -240,6 +228,7 @@ template<class DerivedLoader, class StorageClass>
 void SQLStorageLoaderBase<DerivedLoader, StorageClass>::Load(StorageClass& store, bool error_at_empty /*= true*/)
 {
     Field* fields = NULL;
+    // only checks the table exists, the storage bounds come with the rows below
     QueryResult* result  = WorldDatabase.PQuery("SELECT MAX(%s) FROM %s", store.EntryFieldName(), store.GetTableName());
     if (!result)
     {
@@ -247,21 +236,18 @@ void SQLStorageLoaderBase<DerivedLoader, StorageClass>::Load(StorageClass& store
         Log::WaitBeforeContinueIfNeed();
         exit(1);                                            // Stop server at loading non existent table or inaccessible table
     }
+    delete result;
 
-    uint32 maxRecordId = (*result)[0].GetUInt32() + 1;
+    uint32 maxRecordId = 0;
     uint32 recordCount = 0;
     uint32 recordsize = 0;
-    delete result;
 
-    result = WorldDatabase.PQuery("SELECT COUNT(*) FROM %s", store.GetTableName());
-    if (result)
-    {
-        fields = result->Fetch();
-        recordCount = fields[0].GetUInt32();
-        delete result;
-    }
-
-    result = WorldDatabase.PQuery("SELECT * FROM %s", store.GetTableName());
+    // rows are decoded as they arrive instead of buffering the whole table first,
+    // or come from the snapshot of an unchanged table; every row also carries the
+    // max entry and row count of the same read, so a snapshot brings its own bounds
+    std::string sql = std::string("SELECT ") + store.GetTableName() + ".*, (SELECT MAX(" + store.EntryFieldName() + ") FROM " + store.GetTableName() +
+                      "), (SELECT COUNT(*) FROM " + store.GetTableName() + ") FROM " + store.GetTableName();
+    result = WorldDatabase.QuerySnapshot(store.GetTableName(), store.GetTableName(), sql.c_str());
 
     if (!result)
     {
@@ -274,7 +260,7 @@ void SQLStorageLoaderBase<DerivedLoader, StorageClass>::Load(StorageClass& store
         return;
     }
 
-    if (store.GetSrcFieldCount() != result->GetFieldCount())
+    if (store.GetSrcFieldCount() + 2 != result->GetFieldCount())
     {
         recordCount = 0;
         sLog.outError("Error in %s table.Perhaps the table structure was changed. There should be %d fields in the table.\n", store.GetTableName(), store.GetSrcFieldCount());
@@ -317,8 +303,13 @@ void SQLStorageLoaderBase<DerivedLoader, StorageClass>::Load(StorageClass& store
         }
     }
 
+    fields = result->Fetch();
+    maxRecordId = fields[store.GetSrcFieldCount()].GetUInt32() + 1;
+    recordCount = fields[store.GetSrcFieldCount() + 1].GetUInt32();
+
     // Prepare data storage and lookup storage
     store.prepareToLoad(maxRecordId, recordCount, recordsize);
+    m_strings = &store.m_arena;
 
     BarGoLink bar(recordCount);
     do
@@ -327,6 +318,11 @@ void SQLStorageLoaderBase<DerivedLoader, StorageClass>::Load(StorageClass& store
         bar.step();
 
         char* record = store.createRecord(fields[0].GetUInt32());
+        if (!record)
+        {
+            sLog.outError("%s: row with %s %u is outside of the %u records up to %u the table was sized for, skipped.", store.GetTableName(), store.EntryFieldName(), fields[0].GetUInt32(), recordCount, maxRecordId - 1);
+            continue;
+        }
         offset = 0;
 
         // dependend on dest-size
@@ -376,6 +372,10 @@ void SQLStorageLoaderBase<DerivedLoader, StorageClass>::Load(StorageClass& store
     while (result->NextRow());
 
     delete result;
+
+    store.m_arena.EndInterning();
+    sLog.outString(">> %s: %u records, %u KB used, %u KB reserved, %u KB saved by shared strings", store.GetTableName(), store.GetRecordCount(),
+                   uint32(store.m_arena.GetUsedBytes() / 1024), uint32(store.m_arena.GetReservedBytes() / 1024), uint32(store.m_arena.GetSharedStringBytes() / 1024));
 }
 
 #endif
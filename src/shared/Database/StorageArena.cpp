@@ -0,0 +1,146 @@
+/**
+ * MaNGOS is a full featured server for World of Warcraft, supporting
+ * the following clients: 1.12.x, 2.4.3, 3.3.5a, 4.3.4a and 5.4.8
+ *
+ * Copyright (C) 2005-2014  MaNGOS project <http://getmangos.eu>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * World of Warcraft, and all World of Warcraft or Warcraft art, images,
+ * and lore are copyrighted by Blizzard Entertainment, Inc.
+ */
+
+#include "StorageArena.h"
+
+/**
+ * @brief
+ *
+ * @param str
+ * @return size_t
+ */
+static size_t HashString(char const* str)
+{
+    // FNV-1a
+    uint32 hash = 2166136261u;
+    for (; *str; ++str)
+    {
+        hash ^= uint8(*str);
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+StorageArena::StorageArena(size_t blockSize) : m_blockSize(blockSize), m_current(NULL), m_left(0),
+    m_usedBytes(0), m_reservedBytes(0), m_sharedStringBytes(0), m_stringCount(0)
+{
+}
+
+char* StorageArena::Allocate(size_t size, size_t align)
+{
+    size_t padding = (align - (size_t(m_current) & (align - 1))) & (align - 1);
+    if (!m_current || padding + size > m_left)
+    {
+        // oversized requests get a block of their own, the current block stays in use
+        if (size > m_blockSize / 4)
+        {
+            char* block = new char[size];
+            m_blocks.push_back(block);
+            m_reservedBytes += size;
+            m_usedBytes += size;
+            return block;
+        }
+
+        m_current = new char[m_blockSize];
+        m_left = m_blockSize;
+        m_blocks.push_back(m_current);
+        m_reservedBytes += m_blockSize;
+        padding = 0;                                        // new[] returns memory aligned for any type
+    }
+
+    char* result = m_current + padding;
+    m_current += padding + size;
+    m_left -= padding + size;
+    m_usedBytes += size;
+    return result;
+}
+
+char* StorageArena::Intern(char const* str)
+{
+    if (!str)
+        { str = ""; }
+
+    if (m_stringCount * 2 >= m_strings.size())
+        { GrowStringTable(); }
+
+    size_t mask = m_strings.size() - 1;
+    size_t slot = HashString(str) & mask;
+    while (m_strings[slot])
+    {
+        if (!strcmp(m_strings[slot], str))
+        {
+            m_sharedStringBytes += strlen(str) + 1;
+            return m_strings[slot];
+        }
+
+        slot = (slot + 1) & mask;
+    }
+
+    size_t length = strlen(str) + 1;
+    char* copy = Allocate(length, 1);
+    memcpy(copy, str, length);
+
+    m_strings[slot] = copy;
+    ++m_stringCount;
+    return copy;
+}
+
+void StorageArena::GrowStringTable()
+{
+    std::vector<char*> old;
+    old.swap(m_strings);
+    m_strings.resize(old.empty() ? 1024 : old.size() * 2, NULL);
+
+    size_t mask = m_strings.size() - 1;
+    for (std::vector<char*>::const_iterator itr = old.begin(); itr != old.end(); ++itr)
+    {
+        if (!*itr)
+            { continue; }
+
+        size_t slot = HashString(*itr) & mask;
+        while (m_strings[slot])
+            { slot = (slot + 1) & mask; }
+        m_strings[slot] = *itr;
+    }
+}
+
+void StorageArena::EndInterning()
+{
+    std::vector<char*>().swap(m_strings);
+    m_stringCount = 0;
+}
+
+void StorageArena::Clear()
+{
+    for (std::vector<char*>::const_iterator itr = m_blocks.begin(); itr != m_blocks.end(); ++itr)
+        { delete[] *itr; }
+
+    m_blocks.clear();
+    m_current = NULL;
+    m_left = 0;
+    m_usedBytes = 0;
+    m_reservedBytes = 0;
+    m_sharedStringBytes = 0;
+    EndInterning();
+}
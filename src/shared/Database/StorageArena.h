@@ -0,0 +1,117 @@
+/**
+ * MaNGOS is a full featured server for World of Warcraft, supporting
+ * the following clients: 1.12.x, 2.4.3, 3.3.5a, 4.3.4a and 5.4.8
+ *
+ * Copyright (C) 2005-2014  MaNGOS project <http://getmangos.eu>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * World of Warcraft, and all World of Warcraft or Warcraft art, images,
+ * and lore are copyrighted by Blizzard Entertainment, Inc.
+ */
+
+#ifndef MANGOS_STORAGEARENA_H
+#define MANGOS_STORAGEARENA_H
+
+#include "Common.h"
+
+/**
+ * @brief bump pointer allocator for data that lives as long as its storage
+ *
+ * Memory is taken from large blocks and only released all at once by Clear().
+ * Strings can be interned, equal strings then share one copy.
+ */
+class StorageArena
+{
+    public:
+        /**
+         * @brief
+         *
+         * @param blockSize
+         */
+        explicit StorageArena(size_t blockSize = 64 * 1024);
+        /**
+         * @brief
+         *
+         */
+        ~StorageArena() { Clear(); }
+
+        /**
+         * @brief
+         *
+         * @param size
+         * @param align
+         * @return char
+         */
+        char* Allocate(size_t size, size_t align = sizeof(void*));
+
+        /**
+         * @brief returns the arena copy of str, equal strings are stored once
+         *
+         * @param str NULL is stored as empty string
+         * @return char
+         */
+        char* Intern(char const* str);
+        /**
+         * @brief drops the lookup table used by Intern(), the strings stay valid
+         *
+         */
+        void EndInterning();
+
+        /**
+         * @brief frees all memory handed out by the arena
+         *
+         */
+        void Clear();
+
+        /**
+         * @brief
+         *
+         * @return size_t bytes handed out
+         */
+        size_t GetUsedBytes() const { return m_usedBytes; }
+        /**
+         * @brief
+         *
+         * @return size_t bytes reserved in blocks
+         */
+        size_t GetReservedBytes() const { return m_reservedBytes; }
+        /**
+         * @brief
+         *
+         * @return size_t string bytes not stored thanks to interning
+         */
+        size_t GetSharedStringBytes() const { return m_sharedStringBytes; }
+
+    private:
+        /**
+         * @brief
+         *
+         */
+        void GrowStringTable();
+
+        std::vector<char*> m_blocks; /**< TODO */
+        size_t m_blockSize; /**< TODO */
+        char* m_current; /**< free space of the last block */
+        size_t m_left; /**< TODO */
+        size_t m_usedBytes; /**< TODO */
+        size_t m_reservedBytes; /**< TODO */
+        size_t m_sharedStringBytes; /**< TODO */
+
+        std::vector<char*> m_strings; /**< open addressing table of interned strings */
+        size_t m_stringCount; /**< TODO */
+};
+
+#endif
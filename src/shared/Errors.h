@@ -27,6 +27,23 @@
 
 #include "Common.h"
 
+/**
+ * @brief called by a failed assertion before the process stops, set while the log buffers file output
+ *
+ */
+typedef void (*AssertFlushHandler)();
+
+/**
+ * @brief
+ *
+ * @return AssertFlushHandler& NULL if nothing has to be written out
+ */
+inline AssertFlushHandler& GetAssertFlushHandler()
+{
+    static AssertFlushHandler handler = NULL;
+    return handler;
+}
+
 #ifndef HAVE_CONFIG_H
 #  define HAVE_ACE_STACK_TRACE_H 1
 #endif
@@ -43,6 +60,8 @@
         ACE_Stack_Trace st; \
         printf("%s:%i: Error: Assertion in %s failed: %s\nStack Trace:\n%s", \
                __FILE__, __LINE__, __FUNCTION__, STRINGIZE(CONDITION), st.c_str()); \
+        if (AssertFlushHandler flush = GetAssertFlushHandler()) \
+            { flush(); } \
         assert(STRINGIZE(CONDITION) && 0); \
     }
 
@@ -61,6 +80,8 @@
     { \
         printf("%s:%i: Error: Assertion in %s failed: %s", \
                __FILE__, __LINE__, __FUNCTION__, STRINGIZE(CONDITION)); \
+        if (AssertFlushHandler flush = GetAssertFlushHandler()) \
+            { flush(); } \
         assert(STRINGIZE(CONDITION) && 0); \
     }
 
@@ -29,12 +29,23 @@
 #include "Util.h"
 #include "ByteBuffer.h"
 #include "ProgressBar.h"
+#include "LogWriter.h"
 
 #include <stdarg.h>
 #include <fstream>
 #include <iostream>
 
 #include <ace/OS_NS_unistd.h>
+#include <ace/Thread.h>
+
+/**
+ * @brief
+ *
+ */
+static void FlushLogOnAssert()
+{
+    sLog.Flush();
+}
 
 INSTANTIATE_SINGLETON_1(Log);
 
@@ -61,23 +72,93 @@ LogFilterData logFilterData[LOG_FILTER_COUNT] =
     { "event_ai_dev",        "LogFilter_EventAiDev",         true  },
 };
 
-enum LogType
+const int LogType_count = int(LogError) + 1;
+
+#define LOG_RECORD_SIZE     8192                            // longer file log lines are truncated
+
+/**
+ * @brief record header of the binary log format, followed by size bytes of text
+ *
+ */
+struct LogBinaryHeader
 {
-    LogNormal = 0,
-    LogDetails,
-    LogDebug,
-    LogError
+    uint32 size; /**< TODO */
+    uint32 time; /**< unix time */
+    uint32 thread; /**< TODO */
+    uint8 type; /**< LogType */
+    uint8 unused[3]; /**< TODO */
 };
 
-const int LogType_count = int(LogError) + 1;
+/**
+ * @brief
+ *
+ * @param buf
+ * @param size
+ * @return size_t length of the timestamp written to buf
+ */
+static size_t formatTimestamp(char* buf, size_t size)
+{
+    time_t t = time(NULL);
+    tm* aTm = localtime(&t);
+    int len = snprintf(buf, size, "%-4d-%02d-%02d %02d:%02d:%02d ", aTm->tm_year + 1900, aTm->tm_mon + 1, aTm->tm_mday, aTm->tm_hour, aTm->tm_min, aTm->tm_sec);
+    return (len < 0 || size_t(len) >= size) ? 0 : size_t(len);
+}
 
 Log::Log() :
     raLogfile(NULL), logfile(NULL), gmLogfile(NULL), charLogfile(NULL),
-    dberLogfile(NULL), elunaErrLogfile(NULL), eventAiErLogfile(NULL), scriptErrLogFile(NULL), worldLogfile(NULL), m_colored(false), m_includeTime(false), m_gmlog_per_account(false), m_scriptLibName(NULL)
+    dberLogfile(NULL), elunaErrLogfile(NULL), eventAiErLogfile(NULL), scriptErrLogFile(NULL), worldLogfile(NULL), m_colored(false), m_includeTime(false), m_gmlog_per_account(false), m_scriptLibName(NULL),
+    m_writer(NULL), m_binaryFormat(false)
 {
     Initialize();
 }
 
+Log::~Log()
+{
+    // the writer itself is kept, threads still running may hold their ring
+    if (LogWriter* writer = m_writer)
+    {
+        GetAssertFlushHandler() = NULL;
+        m_writer = NULL;
+        writer->Stop();
+    }
+
+    if (logfile != NULL)
+        { fclose(logfile); }
+    logfile = NULL;
+
+    if (gmLogfile != NULL)
+        { fclose(gmLogfile); }
+    gmLogfile = NULL;
+
+    if (charLogfile != NULL)
+        { fclose(charLogfile); }
+    charLogfile = NULL;
+
+    if (dberLogfile != NULL)
+        { fclose(dberLogfile); }
+    dberLogfile = NULL;
+
+    if (elunaErrLogfile != NULL)
+        fclose(elunaErrLogfile);
+    elunaErrLogfile = NULL;
+
+    if (eventAiErLogfile != NULL)
+        { fclose(eventAiErLogfile); }
+    eventAiErLogfile = NULL;
+
+    if (scriptErrLogFile != NULL)
+        { fclose(scriptErrLogFile); }
+    scriptErrLogFile = NULL;
+
+    if (raLogfile != NULL)
+        { fclose(raLogfile); }
+    raLogfile = NULL;
+
+    if (worldLogfile != NULL)
+        { fclose(worldLogfile); }
+    worldLogfile = NULL;
+}
+
 void Log::InitColors(const std::string& str)
 {
     if (str.empty())
@@ -288,6 +369,19 @@ void Log::Initialize()
 
     // Char log settings
     m_charLog_Dump = sConfig.GetBoolDefault("CharLogDump", false);
+
+    // File output format and buffering
+    m_binaryFormat = sConfig.GetBoolDefault("LogBinaryFormat", false);
+
+    int bufferSize = sConfig.GetIntDefault("LogBufferSize", 256);
+    if (bufferSize > 0 && !m_writer)
+    {
+        m_writer = new LogWriter(uint32(bufferSize) * 1024);
+        m_writer->Start();
+
+        // a failed assertion must not lose the records queued before it
+        GetAssertFlushHandler() = &FlushLogOnAssert;
+    }
 }
 
 FILE* Log::openLogFile(char const* configFileName, char const* configTimeStampFlag, char const* mode)
@@ -320,15 +414,14 @@ FILE* Log::openGmlogPerAccount(uint32 account)
 
 void Log::outTimestamp(FILE* file)
 {
-    time_t t = time(NULL);
-    tm* aTm = localtime(&t);
     //       YYYY   year
     //       MM     month (2 digits 01-12)
     //       DD     day (2 digits 01-31)
     //       HH     hour (2 digits 00-23)
     //       MM     minutes (2 digits 00-59)
     //       SS     seconds (2 digits 00-59)
-    fprintf(file, "%-4d-%02d-%02d %02d:%02d:%02d ", aTm->tm_year + 1900, aTm->tm_mon + 1, aTm->tm_mday, aTm->tm_hour, aTm->tm_min, aTm->tm_sec);
+    char buf[32];
+    fwrite(buf, formatTimestamp(buf, sizeof(buf)), 1, file);
 }
 
 void Log::outTime()
@@ -365,11 +458,7 @@ void Log::outString()
         { outTime(); }
     printf("\n");
     if (logfile)
-    {
-        outTimestamp(logfile);
-        fprintf(logfile, "\n");
-        fflush(logfile);
-    }
+        { outFile(logfile, LogNormal, NULL, NULL, NULL); }
 
     fflush(stdout);
 }
@@ -398,14 +487,9 @@ void Log::outString(const char* str, ...)
 
     if (logfile)
     {
-        outTimestamp(logfile);
-
         va_start(ap, str);
-        vfprintf(logfile, str, ap);
-        fprintf(logfile, "\n");
+        outFile(logfile, LogNormal, NULL, str, &ap);
         va_end(ap);
-
-        fflush(logfile);
     }
 
     fflush(stdout);
@@ -434,15 +518,9 @@ void Log::outError(const char* err, ...)
     fprintf(stderr, "\n");
     if (logfile)
     {
-        outTimestamp(logfile);
-        fprintf(logfile, "ERROR:");
-
         va_start(ap, err);
-        vfprintf(logfile, err, ap);
+        outFile(logfile, LogError, "ERROR:", err, &ap);
         va_end(ap);
-
-        fprintf(logfile, "\n");
-        fflush(logfile);
     }
 
     fflush(stderr);
@@ -456,18 +534,10 @@ void Log::outErrorDb()
     fprintf(stderr, "\n");
 
     if (logfile)
-    {
-        outTimestamp(logfile);
-        fprintf(logfile, "ERROR:\n");
-        fflush(logfile);
-    }
+        { outFile(logfile, LogError, "ERROR:", NULL, NULL); }
 
     if (dberLogfile)
-    {
-        outTimestamp(dberLogfile);
-        fprintf(dberLogfile, "\n");
-        fflush(dberLogfile);
-    }
+        { outFile(dberLogfile, LogError, NULL, NULL, NULL); }
 
     fflush(stderr);
 }
@@ -496,28 +566,16 @@ void Log::outErrorDb(const char* err, ...)
 
     if (logfile)
     {
-        outTimestamp(logfile);
-        fprintf(logfile, "ERROR:");
-
         va_start(ap, err);
-        vfprintf(logfile, err, ap);
+        outFile(logfile, LogError, "ERROR:", err, &ap);
         va_end(ap);
-
-        fprintf(logfile, "\n");
-        fflush(logfile);
     }
 
     if (dberLogfile)
     {
-        outTimestamp(dberLogfile);
-
-        va_list ap;
         va_start(ap, err);
-        vfprintf(dberLogfile, err, ap);
+        outFile(dberLogfile, LogError, NULL, err, &ap);
         va_end(ap);
-
-        fprintf(dberLogfile, "\n");
-        fflush(dberLogfile);
     }
 
     fflush(stderr);
@@ -531,18 +589,10 @@ void Log::outErrorEluna()
     fprintf(stderr, "\n");
 
     if (logfile)
-    {
-        outTimestamp(logfile);
-        fprintf(logfile, "ERROR Eluna\n");
-        fflush(logfile);
-    }
+        outFile(logfile, LogError, "ERROR Eluna", NULL, NULL);
 
     if (elunaErrLogfile)
-    {
-        outTimestamp(elunaErrLogfile);
-        fprintf(elunaErrLogfile, "\n");
-        fflush(elunaErrLogfile);
-    }
+        outFile(elunaErrLogfile, LogError, NULL, NULL, NULL);
 
     fflush(stderr);
 }
@@ -571,28 +621,16 @@ void Log::outErrorEluna(const char* err, ...)
 
     if (logfile)
     {
-        outTimestamp(logfile);
-        fprintf(logfile, "ERROR Eluna: ");
-
         va_start(ap, err);
-        vfprintf(logfile, err, ap);
+        outFile(logfile, LogError, "ERROR Eluna: ", err, &ap);
         va_end(ap);
-
-        fprintf(logfile, "\n");
-        fflush(logfile);
     }
 
     if (elunaErrLogfile)
     {
-        outTimestamp(elunaErrLogfile);
-
-        va_list ap;
         va_start(ap, err);
-        vfprintf(elunaErrLogfile, err, ap);
+        outFile(elunaErrLogfile, LogError, NULL, err, &ap);
         va_end(ap);
-
-        fprintf(elunaErrLogfile, "\n");
-        fflush(elunaErrLogfile);
     }
 
     fflush(stderr);
@@ -606,18 +644,10 @@ void Log::outErrorEventAI()
     fprintf(stderr, "\n");
 
     if (logfile)
-    {
-        outTimestamp(logfile);
-        fprintf(logfile, "ERROR CreatureEventAI\n");
-        fflush(logfile);
-    }
+        { outFile(logfile, LogError, "ERROR CreatureEventAI", NULL, NULL); }
 
     if (eventAiErLogfile)
-    {
-        outTimestamp(eventAiErLogfile);
-        fprintf(eventAiErLogfile, "\n");
-        fflush(eventAiErLogfile);
-    }
+        { outFile(eventAiErLogfile, LogError, NULL, NULL, NULL); }
 
     fflush(stderr);
 }
@@ -646,28 +676,16 @@ void Log::outErrorEventAI(const char* err, ...)
 
     if (logfile)
     {
-        outTimestamp(logfile);
-        fprintf(logfile, "ERROR CreatureEventAI: ");
-
         va_start(ap, err);
-        vfprintf(logfile, err, ap);
+        outFile(logfile, LogError, "ERROR CreatureEventAI: ", err, &ap);
         va_end(ap);
-
-        fprintf(logfile, "\n");
-        fflush(logfile);
     }
 
     if (eventAiErLogfile)
     {
-        outTimestamp(eventAiErLogfile);
-
-        va_list ap;
         va_start(ap, err);
-        vfprintf(eventAiErLogfile, err, ap);
+        outFile(eventAiErLogfile, LogError, NULL, err, &ap);
         va_end(ap);
-
-        fprintf(eventAiErLogfile, "\n");
-        fflush(eventAiErLogfile);
     }
 
     fflush(stderr);
@@ -700,12 +718,9 @@ void Log::outBasic(const char* str, ...)
     if (logfile && m_logFileLevel >= LOG_LVL_BASIC)
     {
         va_list ap;
-        outTimestamp(logfile);
         va_start(ap, str);
-        vfprintf(logfile, str, ap);
-        fprintf(logfile, "\n");
+        outFile(logfile, LogDetails, NULL, str, &ap);
         va_end(ap);
-        fflush(logfile);
     }
 
     fflush(stdout);
@@ -737,15 +752,10 @@ void Log::outDetail(const char* str, ...)
 
     if (logfile && m_logFileLevel >= LOG_LVL_DETAIL)
     {
-        outTimestamp(logfile);
-
         va_list ap;
         va_start(ap, str);
-        vfprintf(logfile, str, ap);
+        outFile(logfile, LogDetails, NULL, str, &ap);
         va_end(ap);
-
-        fprintf(logfile, "\n");
-        fflush(logfile);
     }
 
     fflush(stdout);
@@ -777,15 +787,10 @@ void Log::outDebug(const char* str, ...)
 
     if (logfile && m_logFileLevel >= LOG_LVL_DEBUG)
     {
-        outTimestamp(logfile);
-
         va_list ap;
         va_start(ap, str);
-        vfprintf(logfile, str, ap);
+        outFile(logfile, LogDebug, NULL, str, &ap);
         va_end(ap);
-
-        fprintf(logfile, "\n");
-        fflush(logfile);
     }
 
     fflush(stdout);
@@ -818,16 +823,14 @@ void Log::outCommand(uint32 account, const char* str, ...)
     if (logfile && m_logFileLevel >= LOG_LVL_DETAIL)
     {
         va_list ap;
-        outTimestamp(logfile);
         va_start(ap, str);
-        vfprintf(logfile, str, ap);
-        fprintf(logfile, "\n");
+        outFile(logfile, LogDetails, NULL, str, &ap);
         va_end(ap);
-        fflush(logfile);
     }
 
     if (m_gmlog_per_account)
     {
+        // per account files are closed right away, so they are written directly
         if (FILE* per_file = openGmlogPerAccount(account))
         {
             va_list ap;
@@ -842,12 +845,9 @@ void Log::outCommand(uint32 account, const char* str, ...)
     else if (gmLogfile)
     {
         va_list ap;
-        outTimestamp(gmLogfile);
         va_start(ap, str);
-        vfprintf(gmLogfile, str, ap);
-        fprintf(gmLogfile, "\n");
+        outFile(gmLogfile, LogNormal, NULL, str, &ap);
         va_end(ap);
-        fflush(gmLogfile);
     }
 
     fflush(stdout);
@@ -861,12 +861,9 @@ void Log::outChar(const char* str, ...)
     if (charLogfile)
     {
         va_list ap;
-        outTimestamp(charLogfile);
         va_start(ap, str);
-        vfprintf(charLogfile, str, ap);
-        fprintf(charLogfile, "\n");
+        outFile(charLogfile, LogNormal, NULL, str, &ap);
         va_end(ap);
-        fflush(charLogfile);
     }
 }
 
@@ -879,20 +876,12 @@ void Log::outErrorScriptLib()
 
     if (logfile)
     {
-        outTimestamp(logfile);
-        if (m_scriptLibName)
-            { fprintf(logfile, "<%s ERROR:> ", m_scriptLibName); }
-        else
-            { fprintf(logfile, "<Scripting Library ERROR>: "); }
-        fflush(logfile);
+        std::string prefix = m_scriptLibName ? std::string("<") + m_scriptLibName + " ERROR:> " : std::string("<Scripting Library ERROR>: ");
+        outFile(logfile, LogError, prefix.c_str(), NULL, NULL);
     }
 
     if (scriptErrLogFile)
-    {
-        outTimestamp(scriptErrLogFile);
-        fprintf(scriptErrLogFile, "\n");
-        fflush(scriptErrLogFile);
-    }
+        { outFile(scriptErrLogFile, LogError, NULL, NULL, NULL); }
 
     fflush(stderr);
 }
@@ -921,31 +910,18 @@ void Log::outErrorScriptLib(const char* err, ...)
 
     if (logfile)
     {
-        outTimestamp(logfile);
-        if (m_scriptLibName)
-            { fprintf(logfile, "<%s ERROR>: ", m_scriptLibName); }
-        else
-            { fprintf(logfile, "<Scripting Library ERROR>: "); }
+        std::string prefix = m_scriptLibName ? std::string("<") + m_scriptLibName + " ERROR>: " : std::string("<Scripting Library ERROR>: ");
 
         va_start(ap, err);
-        vfprintf(logfile, err, ap);
+        outFile(logfile, LogError, prefix.c_str(), err, &ap);
         va_end(ap);
-
-        fprintf(logfile, "\n");
-        fflush(logfile);
     }
 
     if (scriptErrLogFile)
     {
-        outTimestamp(scriptErrLogFile);
-
-        va_list ap;
         va_start(ap, err);
-        vfprintf(scriptErrLogFile, err, ap);
+        outFile(scriptErrLogFile, LogError, NULL, err, &ap);
         va_end(ap);
-
-        fprintf(scriptErrLogFile, "\n");
-        fflush(scriptErrLogFile);
     }
 
     fflush(stderr);
@@ -956,33 +932,45 @@ void Log::outWorldPacketDump(uint32 socket, uint32 opcode, char const* opcodeNam
     if (!worldLogfile)
         { return; }
 
-    ACE_GUARD(ACE_Thread_Mutex, GuardObj, m_worldLogMtx);
-
-    outTimestamp(worldLogfile);
+    // the dump is built in memory and queued as one record
+    std::string dump;
+    char buf[256];
 
-    fprintf(worldLogfile, "\n%s:\nSOCKET: %u\nLENGTH: %lu\nOPCODE: %s (0x%.4X)\nDATA:\n",
-            incoming ? "CLIENT" : "SERVER",
-            socket, packet->size(), opcodeName, opcode);
+    snprintf(buf, sizeof(buf), "\n%s:\nSOCKET: %u\nLENGTH: " SIZEFMTD "\nOPCODE: %s (0x%.4X)\nDATA:\n",
+             incoming ? "CLIENT" : "SERVER",
+             socket, packet->size(), opcodeName, opcode);
+    dump.append(buf);
 
     size_t p = 0;
     while (p < packet->size())
     {
         for (size_t j = 0; j < 16 && p < packet->size(); ++j)
-            { fprintf(worldLogfile, "%.2X ", (*packet)[p++]); }
+        {
+            snprintf(buf, sizeof(buf), "%.2X ", (*packet)[p++]);
+            dump.append(buf);
+        }
 
-        fprintf(worldLogfile, "\n");
+        dump.append("\n");
     }
 
-    fprintf(worldLogfile, "\n\n");
-    fflush(worldLogfile);
+    dump.append("\n\n");
+
+    ACE_GUARD(ACE_Thread_Mutex, GuardObj, m_worldLogMtx);
+    outFileRaw(worldLogfile, LogNormal, dump.c_str(), dump.size(), true);
 }
 
 void Log::outCharDump(const char* str, uint32 account_id, uint32 guid, const char* name)
 {
     if (charLogfile)
     {
-        fprintf(charLogfile, "== START DUMP == (account: %u guid: %u name: %s )\n%s\n== END DUMP ==\n", account_id, guid, name, str);
-        fflush(charLogfile);
+        char buf[256];
+        snprintf(buf, sizeof(buf), "== START DUMP == (account: %u guid: %u name: %s )\n", account_id, guid, name);
+
+        std::string dump = buf;
+        dump.append(str);
+        dump.append("\n== END DUMP ==\n");
+
+        outFileRaw(charLogfile, LogNormal, dump.c_str(), dump.size(), false);
     }
 }
 
@@ -994,17 +982,85 @@ void Log::outRALog(const char* str, ...)
     if (raLogfile)
     {
         va_list ap;
-        outTimestamp(raLogfile);
         va_start(ap, str);
-        vfprintf(raLogfile, str, ap);
-        fprintf(raLogfile, "\n");
+        outFile(raLogfile, LogNormal, NULL, str, &ap);
         va_end(ap);
-        fflush(raLogfile);
     }
 
     fflush(stdout);
 }
 
+void Log::outFile(FILE* file, LogType type, char const* prefix, char const* str, va_list* ap)
+{
+    char buf[LOG_RECORD_SIZE];
+    size_t pos = m_binaryFormat ? sizeof(LogBinaryHeader) : formatTimestamp(buf, LOG_RECORD_SIZE);
+
+    // one byte stays free for the line end
+    size_t room = LOG_RECORD_SIZE - pos - 1;
+    if (prefix)
+    {
+        size_t len = std::min(strlen(prefix), room - 1);
+        memcpy(buf + pos, prefix, len);
+        pos += len;
+        room -= len;
+    }
+
+    if (str)
+    {
+        // overlong messages are truncated
+        int len = vsnprintf(buf + pos, room, str, *ap);
+        pos += (len < 0 || size_t(len) >= room) ? room - 1 : size_t(len);
+    }
+
+    if (!m_binaryFormat)
+        { buf[pos++] = '\n'; }
+
+    writeRecord(file, type, buf, pos);
+}
+
+void Log::outFileRaw(FILE* file, LogType type, char const* data, size_t size, bool timestamp)
+{
+    std::string record;
+    if (m_binaryFormat)
+        { record.append(sizeof(LogBinaryHeader), '\0'); }
+    else if (timestamp)
+    {
+        char buf[32];
+        record.append(buf, formatTimestamp(buf, sizeof(buf)));
+    }
+
+    record.append(data, size);
+    writeRecord(file, type, &record[0], record.size());
+}
+
+void Log::writeRecord(FILE* file, LogType type, char* record, size_t size)
+{
+    if (m_binaryFormat)
+    {
+        LogBinaryHeader header;
+        header.size = uint32(size - sizeof(LogBinaryHeader));
+        header.time = uint32(time(NULL));
+        header.thread = uint32(size_t(ACE_Thread::self()));
+        header.type = uint8(type);
+        memset(header.unused, 0, sizeof(header.unused));
+        memcpy(record, &header, sizeof(header));
+    }
+
+    if (m_writer)
+        { m_writer->Write(file, record, uint32(size)); }
+    else
+    {
+        fwrite(record, size, 1, file);
+        fflush(file);
+    }
+}
+
+void Log::Flush()
+{
+    if (m_writer)
+        { m_writer->Flush(); }
+}
+
 void Log::WaitBeforeContinueIfNeed()
 {
     int mode = sConfig.GetIntDefault("WaitAtStartupError", 0);
@@ -30,6 +30,7 @@
 
 class Config;
 class ByteBuffer;
+class LogWriter;
 
 /**
  * @brief various levels for logging
@@ -110,6 +111,18 @@ enum Color
 
 const int Color_count = int(WHITE) + 1; /**< TODO */
 
+/**
+ * @brief kind of a log message, selects its color
+ *
+ */
+enum LogType
+{
+    LogNormal = 0,
+    LogDetails,
+    LogDebug,
+    LogError
+};
+
 /**
  * @brief
  *
@@ -127,44 +140,7 @@ class Log : public MaNGOS::Singleton<Log, MaNGOS::ClassLevelLockable<Log, ACE_Th
          * @brief
          *
          */
-        ~Log()
-        {
-            if (logfile != NULL)
-                { fclose(logfile); }
-            logfile = NULL;
-
-            if (gmLogfile != NULL)
-                { fclose(gmLogfile); }
-            gmLogfile = NULL;
-
-            if (charLogfile != NULL)
-                { fclose(charLogfile); }
-            charLogfile = NULL;
-
-            if (dberLogfile != NULL)
-                { fclose(dberLogfile); }
-            dberLogfile = NULL;
-
-            if (elunaErrLogfile != NULL)
-                fclose(elunaErrLogfile);
-            elunaErrLogfile = NULL;
-
-            if (eventAiErLogfile != NULL)
-                { fclose(eventAiErLogfile); }
-            eventAiErLogfile = NULL;
-
-            if (scriptErrLogFile != NULL)
-                { fclose(scriptErrLogFile); }
-            scriptErrLogFile = NULL;
-
-            if (raLogfile != NULL)
-                { fclose(raLogfile); }
-            raLogfile = NULL;
-
-            if (worldLogfile != NULL)
-                { fclose(worldLogfile); }
-            worldLogfile = NULL;
-        }
+        ~Log();
     public:
         /**
          * @brief
@@ -379,6 +355,12 @@ class Log : public MaNGOS::Singleton<Log, MaNGOS::ClassLevelLockable<Log, ACE_Th
          * @return bool
          */
         bool IsIncludeTime() const { return m_includeTime; }
+        /**
+         * @brief
+         *
+         * @return std::string directory of the log files, with trailing slash if set
+         */
+        std::string const& GetLogsDir() const { return m_logsDir; }
 
         /**
          * @brief
@@ -386,6 +368,12 @@ class Log : public MaNGOS::Singleton<Log, MaNGOS::ClassLevelLockable<Log, ACE_Th
          */
         static void WaitBeforeContinueIfNeed();
 
+        /**
+         * @brief writes out the file output buffered so far
+         *
+         */
+        void Flush();
+
         /**
          * @brief Set filename for scriptlibrary error output
          *
@@ -412,6 +400,36 @@ class Log : public MaNGOS::Singleton<Log, MaNGOS::ClassLevelLockable<Log, ACE_Th
          */
         FILE* openGmlogPerAccount(uint32 account);
 
+        /**
+         * @brief writes one line to a log file
+         *
+         * @param file
+         * @param type
+         * @param prefix may be NULL
+         * @param str may be NULL
+         * @param ap arguments for str
+         */
+        void outFile(FILE* file, LogType type, char const* prefix, char const* str, va_list* ap);
+        /**
+         * @brief writes preformatted text to a log file
+         *
+         * @param file
+         * @param type
+         * @param data
+         * @param size
+         * @param timestamp
+         */
+        void outFileRaw(FILE* file, LogType type, char const* data, size_t size, bool timestamp);
+        /**
+         * @brief
+         *
+         * @param file
+         * @param type
+         * @param record text, in binary format after room for the header
+         * @param size
+         */
+        void writeRecord(FILE* file, LogType type, char* record, size_t size);
+
         FILE* raLogfile; /**< TODO */
         FILE* logfile; /**< TODO */
         FILE* gmLogfile; /**< TODO */
@@ -442,6 +460,10 @@ class Log : public MaNGOS::Singleton<Log, MaNGOS::ClassLevelLockable<Log, ACE_Th
         std::string m_gmlog_filename_format; /**< TODO */
 
         char const* m_scriptLibName; /**< TODO */
+
+        // file output
+        LogWriter* m_writer; /**< queues file output for the writer thread, NULL writes directly */
+        bool m_binaryFormat; /**< TODO */
 };
 
 #define sLog MaNGOS::Singleton<Log>::Instance()
@@ -0,0 +1,239 @@
+/**
+ * MaNGOS is a full featured server for World of Warcraft, supporting
+ * the following clients: 1.12.x, 2.4.3, 3.3.5a, 4.3.4a and 5.4.8
+ *
+ * Copyright (C) 2005-2014  MaNGOS project <http://getmangos.eu>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * World of Warcraft, and all World of Warcraft or Warcraft art, images,
+ * and lore are copyrighted by Blizzard Entertainment, Inc.
+ */
+
+
+#include "LogWriter.h"
+#include "Log.h"
+
+#include <ace/OS_NS_unistd.h>
+
+/**
+ * @brief position and size of a queued record, followed by its data
+ *
+ */
+struct LogRecordHeader
+{
+    FILE* file; /**< NULL marks the unused end of the ring */
+    uint32 size; /**< TODO */
+};
+
+#define LOG_RECORD_ALIGN    16                              // >= sizeof(LogRecordHeader), keeps headers from splitting at the ring end
+#define LOG_WRITER_DELAY    10                              // ms between batches
+
+LogRing::LogRing(uint32 capacity) : m_head(0), m_tail(0), m_dropped(0), m_orphaned(0)
+{
+    m_capacity = 4096;
+    while (m_capacity < capacity)
+        { m_capacity <<= 1; }
+
+    m_buffer = new char[m_capacity];
+}
+
+LogRing::~LogRing()
+{
+    delete[] m_buffer;
+}
+
+uint32 LogRing::RecordSize(uint32 size)
+{
+    return (sizeof(LogRecordHeader) + size + LOG_RECORD_ALIGN - 1) & ~uint32(LOG_RECORD_ALIGN - 1);
+}
+
+bool LogRing::Push(FILE* file, char const* data, uint32 size)
+{
+    uint32 need = RecordSize(size);
+
+    unsigned long head = m_head.value();
+    unsigned long tail = m_tail.value();
+
+    // a record does not wrap, the rest of the ring is skipped instead
+    uint32 offset = uint32(head & (m_capacity - 1));
+    uint32 toEnd = m_capacity - offset;
+    uint32 total = need <= toEnd ? need : toEnd + need;
+
+    if (m_capacity - uint32(head - tail) < total)
+    {
+        ++m_dropped;
+        return false;
+    }
+
+    if (need > toEnd)
+    {
+        LogRecordHeader* marker = reinterpret_cast<LogRecordHeader*>(m_buffer + offset);
+        marker->file = NULL;
+        marker->size = toEnd;
+        offset = 0;
+    }
+
+    LogRecordHeader* header = reinterpret_cast<LogRecordHeader*>(m_buffer + offset);
+    header->file = file;
+    header->size = size;
+    memcpy(header + 1, data, size);
+
+    // publish the record only after it is complete
+    m_head = head + total;
+    return true;
+}
+
+void LogRing::Drain(std::set<FILE*>& touched)
+{
+    unsigned long tail = m_tail.value();
+    unsigned long head = m_head.value();
+
+    while (tail != head)
+    {
+        LogRecordHeader const* header = reinterpret_cast<LogRecordHeader const*>(m_buffer + (tail & (m_capacity - 1)));
+        if (!header->file)
+        {
+            tail += header->size;
+            continue;
+        }
+
+        fwrite(header + 1, header->size, 1, header->file);
+        touched.insert(header->file);
+        tail += RecordSize(header->size);
+    }
+
+    m_tail = tail;
+}
+
+LogWriter::LogWriter(uint32 ringSize) : m_ringSize(ringSize), m_stop(0), m_droppedTotal(0)
+{
+}
+
+void LogWriter::Start()
+{
+    m_stop = 0;
+    activate();
+}
+
+void LogWriter::Stop()
+{
+    if (m_stop.value())
+        { return; }
+
+    m_stop = 1;
+    wait();
+    Drain();
+}
+
+void LogWriter::Flush()
+{
+    Drain();
+}
+
+void LogWriter::Write(FILE* file, char const* data, uint32 size)
+{
+    LogRing* ring = m_stop.value() ? NULL : GetRing();
+    if (!ring)
+    {
+        // not running, stdio keeps single writes intact
+        fwrite(data, size, 1, file);
+        fflush(file);
+        return;
+    }
+
+    if (!ring->Fits(size))
+    {
+        // too big for the ring, the records queued before it by this thread go first
+        ACE_GUARD(ACE_Thread_Mutex, guard, m_lock);
+
+        std::set<FILE*> touched;
+        ring->Drain(touched);
+        for (std::set<FILE*>::const_iterator itr = touched.begin(); itr != touched.end(); ++itr)
+            { fflush(*itr); }
+
+        fwrite(data, size, 1, file);
+        fflush(file);
+        return;
+    }
+
+    ring->Push(file, data, size);
+}
+
+LogRing* LogWriter::GetRing()
+{
+    RingOwner* owner = m_owner.ts_object();
+    if (!owner)
+        { return NULL; }
+
+    if (!owner->ring)
+    {
+        owner->ring = new LogRing(m_ringSize);
+
+        ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, m_lock, owner->ring);
+        m_rings.push_back(owner->ring);
+    }
+
+    return owner->ring;
+}
+
+void LogWriter::Drain()
+{
+    long dropped = 0;
+    {
+        ACE_GUARD(ACE_Thread_Mutex, guard, m_lock);
+
+        std::set<FILE*> touched;
+        for (RingList::iterator itr = m_rings.begin(); itr != m_rings.end();)
+        {
+            // check before draining, a ring orphaned meanwhile still gets its last records written
+            bool orphaned = (*itr)->IsOrphaned();
+
+            (*itr)->Drain(touched);
+            dropped += (*itr)->TakeDropped();
+
+            if (orphaned)
+            {
+                delete *itr;
+                itr = m_rings.erase(itr);
+            }
+            else
+                { ++itr; }
+        }
+
+        for (std::set<FILE*>::const_iterator itr = touched.begin(); itr != touched.end(); ++itr)
+            { fflush(*itr); }
+    }
+
+    if (dropped)
+    {
+        m_droppedTotal += dropped;
+
+        // the final drain runs while the log shuts down
+        if (!m_stop.value())
+            { sLog.outError("Log buffer full, %ld log messages dropped", dropped); }
+    }
+}
+
+int LogWriter::svc()
+{
+    while (!m_stop.value())
+    {
+        Drain();
+        ACE_OS::sleep(ACE_Time_Value(0, LOG_WRITER_DELAY * 1000));
+    }
+
+    return 0;
+}
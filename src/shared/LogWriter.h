@@ -0,0 +1,206 @@
+/**
+ * MaNGOS is a full featured server for World of Warcraft, supporting
+ * the following clients: 1.12.x, 2.4.3, 3.3.5a, 4.3.4a and 5.4.8
+ *
+ * Copyright (C) 2005-2014  MaNGOS project <http://getmangos.eu>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * World of Warcraft, and all World of Warcraft or Warcraft art, images,
+ * and lore are copyrighted by Blizzard Entertainment, Inc.
+ */
+
+
+#ifndef MANGOSSERVER_LOGWRITER_H
+#define MANGOSSERVER_LOGWRITER_H
+
+#include "Common.h"
+
+#include <ace/Atomic_Op.h>
+#include <ace/TSS_T.h>
+#include <ace/Task.h>
+#include <ace/Thread_Mutex.h>
+
+/**
+ * @brief ring of finished log records, filled by one thread and emptied by the writer
+ *
+ * Producer and consumer only share the two positions, so pushing a record
+ * never takes a lock. A full ring drops the record and counts it.
+ */
+class LogRing
+{
+    public:
+        /**
+         * @brief
+         *
+         * @param capacity rounded up to a power of two
+         */
+        explicit LogRing(uint32 capacity);
+        /**
+         * @brief
+         *
+         */
+        ~LogRing();
+
+        /**
+         * @brief producer side, copies the record into the ring
+         *
+         * @param file
+         * @param data
+         * @param size
+         * @return bool false if the ring was full and the record dropped
+         */
+        bool Push(FILE* file, char const* data, uint32 size);
+        /**
+         * @brief consumer side, writes all queued records to their files
+         *
+         * @param touched files written to, to be flushed by the caller
+         */
+        void Drain(std::set<FILE*>& touched);
+
+        /**
+         * @brief
+         *
+         * @param size
+         * @return bool true if a record of this size can ever be pushed
+         */
+        bool Fits(uint32 size) const { return RecordSize(size) <= m_capacity / 2; }
+        /**
+         * @brief
+         *
+         * @return long records dropped since the last call
+         */
+        long TakeDropped() { long dropped = m_dropped.value(); m_dropped -= dropped; return dropped; }
+
+        /**
+         * @brief the owning thread has ended, the ring is freed once drained
+         *
+         */
+        void Orphan() { m_orphaned = 1; }
+        /**
+         * @brief
+         *
+         * @return bool
+         */
+        bool IsOrphaned() const { return m_orphaned.value() != 0; }
+
+    private:
+        /**
+         * @brief
+         *
+         * @param size
+         * @return uint32 bytes taken by a record with size bytes of data
+         */
+        static uint32 RecordSize(uint32 size);
+
+        char* m_buffer; /**< TODO */
+        uint32 m_capacity; /**< TODO */
+        ACE_Atomic_Op<ACE_Thread_Mutex, unsigned long> m_head; /**< written by the producer only */
+        ACE_Atomic_Op<ACE_Thread_Mutex, unsigned long> m_tail; /**< written by the consumer only */
+        ACE_Atomic_Op<ACE_Thread_Mutex, long> m_dropped; /**< TODO */
+        ACE_Atomic_Op<ACE_Thread_Mutex, long> m_orphaned; /**< TODO */
+};
+
+/**
+ * @brief background thread writing the log records queued by all other threads
+ *
+ * Every thread gets its own LogRing on first use. The writer drains them
+ * in batches and flushes each file once per batch instead of once per line.
+ */
+class LogWriter : protected ACE_Task_Base
+{
+    public:
+        /**
+         * @brief
+         *
+         * @param ringSize bytes buffered per writing thread
+         */
+        explicit LogWriter(uint32 ringSize);
+
+        /**
+         * @brief
+         *
+         */
+        void Start();
+        /**
+         * @brief writes out what is queued and ends the thread, later records are written directly
+         *
+         */
+        void Stop();
+        /**
+         * @brief writes out everything queued so far by all threads
+         *
+         */
+        void Flush();
+
+        /**
+         * @brief queues a finished record for file
+         *
+         * @param file
+         * @param data
+         * @param size
+         */
+        void Write(FILE* file, char const* data, uint32 size);
+
+        /**
+         * @brief
+         *
+         * @return long records dropped because a ring was full
+         */
+        long GetDroppedCount() const { return m_droppedTotal.value(); }
+
+    private:
+        /**
+         * @brief
+         *
+         * @return int
+         */
+        virtual int svc();
+
+        /**
+         * @brief
+         *
+         * @return LogRing the ring of the calling thread
+         */
+        LogRing* GetRing();
+        /**
+         * @brief
+         *
+         */
+        void Drain();
+
+        /**
+         * @brief per thread holder, marks the ring orphaned at thread exit
+         *
+         */
+        struct RingOwner
+        {
+            RingOwner() : ring(NULL) {}
+            ~RingOwner() { if (ring) { ring->Orphan(); } }
+
+            LogRing* ring; /**< TODO */
+        };
+
+        typedef std::vector<LogRing*> RingList;
+
+        ACE_TSS<RingOwner> m_owner; /**< TODO */
+        RingList m_rings; /**< TODO */
+        ACE_Thread_Mutex m_lock; /**< guards m_rings and the consumer side of all rings */
+        uint32 m_ringSize; /**< TODO */
+        ACE_Atomic_Op<ACE_Thread_Mutex, long> m_stop; /**< TODO */
+        ACE_Atomic_Op<ACE_Thread_Mutex, long> m_droppedTotal; /**< TODO */
+};
+
+#endif
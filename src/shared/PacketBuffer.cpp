@@ -0,0 +1,360 @@
+/**
+ * MaNGOS is a full featured server for World of Warcraft, supporting
+ * the following clients: 1.12.x, 2.4.3, 3.3.5a, 4.3.4a and 5.4.8
+ *
+ * Copyright (C) 2005-2014  MaNGOS project <http://getmangos.eu>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * World of Warcraft, and all World of Warcraft or Warcraft art, images,
+ * and lore are copyrighted by Blizzard Entertainment, Inc.
+ */
+
+#include "PacketBuffer.h"
+
+#include <ace/Guard_T.h>
+#include <ace/TSS_T.h>
+#include <ace/Thread_Mutex.h>
+
+#include <vector>
+
+namespace
+{
+    struct PacketBufferCache;
+
+    /**
+     * @brief placed in front of every pooled block
+     *
+     */
+    struct BlockHeader
+    {
+        PacketBufferCache* owner;   /**< cache of the thread that allocated the block */
+        BlockHeader* next;          /**< free list link while the block is cached */
+    };
+
+    static const size_t HEADER_SIZE = 16; /**< sizeof(BlockHeader) rounded up to keep the payload 16 byte aligned */
+
+    /**
+     * @brief free lists and unflushed counters of one thread
+     *
+     * Blocks freed by their owner go to the lock free local lists. Blocks
+     * freed by any other thread are handed back through the returned lists,
+     * which the owner takes over in one go when a local list runs dry.
+     */
+    struct PacketBufferCache
+    {
+        static const uint32 FLUSH_INTERVAL = 256; /**< operations between counter flushes */
+
+        PacketBufferCache() : orphaned(false), remoteReturned(0), remoteReleased(0), allocations(0), poolHits(0), oversized(0), released(0), returned(0), pending(0)
+        {
+            memset(heads, 0, sizeof(heads));
+            memset(depth, 0, sizeof(depth));
+            memset(returnedHeads, 0, sizeof(returnedHeads));
+            memset(returnedDepth, 0, sizeof(returnedDepth));
+        }
+
+        void Flush();
+        BlockHeader* Reclaim(uint32 index);
+        bool Return(BlockHeader* block, uint32 index);
+        void Orphan();
+
+        BlockHeader* heads[PacketBufferPool::CLASS_COUNT];          /**< TODO */
+        uint32 depth[PacketBufferPool::CLASS_COUNT];                /**< TODO */
+
+        ACE_Thread_Mutex returnLock;                                /**< guards the members below */
+        BlockHeader* returnedHeads[PacketBufferPool::CLASS_COUNT];  /**< TODO */
+        uint32 returnedDepth[PacketBufferPool::CLASS_COUNT];        /**< TODO */
+        bool orphaned;                                              /**< owner thread exited, nothing is cached */
+        uint64 remoteReturned;                                      /**< TODO */
+        uint64 remoteReleased;                                      /**< TODO */
+
+        uint64 allocations;                                         /**< TODO */
+        uint64 poolHits;                                            /**< TODO */
+        uint64 oversized;                                           /**< TODO */
+        uint64 released;                                            /**< TODO */
+        uint64 returned;                                            /**< TODO */
+        uint32 pending;                                             /**< TODO */
+    };
+
+    /**
+     * @brief thread-specific owner of a cache
+     *
+     * Blocks of a thread may outlive it, so its cache is never deleted. At
+     * thread exit it is emptied and parked until another thread adopts it.
+     */
+    struct PacketBufferCacheHandle
+    {
+        PacketBufferCacheHandle() : cache(NULL) { }
+        ~PacketBufferCacheHandle();
+
+        PacketBufferCache* cache; /**< TODO */
+    };
+
+    typedef std::vector<PacketBufferCache*> OrphanedCaches;
+
+    ACE_Thread_Mutex sStatsLock;
+    PacketBufferStats sStats = { 0, 0, 0, 0, 0 };
+
+    // never destroyed: packets owned by static objects may be freed after
+    // the usual static destructors have run
+    ACE_TSS<PacketBufferCacheHandle>* sCaches = new ACE_TSS<PacketBufferCacheHandle>();
+    ACE_Thread_Mutex* sOrphansLock = new ACE_Thread_Mutex();
+    OrphanedCaches* sOrphans = new OrphanedCaches();
+
+    void PacketBufferCache::Flush()
+    {
+        {
+            ACE_GUARD(ACE_Thread_Mutex, guard, returnLock);
+            returned += remoteReturned;
+            released += remoteReleased;
+            remoteReturned = remoteReleased = 0;
+        }
+
+        ACE_GUARD(ACE_Thread_Mutex, guard, sStatsLock);
+        sStats.allocations += allocations;
+        sStats.poolHits += poolHits;
+        sStats.oversized += oversized;
+        sStats.released += released;
+        sStats.returned += returned;
+        allocations = poolHits = oversized = released = returned = 0;
+        pending = 0;
+    }
+
+    /**
+     * @brief moves the blocks other threads handed back into the local list
+     *
+     * @return the new head of the local list, NULL if nothing came back
+     */
+    BlockHeader* PacketBufferCache::Reclaim(uint32 index)
+    {
+        ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, returnLock, NULL);
+        heads[index] = returnedHeads[index];
+        depth[index] = returnedDepth[index];
+        returnedHeads[index] = NULL;
+        returnedDepth[index] = 0;
+        return heads[index];
+    }
+
+    /**
+     * @brief hands a block freed on another thread back to this cache
+     *
+     * @return false if the block has to go back to the heap instead
+     */
+    bool PacketBufferCache::Return(BlockHeader* block, uint32 index)
+    {
+        ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, returnLock, false);
+        if (orphaned || returnedDepth[index] >= PacketBufferPool::CACHE_DEPTH)
+        {
+            ++remoteReleased;
+            return false;
+        }
+
+        block->next = returnedHeads[index];
+        returnedHeads[index] = block;
+        ++returnedDepth[index];
+        ++remoteReturned;
+        return true;
+    }
+
+    /**
+     * @brief frees every cached block once the owner thread exits
+     *
+     */
+    void PacketBufferCache::Orphan()
+    {
+        for (uint32 i = 0; i < PacketBufferPool::CLASS_COUNT; ++i)
+        {
+            while (BlockHeader* block = heads[i])
+            {
+                heads[i] = block->next;
+                free(block);
+                ++released;
+            }
+            depth[i] = 0;
+        }
+
+        {
+            ACE_GUARD(ACE_Thread_Mutex, guard, returnLock);
+            for (uint32 i = 0; i < PacketBufferPool::CLASS_COUNT; ++i)
+            {
+                while (BlockHeader* block = returnedHeads[i])
+                {
+                    returnedHeads[i] = block->next;
+                    free(block);
+                    ++released;
+                }
+                returnedDepth[i] = 0;
+            }
+            orphaned = true;
+        }
+
+        Flush();
+    }
+
+    PacketBufferCacheHandle::~PacketBufferCacheHandle()
+    {
+        if (!cache)
+            { return; }
+
+        cache->Orphan();
+
+        ACE_GUARD(ACE_Thread_Mutex, guard, *sOrphansLock);
+        sOrphans->push_back(cache);
+    }
+
+    /**
+     * @brief cache of the calling thread, adopting a parked one if possible
+     *
+     */
+    PacketBufferCache* LocalCache()
+    {
+        PacketBufferCacheHandle* handle = sCaches->ts_object();
+        if (!handle)
+        {
+            handle = new PacketBufferCacheHandle();
+            sCaches->ts_object(handle);
+        }
+
+        if (!handle->cache)
+        {
+            {
+                ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, *sOrphansLock, NULL);
+                if (!sOrphans->empty())
+                {
+                    handle->cache = sOrphans->back();
+                    sOrphans->pop_back();
+                }
+            }
+
+            if (handle->cache)
+            {
+                ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, handle->cache->returnLock, NULL);
+                handle->cache->orphaned = false;
+            }
+            else
+                { handle->cache = new PacketBufferCache(); }
+        }
+
+        return handle->cache;
+    }
+
+    /**
+     * @brief cache of the calling thread without creating one
+     *
+     */
+    inline PacketBufferCache* CurrentCache()
+    {
+        PacketBufferCacheHandle* handle = sCaches->ts_object();
+        return handle ? handle->cache : NULL;
+    }
+
+    /**
+     * @brief index of the smallest class holding bytes, CLASS_COUNT if none does
+     *
+     */
+    inline uint32 SizeClass(size_t bytes)
+    {
+        uint32 index = 0;
+        for (size_t size = PacketBufferPool::MIN_CLASS; size < bytes; size <<= 1)
+        {
+            if (++index == PacketBufferPool::CLASS_COUNT)
+                { break; }
+        }
+        return index;
+    }
+}
+
+void* PacketBufferPool::Allocate(size_t bytes)
+{
+    PacketBufferCache* cache = LocalCache();
+    if (!cache)
+        { throw std::bad_alloc(); }
+
+    ++cache->allocations;
+    if (++cache->pending >= PacketBufferCache::FLUSH_INTERVAL)
+        { cache->Flush(); }
+
+    uint32 index = SizeClass(bytes);
+
+    if (index == CLASS_COUNT)
+    {
+        ++cache->oversized;
+        void* ptr = malloc(bytes);
+        if (!ptr)
+            { throw std::bad_alloc(); }
+        return ptr;
+    }
+
+    BlockHeader* block = cache->heads[index];
+    if (!block)
+        { block = cache->Reclaim(index); }
+
+    if (block)
+    {
+        cache->heads[index] = block->next;
+        --cache->depth[index];
+        ++cache->poolHits;
+    }
+    else
+    {
+        block = static_cast<BlockHeader*>(malloc(HEADER_SIZE + (MIN_CLASS << index)));
+        if (!block)
+            { throw std::bad_alloc(); }
+        block->owner = cache;
+    }
+
+    return reinterpret_cast<char*>(block) + HEADER_SIZE;
+}
+
+void PacketBufferPool::Deallocate(void* ptr, size_t bytes)
+{
+    if (!ptr)
+        { return; }
+
+    uint32 index = SizeClass(bytes);
+    if (index == CLASS_COUNT)
+    {
+        free(ptr);
+        return;
+    }
+
+    BlockHeader* block = reinterpret_cast<BlockHeader*>(static_cast<char*>(ptr) - HEADER_SIZE);
+    PacketBufferCache* cache = CurrentCache();
+
+    if (cache != block->owner)
+    {
+        // freed on another thread, the owner counts it either way
+        if (!block->owner->Return(block, index))
+            { free(block); }
+        return;
+    }
+
+    if (cache->depth[index] >= CACHE_DEPTH)
+    {
+        ++cache->released;
+        free(block);
+        return;
+    }
+
+    block->next = cache->heads[index];
+    cache->heads[index] = block;
+    ++cache->depth[index];
+}
+
+void PacketBufferPool::GetStats(PacketBufferStats& stats)
+{
+    ACE_GUARD(ACE_Thread_Mutex, guard, sStatsLock);
+    stats = sStats;
+}
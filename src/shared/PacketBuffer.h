@@ -0,0 +1,143 @@
+/**
+ * MaNGOS is a full featured server for World of Warcraft, supporting
+ * the following clients: 1.12.x, 2.4.3, 3.3.5a, 4.3.4a and 5.4.8
+ *
+ * Copyright (C) 2005-2014  MaNGOS project <http://getmangos.eu>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * World of Warcraft, and all World of Warcraft or Warcraft art, images,
+ * and lore are copyrighted by Blizzard Entertainment, Inc.
+ */
+
+#ifndef MANGOSSERVER_PACKETBUFFER_H
+#define MANGOSSERVER_PACKETBUFFER_H
+
+#include "Common.h"
+
+#include <limits>
+#include <new>
+
+/**
+ * @brief snapshot of the packet buffer pool counters, summed over all threads
+ *
+ */
+struct PacketBufferStats
+{
+    uint64 allocations;     /**< every buffer handed out */
+    uint64 poolHits;        /**< buffers reused from a thread cache */
+    uint64 oversized;       /**< larger than the biggest size class, always from the heap */
+    uint64 released;        /**< buffers returned to the heap because a cache was full */
+    uint64 returned;        /**< buffers freed on another thread and handed back to their owner's cache */
+};
+
+/**
+ * @brief thread-local size-class pool backing ByteBuffer storage
+ *
+ * Requests are rounded up to a power of two between MIN_CLASS and MAX_CLASS.
+ * Every thread keeps a short free list per class, so the typical packet is
+ * built, sent and freed without touching the heap. Each block remembers the
+ * thread cache it came from. A block freed on another thread, like an incoming
+ * packet read by the network thread and handled by a map thread, is handed
+ * back to that cache under a per-cache lock, or goes back to the heap once the
+ * cache for its class is full.
+ */
+class PacketBufferPool
+{
+    public:
+        static const size_t MIN_CLASS = 32;                 /**< smallest block, in bytes */
+        static const size_t MAX_CLASS = 16384;              /**< largest pooled block, in bytes */
+        static const uint32 CLASS_COUNT = 10;               /**< log2(MAX_CLASS / MIN_CLASS) + 1 */
+        static const uint32 CACHE_DEPTH = 64;               /**< cached blocks per class and thread */
+
+        /**
+         * @brief
+         *
+         * @param bytes
+         * @return void
+         */
+        static void* Allocate(size_t bytes);
+        /**
+         * @brief
+         *
+         * @param ptr
+         * @param bytes must be the size passed to Allocate
+         */
+        static void Deallocate(void* ptr, size_t bytes);
+
+        /**
+         * @brief
+         *
+         * @param stats
+         */
+        static void GetStats(PacketBufferStats& stats);
+};
+
+/**
+ * @brief std::allocator replacement drawing from PacketBufferPool
+ *
+ * Stateless, so any two instances compare equal and containers may swap
+ * their storage freely.
+ */
+template<class T>
+class PacketAllocator
+{
+    public:
+        typedef T value_type;               /**< TODO */
+        typedef T* pointer;                 /**< TODO */
+        typedef T const* const_pointer;     /**< TODO */
+        typedef T& reference;               /**< TODO */
+        typedef T const& const_reference;   /**< TODO */
+        typedef size_t size_type;           /**< TODO */
+        typedef ptrdiff_t difference_type;  /**< TODO */
+
+        /**
+         * @brief
+         *
+         */
+        template<class U>
+        struct rebind
+        {
+            typedef PacketAllocator<U> other; /**< TODO */
+        };
+
+        PacketAllocator() { }
+        PacketAllocator(PacketAllocator const&) { }
+        template<class U> PacketAllocator(PacketAllocator<U> const&) { }
+
+        pointer address(reference x) const { return &x; }
+        const_pointer address(const_reference x) const { return &x; }
+
+        pointer allocate(size_type n, void const* /*hint*/ = 0)
+        {
+            return static_cast<pointer>(PacketBufferPool::Allocate(n * sizeof(T)));
+        }
+        void deallocate(pointer p, size_type n)
+        {
+            PacketBufferPool::Deallocate(p, n * sizeof(T));
+        }
+
+        size_type max_size() const { return std::numeric_limits<size_type>::max() / sizeof(T); }
+
+        void construct(pointer p, const_reference val) { new(static_cast<void*>(p)) T(val); }
+        void destroy(pointer p) { p->~T(); }
+};
+
+template<class T, class U>
+inline bool operator==(PacketAllocator<T> const&, PacketAllocator<U> const&) { return true; }
+template<class T, class U>
+inline bool operator!=(PacketAllocator<T> const&, PacketAllocator<U> const&) { return false; }
+
+#endif
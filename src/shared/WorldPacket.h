@@ -61,6 +61,17 @@ class WorldPacket : public ByteBuffer
         {
         }
 
+        /**
+         * @brief exchanges opcode and contents without copying
+         *
+         * @param packet
+         */
+        void swap(WorldPacket& packet)
+        {
+            ByteBuffer::swap(packet);
+            std::swap(m_opcode, packet.m_opcode);
+        }
+
         /**
          * @brief
          *
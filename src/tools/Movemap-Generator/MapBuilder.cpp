@@ -31,13 +31,32 @@
 #include "MapTree.h"
 #include "ModelInstance.h"
 
+#include "Timer.h"
+
 using namespace VMAP;
 
 namespace MMAP
 {
+    /**
+     * @brief builds queued tiles on its own thread
+     *
+     */
+    class TileBuilderThread : public ACE_Based::Runnable
+    {
+        public:
+            explicit TileBuilderThread(MapBuilder& builder) : m_builder(builder) {}
+
+            void run() override { m_builder.processTileJobs(); }
+
+        private:
+            MapBuilder& m_builder; /**< TODO */
+    };
+
+    /**************************************************************************/
     MapBuilder::MapBuilder(float maxWalkableAngle, bool skipLiquid,
                            bool skipContinents, bool skipJunkMaps, bool skipBattlegrounds,
-                           bool debugOutput, bool bigBaseUnit, const char* offMeshFilePath) :
+                           bool debugOutput, bool bigBaseUnit, const char* offMeshFilePath,
+                           uint32 threads) :
         m_terrainBuilder(NULL),
         m_debugOutput(debugOutput),
         m_skipContinents(skipContinents),
@@ -46,7 +65,11 @@ namespace MMAP
         m_maxWalkableAngle(maxWalkableAngle),
         m_bigBaseUnit(bigBaseUnit),
         m_rcContext(NULL),
-        m_offMeshFilePath(offMeshFilePath)
+        m_offMeshFilePath(offMeshFilePath),
+        m_threads(threads ? threads : 1),
+        m_tilesTotal(0),
+        m_tilesDone(0),
+        m_startTime(0)
     {
         m_terrainBuilder = new TerrainBuilder(skipLiquid);
 
@@ -152,8 +175,10 @@ namespace MMAP
         {
             uint32 mapID = (*it).first;
             if (!shouldSkipMap(mapID))
-                { buildMap(mapID); }
+                { queueMapTiles(mapID); }
         }
+
+        buildQueuedTiles();
     }
 
     /**************************************************************************/
@@ -216,6 +241,13 @@ namespace MMAP
 
     /**************************************************************************/
     void MapBuilder::buildMap(uint32 mapID)
+    {
+        queueMapTiles(mapID);
+        buildQueuedTiles();
+    }
+
+    /**************************************************************************/
+    void MapBuilder::queueMapTiles(uint32 mapID)
     {
         printf("Building map %03u:\n", mapID);
 
@@ -246,24 +278,79 @@ namespace MMAP
             return;
         }
 
-        // now start building mmtiles for each tile
+        m_navMeshes.push_back(navMesh);
+
+        // now queue mmtiles for each tile
         printf("We have %u tiles.                          \n", (unsigned int)tiles->size());
         for (set<uint32>::iterator it = tiles->begin(); it != tiles->end(); ++it)
         {
-            uint32 tileX, tileY;
+            TileJob job;
+            job.mapID = mapID;
+            job.navMesh = navMesh;
 
             // unpack tile coords
-            StaticMapTree::unpackTileID((*it), tileX, tileY);
+            StaticMapTree::unpackTileID((*it), job.tileX, job.tileY);
 
-            if (shouldSkipTile(mapID, tileX, tileY))
+            if (shouldSkipTile(mapID, job.tileX, job.tileY))
                 { continue; }
 
-            buildTile(mapID, tileX, tileY, navMesh);
+            m_tileJobs.add(job);
+            ++m_tilesTotal;
         }
+    }
 
-        dtFreeNavMesh(navMesh);
+    /**************************************************************************/
+    void MapBuilder::buildQueuedTiles()
+    {
+        m_tilesDone = 0;
+        m_startTime = WorldTimer::getMSTime();
+
+        // every tile is written to its own file and does not depend on the other
+        // tiles, so the files are the same whatever thread builds which tile.
+        // The progress lines are printed in the order the tiles finish.
+        if (m_threads > 1 && m_tilesTotal > 1)
+        {
+            printf("Building %u tiles using %u threads\n", m_tilesTotal, m_threads);
 
-        printf("Complete!                               \n\n");
+            vector<ACE_Based::Thread*> threads;
+            for (uint32 i = 0; i < m_threads; ++i)
+                { threads.push_back(new ACE_Based::Thread(new TileBuilderThread(*this))); }
+
+            for (uint32 i = 0; i < threads.size(); ++i)
+            {
+                threads[i]->wait();
+                delete threads[i];
+            }
+        }
+        else
+            { processTileJobs(); }
+
+        for (uint32 i = 0; i < m_navMeshes.size(); ++i)
+            { dtFreeNavMesh(m_navMeshes[i]); }
+        m_navMeshes.clear();
+
+        uint32 elapsed = WorldTimer::getMSTimeDiff(m_startTime, WorldTimer::getMSTime());
+        printf("Complete! Built %u tiles in %u s                \n\n", m_tilesTotal, elapsed / IN_MILLISECONDS);
+
+        m_tilesTotal = 0;
+    }
+
+    /**************************************************************************/
+    void MapBuilder::processTileJobs()
+    {
+        TileJob job;
+        while (m_tileJobs.next(job))
+        {
+            buildTile(job.mapID, job.tileX, job.tileY, job.navMesh);
+
+            ACE_Guard<ACE_Thread_Mutex> guard(m_progressLock);
+            ++m_tilesDone;
+
+            uint32 elapsed = WorldTimer::getMSTimeDiff(m_startTime, WorldTimer::getMSTime());
+            printf("[%u/%u] Map %03u tile [%02u,%02u] done, %.1f tiles/min            \n",
+                   m_tilesDone, m_tilesTotal, job.mapID, job.tileX, job.tileY,
+                   elapsed ? float(m_tilesDone) * MINUTE * IN_MILLISECONDS / elapsed : 0.0f);
+        }
     }
 
     /**************************************************************************/
@@ -703,13 +790,24 @@ namespace MMAP
             }
 
             dtTileRef tileRef = 0;
+            dtStatus dtResult;
             printf("%s Adding tile to navmesh...                \r", tileString);
-            // DT_TILE_FREE_DATA tells detour to unallocate memory when the tile
-            // is removed via removeTile()
-            dtStatus dtResult = navMesh->addTile(navData, navDataSize, DT_TILE_FREE_DATA, 0, &tileRef);
+            {
+                // the navmesh is shared by all threads building tiles of this map, it is
+                // only used to validate the tile so remove it again right away.
+                // addTile writes the tile's links, whose poly refs carry the tile slot
+                // and salt, into navData. Always use slot 0 with salt 1, otherwise the
+                // written file would depend on how many tiles were validated before.
+                ACE_Guard<ACE_Thread_Mutex> guard(m_navMeshLock);
+                dtResult = navMesh->addTile(navData, navDataSize, 0, navMesh->encodePolyId(1, 0, 0), &tileRef);
+                if (tileRef)
+                    { navMesh->removeTile(tileRef, NULL, NULL); }
+            }
+
             if (!tileRef || dtStatusFailed(dtResult))
             {
                 printf("%s Failed adding tile to navmesh!           \n", tileString);
+                dtFree(navData);
                 continue;
             }
 
@@ -722,7 +820,7 @@ namespace MMAP
                 char message[1024];
                 sprintf(message, "Failed to open %s for writing!\n", fileName);
                 perror(message);
-                navMesh->removeTile(tileRef, NULL, NULL);
+                dtFree(navData);
                 continue;
             }
 
@@ -738,8 +836,8 @@ namespace MMAP
             fwrite(navData, sizeof(unsigned char), navDataSize, file);
             fclose(file);
 
-            // now that tile is written to disk, we can unload it
-            navMesh->removeTile(tileRef, NULL, NULL);
+            // now that tile is written to disk, we can free it
+            dtFree(navData);
         }
         while (0);
 
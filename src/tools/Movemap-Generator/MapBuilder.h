@@ -38,6 +38,10 @@
 #include "IVMapManager.h"
 #include "WorldModel.h"
 
+#include "Threading.h"
+#include "LockedQueue.h"
+#include <ace/Thread_Mutex.h>
+
 using namespace std;
 using namespace VMAP;
 // G3D namespace typedefs conflicts with ACE typedefs
@@ -79,12 +83,32 @@ namespace MMAP
         rcPolyMeshDetail* dmesh; /**< TODO */
     };
 
+    /**
+     * @brief a single tile waiting to be built by one of the builder threads
+     *
+     */
+    struct TileJob
+    {
+        uint32 mapID; /**< map the tile belongs to */
+        uint32 tileX; /**< TODO */
+        uint32 tileY; /**< TODO */
+        dtNavMesh* navMesh; /**< navmesh of the map, shared by all tiles of the map */
+    };
+
+    /**
+     * @brief
+     *
+     */
+    typedef ACE_Based::LockedQueue<TileJob, ACE_Thread_Mutex> TileJobQueue;
+
     /**
      * @brief
      *
      */
     class MapBuilder
     {
+        friend class TileBuilderThread;
+
         public:
             /**
              * @brief
@@ -97,6 +121,7 @@ namespace MMAP
              * @param debugOutput
              * @param bigBaseUnit
              * @param offMeshFilePath
+             * @param threads number of threads building tiles in parallel
              */
             MapBuilder(float maxWalkableAngle   = 60.f,
                        bool skipLiquid          = false,
@@ -105,7 +130,8 @@ namespace MMAP
                        bool skipBattlegrounds   = false,
                        bool debugOutput         = false,
                        bool bigBaseUnit         = false,
-                       const char* offMeshFilePath = NULL);
+                       const char* offMeshFilePath = NULL,
+                       uint32 threads           = 1);
 
             /**
              * @brief
@@ -149,6 +175,23 @@ namespace MMAP
              */
             set<uint32>* getTileList(uint32 mapID);
 
+            /**
+             * @brief creates the navmesh of a map and queues all of its tiles for building
+             *
+             * @param mapID
+             */
+            void queueMapTiles(uint32 mapID);
+            /**
+             * @brief builds all queued tiles, using m_threads threads, and frees the navmeshes
+             *
+             */
+            void buildQueuedTiles();
+            /**
+             * @brief builds queued tiles until the queue is empty, run by every builder thread
+             *
+             */
+            void processTileJobs();
+
             /**
              * @brief
              *
@@ -247,7 +290,16 @@ namespace MMAP
             float m_maxWalkableAngle; /**< TODO */
             bool m_bigBaseUnit; /**< TODO */
 
-            rcContext* m_rcContext; /**< build performance - not really used for now */
+            rcContext* m_rcContext; /**< build performance - not really used for now, shared by all threads as logging and timers are disabled */
+
+            uint32 m_threads; /**< number of threads building tiles */
+            TileJobQueue m_tileJobs; /**< tiles waiting to be built */
+            vector<dtNavMesh*> m_navMeshes; /**< navmeshes of the maps having queued tiles */
+            ACE_Thread_Mutex m_navMeshLock; /**< guards adding and removing tiles to the shared navmeshes */
+            ACE_Thread_Mutex m_progressLock; /**< guards the progress counters and output */
+            uint32 m_tilesTotal; /**< number of queued tiles */
+            uint32 m_tilesDone; /**< number of tiles built so far */
+            uint32 m_startTime; /**< time the queued tiles started building */
     };
 }
 
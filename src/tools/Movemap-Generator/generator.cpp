@@ -80,6 +80,7 @@ void printUsage(char* prg)
     printf("                                     connections data\n");
     printf("   --debugOutput [true|false]        create debugging files for use with\n");
     printf("                                     RecastDemo.\n");
+    printf("   --threads [#]                     number of threads building tiles.\n");
     printf("   --silent                          No questions asked.\n");
     printf("   [#]                               Build only the map specified by #.\n");
     printf("\n");
@@ -104,7 +105,8 @@ bool handleArgs(int argc, char** argv,
                 bool& debugOutput,
                 bool& silent,
                 bool& bigBaseUnit,
-                char*& offMeshInputPath)
+                char*& offMeshInputPath,
+                int& threads)
 {
     char* param = NULL;
     for (int i = 1; i < argc; ++i)
@@ -233,6 +235,18 @@ bool handleArgs(int argc, char** argv,
 
             offMeshInputPath = param;
         }
+        else if (strcmp(argv[i], "--threads") == 0)
+        {
+            param = argv[++i];
+            if (!param)
+                { return false; }
+
+            int numThreads = atoi(param);
+            if (numThreads > 0)
+                { threads = numThreads; }
+            else
+                { printf("invalid option for '--threads', using default 1\n"); }
+        }
         else if (strcmp(argv[i], "-h") == 0 || strcmp(argv[i], "--help") == 0)
         {
             printUsage(argv[0]);
@@ -276,11 +290,12 @@ int main(int argc, char** argv)
          silent = false,
          bigBaseUnit = false;
     char* offMeshInputPath = NULL;
+    int threads = 1;
 
     bool validParam = handleArgs(argc, argv, mapnum,
                                  tileX, tileY, maxAngle,
                                  skipLiquid, skipContinents, skipJunkMaps, skipBattlegrounds,
-                                 debugOutput, silent, bigBaseUnit, offMeshInputPath);
+                                 debugOutput, silent, bigBaseUnit, offMeshInputPath, threads);
 
     if (!validParam)
         { return silent ? -1 : finish("You have specified invalid parameters (use -? for more help)", -1); }
@@ -301,7 +316,7 @@ int main(int argc, char** argv)
         { return silent ? -3 : finish("Press any key to close...", -3); }
 
     MapBuilder builder(maxAngle, skipLiquid, skipContinents, skipJunkMaps,
-                       skipBattlegrounds, debugOutput, bigBaseUnit, offMeshInputPath);
+                       skipBattlegrounds, debugOutput, bigBaseUnit, offMeshInputPath, uint32(threads));
 
     if (tileX > -1 && tileY > -1 && mapnum >= 0)
         { builder.buildSingleTile(mapnum, tileX, tileY); }
@@ -40,6 +40,11 @@
 #include "loadlib/wdt.h"
 #include <fcntl.h>
 
+#include <ace/TSS_T.h>
+#include <ace/Thread_Manager.h>
+#include <ace/Thread_Mutex.h>
+#include <ace/Guard_T.h>
+
 #ifndef WIN32
 #include <unistd.h>
 /* This isn't the nicest way to do things..
@@ -63,7 +68,6 @@
 #else
 #define OPEN_FLAGS (O_RDONLY | O_BINARY)
 #endif
-extern ArchiveSet gOpenArchives;    /**< TODO */
 
 /**
  * @brief
@@ -81,6 +85,7 @@ uint16* LiqType;                    /**< TODO */
 char output_path[128] = ".";        /**< TODO */
 char input_path[128] = ".";         /**< TODO */
 uint32 maxAreaId = 0;               /**< TODO */
+uint32 threads = 1;                 /**< Number of threads converting map tiles */
 
 /**
  * @brief Data types which can be extracted
@@ -158,6 +163,8 @@ void Usage(char* prg)
     printf("                         size, but also accuracy\n");
     printf("   -e, --extract #       extract specified client data. 1 = maps, 2 = DBCs,\n");
     printf("                         3 = both. Defaults to extracting both.\n");
+    printf("   -t, --threads #       number of threads converting map tiles, each with\n");
+    printf("                         its own archive handles. Defaults to 1.\n");
     printf("\n");
     printf("Example:\n");
     printf("- use input path and do not flatten maps:\n");
@@ -230,6 +237,24 @@ bool HandleArgs(int argc, char** argv)
                 Usage(argv[0]);
             }
         }
+        else if (strcmp(argv[i], "-t") == 0 || strcmp(argv[i], "--threads") == 0)
+        {
+            param = argv[++i];
+            if (!param)
+            {
+                return false;
+            }
+
+            int threadCount = atoi(param);
+            if (threadCount > 0)
+            {
+                threads = threadCount;
+            }
+            else
+            {
+                Usage(argv[0]);
+            }
+        }
         else if (strcmp(argv[i], "-h") == 0 || strcmp(argv[i], "--help") == 0)
         {
             Usage(argv[0]);
@@ -429,19 +454,29 @@ float selectUInt16StepStore(float maxDiff)
     return 65535 / maxDiff;
 }
 
-uint16 area_flags[ADT_CELLS_PER_GRID][ADT_CELLS_PER_GRID];      /**< Temporary grid data store */
-
-float V8[ADT_GRID_SIZE][ADT_GRID_SIZE];                         /**< TODO */
-float V9[ADT_GRID_SIZE + 1][ADT_GRID_SIZE + 1];                 /**< TODO */
-uint16 uint16_V8[ADT_GRID_SIZE][ADT_GRID_SIZE];                 /**< TODO */
-uint16 uint16_V9[ADT_GRID_SIZE + 1][ADT_GRID_SIZE + 1];         /**< TODO */
-uint8  uint8_V8[ADT_GRID_SIZE][ADT_GRID_SIZE];                  /**< TODO */
-uint8  uint8_V9[ADT_GRID_SIZE + 1][ADT_GRID_SIZE + 1];          /**< TODO */
+/**
+ * @brief Temporary grid data store, one per converting thread
+ *
+ */
+struct ADTConvertData
+{
+    uint16 area_flags[ADT_CELLS_PER_GRID][ADT_CELLS_PER_GRID];      /**< TODO */
+
+    float V8[ADT_GRID_SIZE][ADT_GRID_SIZE];                         /**< TODO */
+    float V9[ADT_GRID_SIZE + 1][ADT_GRID_SIZE + 1];                 /**< TODO */
+    uint16 uint16_V8[ADT_GRID_SIZE][ADT_GRID_SIZE];                 /**< TODO */
+    uint16 uint16_V9[ADT_GRID_SIZE + 1][ADT_GRID_SIZE + 1];         /**< TODO */
+    uint8  uint8_V8[ADT_GRID_SIZE][ADT_GRID_SIZE];                  /**< TODO */
+    uint8  uint8_V9[ADT_GRID_SIZE + 1][ADT_GRID_SIZE + 1];          /**< TODO */
+
+    uint16 liquid_entry[ADT_CELLS_PER_GRID][ADT_CELLS_PER_GRID];    /**< TODO */
+    uint8 liquid_flags[ADT_CELLS_PER_GRID][ADT_CELLS_PER_GRID];     /**< TODO */
+    bool  liquid_show[ADT_GRID_SIZE][ADT_GRID_SIZE];                /**< TODO */
+    float liquid_height[ADT_GRID_SIZE + 1][ADT_GRID_SIZE + 1];      /**< TODO */
+};
 
-uint16 liquid_entry[ADT_CELLS_PER_GRID][ADT_CELLS_PER_GRID];    /**< TODO */
-uint8 liquid_flags[ADT_CELLS_PER_GRID][ADT_CELLS_PER_GRID];     /**< TODO */
-bool  liquid_show[ADT_GRID_SIZE][ADT_GRID_SIZE];                /**< TODO */
-float liquid_height[ADT_GRID_SIZE + 1][ADT_GRID_SIZE + 1];      /**< TODO */
+typedef ACE_TSS<ADTConvertData> ADTConvertDataTSS;
+static ADTConvertDataTSS convertData;                               /**< TODO */
 
 /**
  * @brief
@@ -454,6 +489,19 @@ float liquid_height[ADT_GRID_SIZE + 1][ADT_GRID_SIZE + 1];      /**< TODO */
  */
 bool ConvertADT(char* filename, char* filename2, int cell_y, int cell_x)
 {
+    ADTConvertData& data = *convertData;
+    uint16 (&area_flags)[ADT_CELLS_PER_GRID][ADT_CELLS_PER_GRID] = data.area_flags;
+    float (&V8)[ADT_GRID_SIZE][ADT_GRID_SIZE] = data.V8;
+    float (&V9)[ADT_GRID_SIZE + 1][ADT_GRID_SIZE + 1] = data.V9;
+    uint16 (&uint16_V8)[ADT_GRID_SIZE][ADT_GRID_SIZE] = data.uint16_V8;
+    uint16 (&uint16_V9)[ADT_GRID_SIZE + 1][ADT_GRID_SIZE + 1] = data.uint16_V9;
+    uint8 (&uint8_V8)[ADT_GRID_SIZE][ADT_GRID_SIZE] = data.uint8_V8;
+    uint8 (&uint8_V9)[ADT_GRID_SIZE + 1][ADT_GRID_SIZE + 1] = data.uint8_V9;
+    uint16 (&liquid_entry)[ADT_CELLS_PER_GRID][ADT_CELLS_PER_GRID] = data.liquid_entry;
+    uint8 (&liquid_flags)[ADT_CELLS_PER_GRID][ADT_CELLS_PER_GRID] = data.liquid_flags;
+    bool (&liquid_show)[ADT_GRID_SIZE][ADT_GRID_SIZE] = data.liquid_show;
+    float (&liquid_height)[ADT_GRID_SIZE + 1][ADT_GRID_SIZE + 1] = data.liquid_height;
+
     ADT_file adt;
 
     if (!adt.loadFile(filename))
@@ -994,13 +1042,75 @@ bool ConvertADT(char* filename, char* filename2, int cell_y, int cell_x)
 }
 
 /**
- * @brief
+ * @brief A map tile waiting to be converted
  *
  */
-void ExtractMapsFromMpq()
+struct ADTJob
 {
+    uint32 map;                     /**< index into map_ids */
+    uint32 x;                       /**< TODO */
+    uint32 y;                       /**< TODO */
+};
+
+std::vector<ADTJob> adtJobs;        /**< TODO */
+size_t nextAdtJob = 0;              /**< TODO */
+size_t doneAdtJobs = 0;             /**< TODO */
+ACE_Thread_Mutex adtJobLock;        /**< guards the job counters */
+
+void LoadCommonMPQFiles(ArchiveSet& archives);
+void CloseMPQFiles(ArchiveSet& archives);
+
+/**
+ * @brief Converts queued map tiles until none are left
+ *
+ * Worker threads open their own set of archives first, libmpq reads through
+ * a single file handle per archive which can not be shared between threads.
+ *
+ * @param arg non zero if called from a worker thread
+ * @return ACE_THR_FUNC_RETURN
+ */
+ACE_THR_FUNC_RETURN ConvertADTJobs(void* arg)
+{
+    bool ownArchives = arg != NULL;
+    if (ownArchives)
+        { LoadCommonMPQFiles(GetThreadArchives()); }
+
     char mpq_filename[1024];
     char output_filename[1024];
+
+    while (true)
+    {
+        ADTJob job;
+        {
+            ACE_Guard<ACE_Thread_Mutex> guard(adtJobLock);
+            if (nextAdtJob >= adtJobs.size())
+                { break; }
+            job = adtJobs[nextAdtJob++];
+        }
+
+        map_id const& mapEntry = map_ids[job.map];
+        sprintf(mpq_filename, "World\\Maps\\%s\\%s_%u_%u.adt", mapEntry.name, mapEntry.name, job.x, job.y);
+        sprintf(output_filename, "%s/maps/%03u%02u%02u.map", output_path, mapEntry.id, job.y, job.x);
+        ConvertADT(mpq_filename, output_filename, job.y, job.x);
+
+        // draw progress bar
+        ACE_Guard<ACE_Thread_Mutex> guard(adtJobLock);
+        ++doneAdtJobs;
+        printf("Processing........................%u%%\r", uint32((100 * doneAdtJobs) / adtJobs.size()));
+    }
+
+    if (ownArchives)
+        { CloseMPQFiles(GetThreadArchives()); }
+
+    return 0;
+}
+
+/**
+ * @brief
+ *
+ */
+void ExtractMapsFromMpq()
+{
     char mpq_map_name[1024];
 
     printf("Extracting maps...\n");
@@ -1014,10 +1124,9 @@ void ExtractMapsFromMpq()
     path += "/maps/";
     CreateDir(path);
 
-    printf("Converting map files\n");
+    printf("Collecting map tiles\n");
     for (uint32 z = 0; z < map_count; ++z)
     {
-        printf("Extract %s (%d/%d)                  \n", map_ids[z].name, z + 1, map_count);
         // Loadup map grid data
         sprintf(mpq_map_name, "World\\Maps\\%s\\%s.wdt", map_ids[z].name, map_ids[z].name);
         WDT_file wdt;
@@ -1027,20 +1136,36 @@ void ExtractMapsFromMpq()
             continue;
         }
 
+        uint32 tiles = 0;
         for (uint32 y = 0; y < WDT_MAP_SIZE; ++y)
         {
             for (uint32 x = 0; x < WDT_MAP_SIZE; ++x)
             {
                 if (!wdt.main->adt_list[y][x].exist)
                     { continue; }
-                sprintf(mpq_filename, "World\\Maps\\%s\\%s_%u_%u.adt", map_ids[z].name, map_ids[z].name, x, y);
-                sprintf(output_filename, "%s/maps/%03u%02u%02u.map", output_path, map_ids[z].id, y, x);
-                ConvertADT(mpq_filename, output_filename, y, x);
+                ADTJob job;
+                job.map = z;
+                job.x = x;
+                job.y = y;
+                adtJobs.push_back(job);
+                ++tiles;
             }
-            // draw progress bar
-            printf("Processing........................%d%%\r", (100 * (y + 1)) / WDT_MAP_SIZE);
         }
+        printf("Extract %s (%d/%d), %u tiles\n", map_ids[z].name, z + 1, map_count, tiles);
     }
+
+    printf("Converting %u map files using %u thread(s)\n", uint32(adtJobs.size()), threads);
+    int groupId = -1;
+    if (threads > 1)
+        { groupId = ACE_Thread_Manager::instance()->spawn_n(threads, ConvertADTJobs, &adtJobs); }
+
+    if (groupId == -1)
+        { ConvertADTJobs(NULL); }
+    else
+        { ACE_Thread_Manager::instance()->wait_grp(groupId); }
+    printf("\n");
+
+    adtJobs.clear();
     delete [] areas;
     delete [] map_ids;
 }
@@ -1108,8 +1233,9 @@ void ExtractDBCFiles()
 /**
  * @brief
  *
+ * @param archives set the opened archives are added to
  */
-void LoadCommonMPQFiles()
+void LoadCommonMPQFiles(ArchiveSet& archives)
 {
     char filename[512];
     int count = sizeof(CONF_mpq_list) / sizeof(char*);
@@ -1117,18 +1243,19 @@ void LoadCommonMPQFiles()
     {
         sprintf_s(filename, "%s/Data/%s", input_path, CONF_mpq_list[i]);
         if (FileExists(filename))
-            { new MPQArchive(filename); }
+            { new MPQArchive(filename, archives); }
     }
 }
 
 /**
  * @brief
  *
+ * @param archives
  */
-inline void CloseMPQFiles()
+void CloseMPQFiles(ArchiveSet& archives)
 {
-    for (ArchiveSet::iterator j = gOpenArchives.begin(); j != gOpenArchives.end(); ++j) { (*j)->close(); }
-    gOpenArchives.clear();
+    for (ArchiveSet::iterator j = archives.begin(); j != archives.end(); ++j) { (*j)->close(); }
+    archives.clear();
 }
 
 /**
@@ -1148,7 +1275,7 @@ int main(int argc, char** argv)
     }
 
     // Open MPQs
-    LoadCommonMPQFiles();
+    LoadCommonMPQFiles(gOpenArchives);
 
     // Extract dbc
     if (CONF_extract & EXTRACT_DBC)
@@ -1159,7 +1286,7 @@ int main(int argc, char** argv)
         { ExtractMapsFromMpq(); }
 
     // Close MPQs
-    CloseMPQFiles();
+    CloseMPQFiles(gOpenArchives);
 
     return 0;
 }
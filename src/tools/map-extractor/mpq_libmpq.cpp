@@ -27,9 +27,19 @@
 #include <cstdio>
 #include "libmpq/mpq.h"
 
+#include <ace/TSS_T.h>
+
 ArchiveSet gOpenArchives;
 
-MPQArchive::MPQArchive(const char* filename)
+typedef ACE_TSS<ArchiveSet> ArchiveSetTSS;
+static ArchiveSetTSS sThreadArchives;
+
+ArchiveSet& GetThreadArchives()
+{
+    return *sThreadArchives;
+}
+
+MPQArchive::MPQArchive(const char* filename, ArchiveSet& archives)
 {
     int result = libmpq__archive_open(&mpq_a, filename, -1);
     printf("Opening %s\n", filename);
@@ -58,7 +68,7 @@ MPQArchive::MPQArchive(const char* filename)
         }
         return;
     }
-    gOpenArchives.push_front(this);
+    archives.push_front(this);
 }
 
 void MPQArchive::close()
@@ -73,7 +83,8 @@ MPQFile::MPQFile(const char* filename):
     pointer(0),
     size(0)
 {
-    for (ArchiveSet::iterator i = gOpenArchives.begin(); i != gOpenArchives.end(); ++i)
+    ArchiveSet& archives = sThreadArchives->empty() ? gOpenArchives : *sThreadArchives;
+    for (ArchiveSet::iterator i = archives.begin(); i != archives.end(); ++i)
     {
         mpq_archive* mpq_a = (*i)->mpq_a;
 
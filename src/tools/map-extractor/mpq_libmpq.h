@@ -35,6 +35,26 @@
 
 using namespace std;
 
+class MPQArchive;
+
+/**
+ * @brief
+ *
+ */
+typedef std::deque<MPQArchive*> ArchiveSet;
+
+extern ArchiveSet gOpenArchives; /**< archives opened by the main thread */
+
+/**
+ * @brief returns the archive set owned by the calling thread
+ *
+ * Worker threads open their own archives into this set, so no libmpq handle
+ * is shared between threads. It stays empty for the main thread.
+ *
+ * @return ArchiveSet
+ */
+ArchiveSet& GetThreadArchives();
+
 /**
  * @brief
  *
@@ -49,8 +69,9 @@ class MPQArchive
          * @brief
          *
          * @param filename
+         * @param archives set the opened archive is added to
          */
-        MPQArchive(const char* filename);
+        MPQArchive(const char* filename, ArchiveSet& archives = gOpenArchives);
         /**
          * @brief
          *
@@ -91,11 +112,6 @@ class MPQArchive
             delete[] buffer;
         }
 };
-/**
- * @brief
- *
- */
-typedef std::deque<MPQArchive*> ArchiveSet;
 
 /**
  * @brief
@@ -123,7 +139,8 @@ class MPQFile
 
     public:
         /**
-         * @brief
+         * @brief reads the file from the archives of the calling thread, or
+         * from the main thread's archives if it has none of its own
          *
          * @param filename filenames are not case sensitive
          */
@@ -24,6 +24,9 @@
 
 #include <string>
 #include <iostream>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
 
 #include "TileAssembler.h"
 
@@ -32,30 +35,53 @@ const char* szVMAPMagic = "VMAP_4.0";
 //=======================================================
 void Usage(char* prg)
 {
-    printf("Usage: %s [OPTION]\n\n", prg);
+    printf("Usage: %s [OPTION] <input_dir> <output_dir>\n\n", prg);
     printf("Assemble vmaps from extracted client model information.\n");
+    printf("  --threads [#]  number of threads used to convert models and maps (default 1)\n");
+    printf("\n");
+    printf("Models and maps unchanged since the last run into <output_dir> are skipped.\n");
     printf("\n");
     printf("Example:\n");
     printf("- provide source and target path:\n");
     printf("  %s Buildings vmaps\n", prg);
+    printf("- use four threads:\n");
+    printf("  %s --threads 4 Buildings vmaps\n", prg);
 }
 
 int main(int argc, char** argv)
 {
     printf("mangos-zero vmap (version %s) assembler\n\n", szVMAPMagic);
 
-    if (argc != 3)
+    uint32 threads = 1;
+    std::vector<std::string> paths;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (strcmp(argv[i], "--threads") == 0)
+        {
+            if (i + 1 >= argc || atoi(argv[i + 1]) <= 0)
+            {
+                Usage(argv[0]);
+                return 1;
+            }
+            threads = uint32(atoi(argv[++i]));
+        }
+        else
+            { paths.push_back(argv[i]); }
+    }
+
+    if (paths.size() != 2)
     {
         Usage(argv[0]);
         return 1;
     }
 
-    std::string src = argv[1];
-    std::string dest = argv[2];
+    std::string src = paths[0];
+    std::string dest = paths[1];
 
     std::cout << "using " << src << " as source directory and writing output to " << dest << std::endl;
+    printf("using %u thread(s)\n", threads);
 
-    VMAP::TileAssembler* ta = new VMAP::TileAssembler(src, dest);
+    VMAP::TileAssembler* ta = new VMAP::TileAssembler(src, dest, threads);
 
     if (!ta->convertWorld2())
     {